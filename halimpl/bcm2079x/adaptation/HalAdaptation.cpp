@@ -30,6 +30,8 @@
 #include "config.h"
 #include "nfc_hal_int.h"
 #include "nfc_hal_post_reset.h"
+#include "nfc_capture.h"
+#include "nfc_latency.h"
 #include <errno.h>
 #include <pthread.h>
 
@@ -74,6 +76,10 @@ int HaiInitializeLibrary (const bcm2079x_dev_t* device)
     if ( GetNumValue ( NAME_PROTOCOL_TRACE_LEVEL, &num, sizeof ( num ) ) )
         ScrProtocolTraceFlag = num;
 
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    nfc_cap_open_config (".hal");
+#endif
+
     HAL_NfcInitialize ();
 
     // Initialize appliation logging level
@@ -96,6 +102,12 @@ int HaiTerminateLibrary ()
     gAndroidHalCallback = NULL;
     gAndroidHalDataCallback = NULL;
     GKI_shutdown ();
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    nfc_cap_close ();
+#endif
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    nfc_lat_dump ();
+#endif
     retval = 0;
     ALOGD ("%s: exit %d", __FUNCTION__, retval);
     return retval;
@@ -27,6 +27,8 @@ extern "C"
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
 #include <string>
 
 
@@ -147,3 +149,82 @@ void nfc_hal_nv_co_write (const UINT8 *p_buf, UINT16 nbytes, UINT8 block)
         nfc_hal_nv_ci_write (NFC_HAL_NV_CO_FAIL);
     }
 }
+
+
+/*******************************************************************************
+**
+** Function         nfc_hal_nv_co_read_patch_info
+**
+** Description      Read the patch information saved by
+**                  nfc_hal_nv_co_write_patch_info. Unlike nfc_hal_nv_co_read,
+**                  this completes before returning.
+**
+** Parameters       p_info  - buffer to read the patch information into.
+**
+** Returns          TRUE if valid patch information was read
+**
+*******************************************************************************/
+BOOLEAN nfc_hal_nv_co_read_patch_info (tNFC_HAL_NV_PATCH_INFO *p_info)
+{
+    char filename[256];
+    BOOLEAN valid = FALSE;
+
+    snprintf (filename, sizeof (filename), "%s%s%u", bcm_nfc_location, filename_prefix, PATCH_NV_BLOCK);
+
+    int fileStream = open (filename, O_RDONLY);
+    if (fileStream >= 0)
+    {
+        ssize_t actualRead = read (fileStream, p_info, sizeof (tNFC_HAL_NV_PATCH_INFO));
+        valid = (  (actualRead == sizeof (tNFC_HAL_NV_PATCH_INFO))
+                 &&(p_info->magic == NFC_HAL_NV_PATCH_INFO_MAGIC)
+                 &&(p_info->version_len <= NFC_HAL_NV_PATCH_VERSION_LEN)  );
+        close (fileStream);
+    }
+    ALOGD ("%s: file=%s; valid=%u", __FUNCTION__, filename, valid);
+    return valid;
+}
+
+
+/*******************************************************************************
+**
+** Function         nfc_hal_nv_co_write_patch_info
+**
+** Description      Save the patch information, or erase it if p_info is NULL.
+**                  Unlike nfc_hal_nv_co_write, this completes before returning.
+**
+** Parameters       p_info  - patch information to save.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_hal_nv_co_write_patch_info (const tNFC_HAL_NV_PATCH_INFO *p_info)
+{
+    char filename[256];
+    char tmpname[260];
+
+    snprintf (filename, sizeof (filename), "%s%s%u", bcm_nfc_location, filename_prefix, PATCH_NV_BLOCK);
+
+    if (p_info == NULL)
+    {
+        ALOGD ("%s: erase file=%s", __FUNCTION__, filename);
+        unlink (filename);
+        return;
+    }
+
+    // write a new file and rename it, so a reader never sees half of the information
+    snprintf (tmpname, sizeof (tmpname), "%s.tmp", filename);
+    int fileStream = open (tmpname, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fileStream >= 0)
+    {
+        ssize_t actualWritten = write (fileStream, p_info, sizeof (tNFC_HAL_NV_PATCH_INFO));
+        fsync (fileStream);
+        close (fileStream);
+        if ((actualWritten == sizeof (tNFC_HAL_NV_PATCH_INFO)) && (rename (tmpname, filename) == 0))
+        {
+            ALOGD ("%s: file=%s", __FUNCTION__, filename);
+            return;
+        }
+        unlink (tmpname);
+    }
+    ALOGE ("%s: fail to write %s, error = %d", __FUNCTION__, filename, errno);
+}
@@ -20,6 +20,7 @@ extern "C"
 {
     #include "nfc_hal_target.h"
 }
+#include "nfc_capture.h"
 #include <cutils/log.h>
 
 
@@ -43,7 +44,7 @@ extern "C"
 
 void LogMsg (UINT32 trace_set_mask, const char *fmt_str, ...)
 {
-    static char buffer [BTE_LOG_BUF_SIZE];
+    char buffer [BTE_LOG_BUF_SIZE];
     va_list ap;
     UINT32 trace_type = trace_set_mask & 0x07; //lower 3 bits contain trace type
     int android_log_type = ANDROID_LOG_INFO;
@@ -59,6 +60,13 @@ void LogMsg (UINT32 trace_set_mask, const char *fmt_str, ...)
 
 void DispNci (UINT8 *data, UINT16 len, BOOLEAN is_recv)
 {
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    /* connection id of data packets (MT=0) */
+    if ((nfc_cap_active) && (len > 0))
+        nfc_cap_write (NFC_CAP_PROTO_NCI, (UINT8) (is_recv ? NFC_CAP_FLAG_RX : 0),
+                       (UINT8) ((data[0] & 0xE0) ? 0 : (data[0] & 0x0F)), data, len);
+#endif
+
     if (!(ScrProtocolTraceFlag & SCR_PROTO_TRACE_NCI))
         return;
 
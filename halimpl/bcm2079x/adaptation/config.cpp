@@ -18,6 +18,11 @@
 #include "OverrideLog.h"
 #include "config.h"
 #include <stdio.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <string>
 #include <vector>
 #include <list>
@@ -37,6 +42,41 @@ const char transport_config_path[] = "/etc/";
 #define extra_config_ext        ".conf"
 #define     IsStringValue       0x80000000
 
+// precompiled settings of the config files read, rebuilt when one changes
+const char config_snapshot_path[] = "/data/nfc/libnfc-brcm.snapshot";
+
+#define SNAPSHOT_MAGIC          0x4E534346  // "FCSN"
+#define SNAPSHOT_VERSION        1
+
+// snapshot file: header followed by the settings of each config file
+struct tSnapshotHdr
+{
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    num_files;
+    uint32_t    length;             // of the whole snapshot
+};
+
+// config file in the snapshot: followed by its path and num_params settings
+struct tSnapshotFile
+{
+    uint32_t    length;             // of this header, path and settings
+    uint16_t    path_len;
+    uint16_t    num_params;
+    int64_t     mtime;
+    int64_t     size;
+};
+
+// setting in the snapshot: followed by its name and string value
+struct tSnapshotParam
+{
+    uint8_t     name_len;
+    uint8_t     reserved;
+    uint16_t    str_len;
+    uint32_t    reserved2;
+    uint64_t    num_value;
+};
+
 using namespace::std;
 
 class CNfcParam : public string
@@ -54,6 +94,15 @@ private:
     unsigned long   m_numValue;
 };
 
+// settings read from one config file
+struct CNfcConfigFile
+{
+    string                      path;
+    int64_t                     mtime;
+    int64_t                     size;
+    vector<const CNfcParam*>    params;
+};
+
 class CNfcConfig : public vector<const CNfcParam*>
 {
 public:
@@ -72,7 +121,16 @@ private:
     void    moveFromList();
     void    moveToList();
     void    add(const CNfcParam* pParam);
+    void    buildIndex();
+    void    mapSnapshot();
+    const uint8_t* findSnapshot(const char* name, const struct stat& st) const;
+    void    loadSnapshot(const uint8_t* p);
+    void    writeSnapshot() const;
     list<const CNfcParam*> m_list;
+    vector<const CNfcParam*> m_index;   // hash table of the settings
+    list<CNfcConfigFile> m_files;       // config files read, in order
+    const uint8_t* m_snapshot;
+    size_t  m_snapshotLen;
     bool    mValidFile;
 
     unsigned long   state;
@@ -144,6 +202,27 @@ inline int getDigitValue(char c, int base)
     return 0;
 }
 
+/*******************************************************************************
+**
+** Function:    hashName()
+**
+** Description: hash a setting name (FNV-1a)
+**
+** Returns:     hash value
+**
+*******************************************************************************/
+inline uint32_t hashName(const char* name)
+{
+    uint32_t hash = 2166136261U;
+
+    while (*name)
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
 /*******************************************************************************
 **
 ** Function:    CNfcConfig::readConfig()
@@ -167,6 +246,9 @@ bool CNfcConfig::readConfig(const char* name, bool bResetContent)
     };
 
     FILE*   fd = NULL;
+    struct stat st;
+    const uint8_t* pSnapshot = NULL;
+    string  buf;
     string  token;
     string  strValue;
     unsigned long    numValue = 0;
@@ -198,8 +280,34 @@ bool CNfcConfig::readConfig(const char* name, bool bResetContent)
             moveToList();
     }
 
-    while (!feof(fd) && fread(&c, 1, 1, fd) == 1)
+    m_files.push_back(CNfcConfigFile());
+    m_files.back().path.assign(name);
+    if (fstat(fileno(fd), &st) == 0)
+    {
+        m_files.back().mtime = st.st_mtime;
+        m_files.back().size = st.st_size;
+        mapSnapshot();
+        pSnapshot = findSnapshot(name, st);
+    }
+    else
+        st.st_size = 0;
+
+    if (pSnapshot)
+    {
+        ALOGD("%s Using snapshot of %s\n", __func__, name);
+        loadSnapshot(pSnapshot);
+        fclose(fd);
+        moveFromList();
+        return size() > 0;
+    }
+
+    /* read the whole file and parse it */
+    buf.resize(st.st_size);
+    buf.resize(buf.empty() ? 0 : fread(&buf[0], 1, buf.size(), fd));
+
+    for (string::const_iterator itBuf = buf.begin(); itBuf != buf.end(); ++itBuf)
     {
+        c = *itBuf;
         switch (state & 0xff)
         {
         case BEGIN_LINE:
@@ -339,6 +447,7 @@ bool CNfcConfig::readConfig(const char* name, bool bResetContent)
     fclose(fd);
 
     moveFromList();
+    writeSnapshot();
     return size() > 0;
 }
 
@@ -352,6 +461,8 @@ bool CNfcConfig::readConfig(const char* name, bool bResetContent)
 **
 *******************************************************************************/
 CNfcConfig::CNfcConfig() :
+    m_snapshot(NULL),
+    m_snapshotLen(0),
     mValidFile(true)
 {
 }
@@ -367,6 +478,8 @@ CNfcConfig::CNfcConfig() :
 *******************************************************************************/
 CNfcConfig::~CNfcConfig()
 {
+    if (m_snapshot && m_snapshot != MAP_FAILED)
+        munmap((void*)m_snapshot, m_snapshotLen);
 }
 
 /*******************************************************************************
@@ -487,23 +600,14 @@ bool CNfcConfig::getValue(const char* name, unsigned short& rValue) const
 *******************************************************************************/
 const CNfcParam* CNfcConfig::find(const char* p_name) const
 {
-    if (size() == 0)
+    if (m_index.empty())
         return NULL;
 
-    for (const_iterator it = begin(), itEnd = end(); it != itEnd; ++it)
+    size_t mask = m_index.size() - 1;
+    for (size_t i = hashName(p_name) & mask; m_index[i] != NULL; i = (i + 1) & mask)
     {
-        if (**it < p_name)
-            continue;
-        else if (**it == p_name)
-        {
-            if((*it)->str_len() > 0)
-                ALOGD("%s found %s=%s\n", __func__, p_name, (*it)->str_value());
-            else
-                ALOGD("%s found %s=(0x%lX)\n", __func__, p_name, (*it)->numValue());
-            return *it;
-        }
-        else
-            break;
+        if (*m_index[i] == p_name)
+            return m_index[i];
     }
     return NULL;
 }
@@ -525,32 +629,31 @@ void CNfcConfig::clean()
     for (iterator it = begin(), itEnd = end(); it != itEnd; ++it)
         delete *it;
     clear();
+    m_index.clear();
+    m_files.clear();
 }
 
 /*******************************************************************************
 **
 ** Function:    CNfcConfig::Add()
 **
-** Description: add a setting object to the list
+** Description: add a setting object to the list and to the config file
+**              being read
 **
 ** Returns:     none
 **
 *******************************************************************************/
 void CNfcConfig::add(const CNfcParam* pParam)
 {
-    if (m_list.size() == 0)
-    {
-        m_list.push_back(pParam);
-        return;
-    }
-    for (list<const CNfcParam*>::iterator it = m_list.begin(), itEnd = m_list.end(); it != itEnd; ++it)
-    {
-        if (**it < pParam->c_str())
-            continue;
-        m_list.insert(it, pParam);
-        return;
-    }
-    m_list.push_back(pParam);
+    if (pParam->str_len() > 0)
+        ALOGD("%s %s=%s\n", __func__, pParam->c_str(), pParam->str_value());
+    else
+        ALOGD("%s %s=(0x%lX)\n", __func__, pParam->c_str(), pParam->numValue());
+
+    // newer settings go first so they override older ones of the same name
+    m_list.push_front(pParam);
+    if (!m_files.empty())
+        m_files.back().params.push_back(pParam);
 }
 
 /*******************************************************************************
@@ -570,6 +673,7 @@ void CNfcConfig::moveFromList()
     for (list<const CNfcParam*>::iterator it = m_list.begin(), itEnd = m_list.end(); it != itEnd; ++it)
         push_back(*it);
     m_list.clear();
+    buildIndex();
 }
 
 /*******************************************************************************
@@ -591,6 +695,243 @@ void CNfcConfig::moveToList()
     clear();
 }
 
+/*******************************************************************************
+**
+** Function:    CNfcConfig::buildIndex()
+**
+** Description: build the hash table of the setting array; the first setting
+**              of a name in the array is the one found
+**
+** Returns:     none
+**
+*******************************************************************************/
+void CNfcConfig::buildIndex()
+{
+    size_t slots = 16;
+
+    while (slots < size() * 2)
+        slots *= 2;
+    m_index.assign(slots, NULL);
+
+    for (const_iterator it = begin(), itEnd = end(); it != itEnd; ++it)
+    {
+        size_t i = hashName((*it)->c_str()) & (slots - 1);
+        while (m_index[i] != NULL && *m_index[i] != *(*it))
+            i = (i + 1) & (slots - 1);
+        if (m_index[i] == NULL)
+            m_index[i] = *it;
+    }
+}
+
+/*******************************************************************************
+**
+** Function:    CNfcConfig::mapSnapshot()
+**
+** Description: map the snapshot file into memory, once
+**
+** Returns:     none
+**
+*******************************************************************************/
+void CNfcConfig::mapSnapshot()
+{
+    struct stat st;
+    int fd;
+
+    if (m_snapshot != NULL)
+        return;
+
+    m_snapshot = (const uint8_t*) MAP_FAILED;
+    if ((fd = open(config_snapshot_path, O_RDONLY)) < 0)
+        return;
+
+    if ((fstat(fd, &st) == 0) && (st.st_size >= (off_t) sizeof(tSnapshotHdr)))
+    {
+        m_snapshotLen = st.st_size;
+        m_snapshot = (const uint8_t*) mmap(NULL, m_snapshotLen, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (m_snapshot != MAP_FAILED)
+    {
+        tSnapshotHdr hdr;
+
+        memcpy(&hdr, m_snapshot, sizeof(hdr));
+        if (hdr.magic != SNAPSHOT_MAGIC || hdr.version != SNAPSHOT_VERSION || hdr.length != m_snapshotLen)
+        {
+            ALOGD("%s Ignoring invalid snapshot %s\n", __func__, config_snapshot_path);
+            munmap((void*)m_snapshot, m_snapshotLen);
+            m_snapshot = (const uint8_t*) MAP_FAILED;
+        }
+    }
+}
+
+/*******************************************************************************
+**
+** Function:    CNfcConfig::findSnapshot()
+**
+** Description: find the settings of a config file in the snapshot; they are
+**              used only if the file did not change since the snapshot
+**
+** Returns:     pointer to the tSnapshotFile of the config file, or NULL
+**
+*******************************************************************************/
+const uint8_t* CNfcConfig::findSnapshot(const char* name, const struct stat& st) const
+{
+    tSnapshotHdr hdr;
+    tSnapshotFile file;
+    size_t offset = sizeof(tSnapshotHdr);
+    size_t nameLen = strlen(name);
+
+    if (m_snapshot == NULL || m_snapshot == MAP_FAILED)
+        return NULL;
+
+    memcpy(&hdr, m_snapshot, sizeof(hdr));
+    for (int i = 0; i < hdr.num_files; ++i, offset += file.length)
+    {
+        if (offset + sizeof(tSnapshotFile) > m_snapshotLen)
+            break;
+        memcpy(&file, m_snapshot + offset, sizeof(file));
+        if (file.length < sizeof(tSnapshotFile) + file.path_len || offset + file.length > m_snapshotLen)
+            break;
+
+        if (file.path_len == nameLen && memcmp(m_snapshot + offset + sizeof(tSnapshotFile), name, nameLen) == 0)
+        {
+            if (file.mtime == (int64_t) st.st_mtime && file.size == (int64_t) st.st_size)
+                return m_snapshot + offset;
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function:    CNfcConfig::loadSnapshot()
+**
+** Description: add the settings of a config file from the snapshot
+**
+** Returns:     none
+**
+*******************************************************************************/
+void CNfcConfig::loadSnapshot(const uint8_t* p)
+{
+    tSnapshotFile file;
+    tSnapshotParam param;
+    const uint8_t* pEnd;
+
+    memcpy(&file, p, sizeof(file));
+    pEnd = p + file.length;
+    p += sizeof(tSnapshotFile) + file.path_len;
+
+    for (int i = 0; i < file.num_params && p + sizeof(tSnapshotParam) <= pEnd; ++i)
+    {
+        memcpy(&param, p, sizeof(param));
+        p += sizeof(tSnapshotParam);
+        if (p + param.name_len + param.str_len > pEnd)
+            break;
+
+        string name((const char*) p, param.name_len);
+        p += param.name_len;
+        if (param.str_len > 0)
+            add(new CNfcParam(name.c_str(), string((const char*) p, param.str_len)));
+        else
+            add(new CNfcParam(name.c_str(), (unsigned long) param.num_value));
+        p += param.str_len;
+    }
+}
+
+/*******************************************************************************
+**
+** Function:    CNfcConfig::writeSnapshot()
+**
+** Description: write the settings of the config files read into the snapshot,
+**              keeping the other config files of the current snapshot
+**
+** Returns:     none
+**
+*******************************************************************************/
+void CNfcConfig::writeSnapshot() const
+{
+    string out;
+    tSnapshotHdr hdr;
+    tSnapshotFile file;
+    tSnapshotParam param;
+    char tmpPath[256];
+    int fd;
+
+    memset(&hdr, 0, sizeof(hdr));
+    out.append(sizeof(hdr), '\0');
+
+    for (list<CNfcConfigFile>::const_iterator it = m_files.begin(), itEnd = m_files.end(); it != itEnd; ++it)
+    {
+        size_t start = out.size();
+
+        memset(&file, 0, sizeof(file));
+        file.path_len = it->path.length();
+        file.num_params = it->params.size();
+        file.mtime = it->mtime;
+        file.size = it->size;
+        out.append(sizeof(file), '\0');
+        out.append(it->path);
+
+        for (vector<const CNfcParam*>::const_iterator itParam = it->params.begin(); itParam != it->params.end(); ++itParam)
+        {
+            memset(&param, 0, sizeof(param));
+            param.name_len = (*itParam)->length();
+            param.str_len = (*itParam)->str_len();
+            param.num_value = (*itParam)->numValue();
+            out.append((const char*) &param, sizeof(param));
+            out.append((*itParam)->c_str(), param.name_len);
+            out.append((*itParam)->str_value(), param.str_len);
+        }
+        file.length = out.size() - start;
+        memcpy(&out[start], &file, sizeof(file));
+        ++hdr.num_files;
+    }
+
+    /* keep the config files read by others (e.g. the HAL reads chip specific ones) */
+    if (m_snapshot != NULL && m_snapshot != MAP_FAILED)
+    {
+        tSnapshotHdr oldHdr;
+        size_t offset = sizeof(tSnapshotHdr);
+
+        memcpy(&oldHdr, m_snapshot, sizeof(oldHdr));
+        for (int i = 0; i < oldHdr.num_files && offset + sizeof(tSnapshotFile) <= m_snapshotLen; ++i, offset += file.length)
+        {
+            bool bRead = false;
+
+            memcpy(&file, m_snapshot + offset, sizeof(file));
+            if (file.length < sizeof(tSnapshotFile) + file.path_len || offset + file.length > m_snapshotLen)
+                break;
+
+            string path((const char*) m_snapshot + offset + sizeof(tSnapshotFile), file.path_len);
+            for (list<CNfcConfigFile>::const_iterator it = m_files.begin(), itEnd = m_files.end(); it != itEnd; ++it)
+                bRead = bRead || (it->path == path);
+            if (!bRead)
+            {
+                out.append((const char*) m_snapshot + offset, file.length);
+                ++hdr.num_files;
+            }
+        }
+    }
+
+    hdr.magic = SNAPSHOT_MAGIC;
+    hdr.version = SNAPSHOT_VERSION;
+    hdr.length = out.size();
+    memcpy(&out[0], &hdr, sizeof(hdr));
+
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%d", config_snapshot_path, getpid());
+    if ((fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)) < 0)
+    {
+        ALOGD("%s Cannot write snapshot %s\n", __func__, tmpPath);
+        return;
+    }
+    bool bWritten = (write(fd, out.data(), out.size()) == (ssize_t) out.size());
+    close(fd);
+    if (!bWritten || rename(tmpPath, config_snapshot_path) != 0)
+        unlink(tmpPath);
+}
+
 /*******************************************************************************
 **
 ** Function:    CNfcParam::CNfcParam()
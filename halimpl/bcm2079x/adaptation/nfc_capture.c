@@ -0,0 +1,266 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Binary packet capture into a memory-mapped ring file.
+ *
+ ******************************************************************************/
+#include "OverrideLog.h"
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "nfc_capture.h"
+#include "config.h"
+
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+
+#define LOG_TAG "NfcCapture"
+
+volatile BOOLEAN nfc_cap_active = FALSE;
+
+static pthread_mutex_t      nfc_cap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static tNFC_CAP_FILE_HDR    *nfc_cap_p_hdr = NULL;
+static int                  nfc_cap_fd = -1;
+
+#define NFC_CAP_BASE()      ((UINT8 *) nfc_cap_p_hdr)
+
+/*******************************************************************************
+**
+** Function         nfc_cap_next
+**
+** Description      Get the offset of the record following the one at offset,
+**                  or of the first record if offset is at the end of the ring.
+**
+** Returns          offset of a record
+**
+*******************************************************************************/
+static UINT32 nfc_cap_next (UINT32 offset, BOOLEAN skip)
+{
+    tNFC_CAP_REC_HDR *p_rec;
+
+    if (nfc_cap_p_hdr->file_len - offset >= sizeof (tNFC_CAP_REC_HDR))
+    {
+        p_rec = (tNFC_CAP_REC_HDR *) (NFC_CAP_BASE () + offset);
+        if (p_rec->proto != NFC_CAP_PROTO_WRAP)
+        {
+            if (!skip)
+                return (offset);
+            offset += NFC_CAP_REC_LEN (p_rec->len);
+            return (nfc_cap_next (offset, FALSE));
+        }
+    }
+    return (nfc_cap_p_hdr->hdr_len);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_cap_evict
+**
+** Description      Drop the oldest records which start in [start, end), as
+**                  they are about to be overwritten.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_cap_evict (UINT32 start, UINT32 end)
+{
+    tNFC_CAP_FILE_HDR *p_hdr = nfc_cap_p_hdr;
+
+    while ((p_hdr->count > 0) && (p_hdr->tail >= start) && (p_hdr->tail < end))
+    {
+        p_hdr->tail = nfc_cap_next (p_hdr->tail, TRUE);
+        p_hdr->count--;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         nfc_cap_open
+**
+** Description      Start capturing into p_path, a file of file_len bytes. An
+**                  existing capture is kept as p_path.old.
+**
+** Returns          TRUE if capture started
+**
+*******************************************************************************/
+BOOLEAN nfc_cap_open (const char *p_path, UINT32 file_len)
+{
+    char    old_path[256];
+    void    *p_map;
+    int     fd;
+
+    nfc_cap_close ();
+
+    if (file_len < sizeof (tNFC_CAP_FILE_HDR) + 2 * NFC_CAP_REC_LEN (NFC_CAPTURE_SNAP_LEN))
+        file_len = sizeof (tNFC_CAP_FILE_HDR) + 2 * NFC_CAP_REC_LEN (NFC_CAPTURE_SNAP_LEN);
+    file_len &= ~(NFC_CAP_REC_ALIGN - 1);
+
+    snprintf (old_path, sizeof (old_path), "%s.old", p_path);
+    rename (p_path, old_path);
+
+    if ((fd = open (p_path, O_RDWR | O_CREAT | O_TRUNC, 0660)) < 0)
+    {
+        ALOGE ("%s: unable to open %s, errno=%d", __FUNCTION__, p_path, errno);
+        return (FALSE);
+    }
+
+    if (  (ftruncate (fd, file_len) < 0)
+        ||((p_map = mmap (NULL, file_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)  )
+    {
+        ALOGE ("%s: unable to map %s, errno=%d", __FUNCTION__, p_path, errno);
+        close (fd);
+        return (FALSE);
+    }
+
+    pthread_mutex_lock (&nfc_cap_mutex);
+    nfc_cap_fd    = fd;
+    nfc_cap_p_hdr = (tNFC_CAP_FILE_HDR *) p_map;
+
+    memset (nfc_cap_p_hdr, 0, sizeof (tNFC_CAP_FILE_HDR));
+    nfc_cap_p_hdr->magic    = NFC_CAP_MAGIC;
+    nfc_cap_p_hdr->version  = NFC_CAP_VERSION;
+    nfc_cap_p_hdr->hdr_len  = sizeof (tNFC_CAP_FILE_HDR);
+    nfc_cap_p_hdr->file_len = file_len;
+    nfc_cap_p_hdr->head     = sizeof (tNFC_CAP_FILE_HDR);
+    nfc_cap_p_hdr->tail     = sizeof (tNFC_CAP_FILE_HDR);
+
+    nfc_cap_active = TRUE;
+    pthread_mutex_unlock (&nfc_cap_mutex);
+
+    ALOGD ("%s: capturing into %s (%lu bytes)", __FUNCTION__, p_path, (unsigned long) file_len);
+    return (TRUE);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_cap_open_config
+**
+** Description      Start capturing if NFC_CAPTURE_FILE is configured. The
+**                  capture goes to that file with p_suffix appended.
+**
+** Returns          TRUE if capture started
+**
+*******************************************************************************/
+BOOLEAN nfc_cap_open_config (const char *p_suffix)
+{
+    char            path[200];
+    unsigned long   file_len = NFC_CAPTURE_FILE_SIZE;
+
+    if (!GetStrValue (NAME_NFC_CAPTURE_FILE, path, sizeof (path) - strlen (p_suffix)))
+        return (FALSE);
+
+    strcat (path, p_suffix);
+    GetNumValue (NAME_NFC_CAPTURE_SIZE, &file_len, sizeof (file_len));
+
+    return (nfc_cap_open (path, (UINT32) file_len));
+}
+
+/*******************************************************************************
+**
+** Function         nfc_cap_close
+**
+** Description      Stop capturing.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_cap_close (void)
+{
+    pthread_mutex_lock (&nfc_cap_mutex);
+    nfc_cap_active = FALSE;
+
+    if (nfc_cap_p_hdr)
+    {
+        munmap (nfc_cap_p_hdr, nfc_cap_p_hdr->file_len);
+        nfc_cap_p_hdr = NULL;
+    }
+    if (nfc_cap_fd >= 0)
+    {
+        close (nfc_cap_fd);
+        nfc_cap_fd = -1;
+    }
+    pthread_mutex_unlock (&nfc_cap_mutex);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_cap_write
+**
+** Description      Capture one packet.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_cap_write (UINT8 proto, UINT8 flags, UINT8 conn_id, const UINT8 *p_data, UINT16 len)
+{
+    tNFC_CAP_FILE_HDR *p_hdr;
+    tNFC_CAP_REC_HDR  rec;
+    struct timespec   now;
+    UINT32 rec_len, head;
+
+    clock_gettime (CLOCK_REALTIME, &now);
+
+    rec.time_sec  = (UINT32) now.tv_sec;
+    rec.time_nsec = (UINT32) now.tv_nsec;
+    rec.orig_len  = len;
+    rec.proto     = proto;
+    rec.flags     = flags;
+    rec.conn_id   = conn_id;
+    rec.reserved  = 0;
+
+    if (len > NFC_CAPTURE_SNAP_LEN)
+    {
+        len         = NFC_CAPTURE_SNAP_LEN;
+        rec.flags  |= NFC_CAP_FLAG_TRUNCATED;
+    }
+    rec.len = len;
+    rec_len = NFC_CAP_REC_LEN (len);
+
+    pthread_mutex_lock (&nfc_cap_mutex);
+    if ((p_hdr = nfc_cap_p_hdr) != NULL)
+    {
+        head = p_hdr->head;
+        if (head + rec_len > p_hdr->file_len)
+        {
+            /* rest of the file is skipped; continue at the start */
+            nfc_cap_evict (head, p_hdr->file_len);
+            if (p_hdr->file_len - head >= sizeof (tNFC_CAP_REC_HDR))
+                ((tNFC_CAP_REC_HDR *) (NFC_CAP_BASE () + head))->proto = NFC_CAP_PROTO_WRAP;
+
+            head = p_hdr->hdr_len;
+            p_hdr->wraps++;
+        }
+        nfc_cap_evict (head, head + rec_len);
+
+        memcpy (NFC_CAP_BASE () + head, &rec, sizeof (rec));
+        memcpy (NFC_CAP_BASE () + head + sizeof (rec), p_data, len);
+
+        if (p_hdr->count++ == 0)
+            p_hdr->tail = head;
+        p_hdr->head = head + rec_len;
+    }
+    pthread_mutex_unlock (&nfc_cap_mutex);
+}
+
+#endif /* NFC_CAPTURE_INCLUDED */
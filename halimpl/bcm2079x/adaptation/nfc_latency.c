@@ -0,0 +1,262 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Transaction latency histograms.
+ *
+ ******************************************************************************/
+#include "OverrideLog.h"
+#include <string.h>
+#include <time.h>
+#include "nfc_latency.h"
+
+#if (NFC_LATENCY_INCLUDED == TRUE)
+
+#define LOG_TAG "NfcLatency"
+
+volatile UINT32 nfc_lat_rx_time = 0;
+UINT32          nfc_lat_origin = 0;
+
+static tNFC_LAT_HIST nfc_lat_hist[NFC_LAT_MAX_STAGES];
+
+static const char * const nfc_lat_name[NFC_LAT_MAX_STAGES] =
+{
+    "hal rx",       /* NFC_LAT_HAL_RX */
+    "ncif",         /* NFC_LAT_NCIF */
+    "nfa",          /* NFC_LAT_NFA */
+    "app",          /* NFC_LAT_APP */
+    "cmd rtt"       /* NFC_LAT_CMD_RTT */
+};
+
+/*******************************************************************************
+**
+** Function         nfc_lat_bucket
+**
+** Description      Get the bucket of a latency: values below 8 have their own
+**                  bucket, larger ones keep their 3 most significant bits.
+**
+** Returns          bucket index
+**
+*******************************************************************************/
+static UINT16 nfc_lat_bucket (UINT32 usec)
+{
+    UINT8 msb;
+
+    if (usec < (1 << NFC_LAT_SUB_BITS))
+        return ((UINT16) usec);
+
+    msb = 31 - __builtin_clz (usec);
+    return ((UINT16) (((msb - NFC_LAT_SUB_BITS + 1) << NFC_LAT_SUB_BITS)
+                      + ((usec >> (msb - NFC_LAT_SUB_BITS)) & ((1 << NFC_LAT_SUB_BITS) - 1))));
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_bucket_max
+**
+** Description      Get the largest latency which falls in a bucket.
+**
+** Returns          latency in microseconds
+**
+*******************************************************************************/
+static UINT32 nfc_lat_bucket_max (UINT16 idx)
+{
+    UINT8 shift;
+
+    if (idx < (1 << NFC_LAT_SUB_BITS))
+        return (idx);
+
+    shift = (idx >> NFC_LAT_SUB_BITS) - 1;
+    return ((((UINT32) (1 << NFC_LAT_SUB_BITS) + (idx & ((1 << NFC_LAT_SUB_BITS) - 1)) + 1) << shift) - 1);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_now
+**
+** Description      Get the time used to stamp latencies. It wraps around
+**                  every 71 minutes and is never 0, so 0 can mean no time.
+**
+** Returns          monotonic time in microseconds
+**
+*******************************************************************************/
+UINT32 nfc_lat_now (void)
+{
+    struct timespec now;
+    UINT32 usec;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    usec = (UINT32) now.tv_sec * 1000000 + (UINT32) now.tv_nsec / 1000;
+
+    return (usec ? usec : 1);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_add
+**
+** Description      Add a latency of usec microseconds to stage.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_lat_add (UINT8 stage, UINT32 usec)
+{
+    tNFC_LAT_HIST *p_hist;
+    UINT32 old;
+
+    if (stage >= NFC_LAT_MAX_STAGES)
+        return;
+    p_hist = &nfc_lat_hist[stage];
+
+    __sync_fetch_and_add (&p_hist->bucket[nfc_lat_bucket (usec)], 1);
+    __sync_fetch_and_add (&p_hist->sum_us, (uint64_t) usec);
+
+    __sync_fetch_and_add (&p_hist->count, 1);
+
+    while (((old = p_hist->min_inv) < ~usec) && !__sync_bool_compare_and_swap (&p_hist->min_inv, old, ~usec))
+        ;
+    while (((old = p_hist->max_us) < usec) && !__sync_bool_compare_and_swap (&p_hist->max_us, old, usec))
+        ;
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_since
+**
+** Description      Add the time elapsed since start_us (from nfc_lat_now) to
+**                  stage. Nothing is added if start_us is 0.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_lat_since (UINT8 stage, UINT32 start_us)
+{
+    if (start_us)
+        nfc_lat_add (stage, nfc_lat_now () - start_us);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_get
+**
+** Description      Summarize the latencies recorded for stage.
+**
+** Returns          TRUE if the stage has samples
+**
+*******************************************************************************/
+BOOLEAN nfc_lat_get (UINT8 stage, tNFC_LAT_STATS *p_stats)
+{
+    tNFC_LAT_HIST *p_hist;
+    UINT32 count, seen, p50, p90, p99;
+    UINT16 idx;
+
+    memset (p_stats, 0, sizeof (tNFC_LAT_STATS));
+
+    if (stage >= NFC_LAT_MAX_STAGES)
+        return (FALSE);
+    p_hist = &nfc_lat_hist[stage];
+
+    /* buckets are read once; their sum is the count of this summary */
+    for (idx = 0, count = 0; idx < NFC_LAT_NUM_BUCKETS; idx++)
+        count += p_hist->bucket[idx];
+    if (count == 0)
+        return (FALSE);
+
+    p_stats->count   = count;
+    p_stats->min_us  = ~p_hist->min_inv;
+    p_stats->max_us  = p_hist->max_us;
+    p_stats->mean_us = (UINT32) (p_hist->sum_us / count);
+
+    p50 = (UINT32) (((uint64_t) count * 50 + 99) / 100);
+    p90 = (UINT32) (((uint64_t) count * 90 + 99) / 100);
+    p99 = (UINT32) (((uint64_t) count * 99 + 99) / 100);
+
+    for (idx = 0, seen = 0; idx < NFC_LAT_NUM_BUCKETS; idx++)
+    {
+        if (p_hist->bucket[idx] == 0)
+            continue;
+
+        /* a percentile is in the bucket where seen reaches its rank */
+        if ((seen < p50) && (seen + p_hist->bucket[idx] >= p50))
+            p_stats->p50_us = nfc_lat_bucket_max (idx);
+        if ((seen < p90) && (seen + p_hist->bucket[idx] >= p90))
+            p_stats->p90_us = nfc_lat_bucket_max (idx);
+
+        seen += p_hist->bucket[idx];
+        if (seen >= p99)
+        {
+            p_stats->p99_us = nfc_lat_bucket_max (idx);
+            break;
+        }
+    }
+
+    /* the bucket bound may be above the largest sample */
+    if (p_stats->p50_us > p_stats->max_us)
+        p_stats->p50_us = p_stats->max_us;
+    if (p_stats->p90_us > p_stats->max_us)
+        p_stats->p90_us = p_stats->max_us;
+    if (p_stats->p99_us > p_stats->max_us)
+        p_stats->p99_us = p_stats->max_us;
+
+    return (TRUE);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_reset
+**
+** Description      Clear the histograms of all stages. Samples added while
+**                  clearing may be partly lost.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_lat_reset (void)
+{
+    memset ((void *) nfc_lat_hist, 0, sizeof (nfc_lat_hist));
+}
+
+/*******************************************************************************
+**
+** Function         nfc_lat_dump
+**
+** Description      Log the summary of every stage with samples.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_lat_dump (void)
+{
+    tNFC_LAT_STATS stats;
+    UINT8 stage;
+
+    for (stage = 0; stage < NFC_LAT_MAX_STAGES; stage++)
+    {
+        if (!nfc_lat_get (stage, &stats))
+            continue;
+
+        ALOGD ("%-8s n=%lu min=%lu mean=%lu p50=%lu p90=%lu p99=%lu max=%lu (usec)",
+               nfc_lat_name[stage], (unsigned long) stats.count, (unsigned long) stats.min_us,
+               (unsigned long) stats.mean_us, (unsigned long) stats.p50_us, (unsigned long) stats.p90_us,
+               (unsigned long) stats.p99_us, (unsigned long) stats.max_us);
+    }
+}
+
+#endif /* NFC_LATENCY_INCLUDED */
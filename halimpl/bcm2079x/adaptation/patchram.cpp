@@ -22,8 +22,14 @@
 extern "C"
 {
     #include "nfc_hal_post_reset.h"
+    #include "nfc_hal_nv_co.h"
 }
 #include <string>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "spdhelper.h"
 
 #define LOG_TAG "NfcNciHal"
@@ -37,12 +43,18 @@ extern "C"
 #define FW_PATCH                            "FW_PATCH"
 #define NFA_CONFIG_FORMAT                   "NFA_CONFIG_FORMAT"
 #define MAX_RF_DATA_CREDITS                 "MAX_RF_DATA_CREDITS"
+#define SPD_WINDOW                          "SPD_WINDOW"
 
 #define MAX_BUFFER      (512)
 static char sPrePatchFn[MAX_BUFFER+1];
 static char sPatchFn[MAX_BUFFER+1];
 static void * sPrmBuf = NULL;
+static UINT32 sPrmBufLen = 0;
 static void * sI2cFixPrmBuf = NULL;
+static UINT32 sI2cFixPrmBufLen = 0;
+static tNFC_HAL_NV_PATCH_INFO sPatchInfo;     // patch file being downloaded and NFCC version before download
+static bool sPatchInfoSaved = false;            // sPatchInfo is what non-volatile storage has already
+static bool sPatchInfoFound = false;            // non-volatile storage has patch information
 
 #define NFA_DM_START_UP_CFG_PARAM_MAX_LEN   100
 static UINT8 nfa_dm_start_up_cfg[NFA_DM_START_UP_CFG_PARAM_MAX_LEN];
@@ -76,21 +88,176 @@ tNFC_POST_RESET_CB nfc_post_reset_cb =
 
 /*******************************************************************************
 **
-** Function         getFileLength
+** Function         mapPatchFile
 **
-** Description      return the size of a file
+** Description      Map a patch file read-only into memory
 **
-** Returns          file size in number of bytes
+** Returns          address of the file contents, or NULL if failed
 **
 *******************************************************************************/
-static long getFileLength(FILE* fp)
+static void* mapPatchFile(const char* pFilename, UINT32* pLen)
 {
-    long sz;
-    fseek(fp, 0L, SEEK_END);
-    sz = ftell(fp);
-    fseek(fp, 0L, SEEK_SET);
+    struct stat st;
+    void* p = NULL;
+    int fd;
 
-    return sz;
+    if ((fd = open(pFilename, O_RDONLY)) < 0)
+        return NULL;
+
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+    {
+        p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+            p = NULL;
+        else
+        {
+            // the whole patch is sent right away; start reading it in
+            madvise(p, st.st_size, MADV_WILLNEED);
+            *pLen = (UINT32) st.st_size;
+        }
+    }
+    close(fd);
+    return p;
+}
+
+/*******************************************************************************
+**
+** Function         unmapPatchFiles
+**
+** Description      Release the patch files mapped by StartPatchDownload
+**
+** Returns          none
+**
+*******************************************************************************/
+static void unmapPatchFiles()
+{
+    if (sPrmBuf)
+    {
+        munmap(sPrmBuf, sPrmBufLen);
+        sPrmBuf = NULL;
+    }
+    if (sI2cFixPrmBuf)
+    {
+        HAL_NfcPrmSetI2cPatch(NULL, 0, 0);
+        munmap(sI2cFixPrmBuf, sI2cFixPrmBufLen);
+        sI2cFixPrmBuf = NULL;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         hashBytes
+**
+** Description      Add bytes to a 64-bit FNV-1a hash
+**
+** Returns          the new hash
+**
+*******************************************************************************/
+static uint64_t hashBytes(uint64_t hash, const void* p, size_t len)
+{
+    const UINT8* pb = (const UINT8*) p;
+
+    while (len--)
+    {
+        hash ^= *pb++;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+#define HASH_INIT   0xCBF29CE484222325ULL
+
+/*******************************************************************************
+**
+** Function         getPatchInfo
+**
+** Description      Get what identifies the patch file and the patch in the
+**                  NFCC before download, without reading the patch file
+**
+** Returns          TRUE if the patch file exists
+**
+*******************************************************************************/
+static BOOLEAN getPatchInfo(const char* pFilename, UINT32 chipid, tNFC_HAL_NV_PATCH_INFO* pInfo)
+{
+    struct stat st;
+
+    memset(pInfo, 0, sizeof(tNFC_HAL_NV_PATCH_INFO));
+    if (stat(pFilename, &st) != 0)
+        return FALSE;
+
+    pInfo->magic = NFC_HAL_NV_PATCH_INFO_MAGIC;
+    pInfo->hw_id = (uint32_t) chipid;
+    pInfo->name_hash = hashBytes(HASH_INIT, pFilename, strlen(pFilename));
+    pInfo->file_size = st.st_size;
+    pInfo->file_ino = st.st_ino;
+    pInfo->mtime = st.st_mtime;
+    pInfo->ctime = st.st_ctime;
+    pInfo->version_len = HAL_NfcGetPatchVersion(pInfo->version, sizeof(pInfo->version));
+    return TRUE;
+}
+
+/*******************************************************************************
+**
+** Function         isPatchInNvm
+**
+** Description      Check if the NFCC reports the same patch version as after
+**                  the download of the saved patch information. If bSameFile,
+**                  the patch file must also be unchanged; otherwise its
+**                  contents must be.
+**
+** Returns          TRUE if the patch does not need to be downloaded
+**
+*******************************************************************************/
+static BOOLEAN isPatchInNvm(const tNFC_HAL_NV_PATCH_INFO* pSaved, const tNFC_HAL_NV_PATCH_INFO* pInfo, bool bSameFile)
+{
+    if (  (pSaved->hw_id != pInfo->hw_id)
+        ||(pSaved->version_len == 0)
+        ||(pSaved->version_len != pInfo->version_len)
+        ||(memcmp(pSaved->version, pInfo->version, pInfo->version_len) != 0)  )
+        return FALSE;
+
+    if (bSameFile)
+        return (  (pSaved->name_hash == pInfo->name_hash)
+                &&(pSaved->file_size == pInfo->file_size)
+                &&(pSaved->file_ino == pInfo->file_ino)
+                &&(pSaved->mtime == pInfo->mtime)
+                &&(pSaved->ctime == pInfo->ctime)  );
+
+    return (  (pSaved->file_size == pInfo->file_size)
+            &&(pSaved->content_hash == pInfo->content_hash)  );
+}
+
+/*******************************************************************************
+**
+** Function         savePatchInfo
+**
+** Description      Called after a successful patch download. Save the patch
+**                  information if the patch was in the NVM of the NFCC
+**                  already: the NFCC then reported the version it reports
+**                  after the download, so next time the download is skipped
+**                  while the patch file and that version do not change.
+**
+** Returns          none
+**
+*******************************************************************************/
+static void savePatchInfo()
+{
+    if (sPatchInfo.magic != NFC_HAL_NV_PATCH_INFO_MAGIC)
+        return;
+
+    if (!HAL_NfcPrmPatchInNvm())
+    {
+        // the version of the new patch is known after the next reset
+        if (sPatchInfoFound)
+            nfc_hal_nv_co_write_patch_info(NULL);
+        sPatchInfoFound = false;
+    }
+    else if (!sPatchInfoSaved)
+    {
+        nfc_hal_nv_co_write_patch_info(&sPatchInfo);
+        sPatchInfoFound = true;
+    }
+    sPatchInfoSaved = sPatchInfoFound;
 }
 
 /*******************************************************************************
@@ -174,6 +341,9 @@ static void postDownloadPatchram(tHAL_NFC_STATUS status)
 {
     ALOGD("%s: status=%i", __FUNCTION__, status);
 
+    /* The HAL is done with the patch files */
+    unmapPatchFiles();
+
     if (status != HAL_NFC_STATUS_OK)
     {
         ALOGE("Patch download failed");
@@ -236,6 +406,7 @@ void prmCallback(UINT8 event)
         break;
 
     case NFC_HAL_PRM_COMPLETE_EVT:
+        savePatchInfo();
         postDownloadPatchram(HAL_NFC_STATUS_OK);
         break;
 
@@ -334,71 +505,80 @@ static void StartPatchDownload(UINT32 chipid)
     findPatchramFile(FW_PATCH, sPatchFn, sizeof(sPatchFn));
     findPatchramFile(FW_PRE_PATCH, sPrePatchFn, sizeof(sPatchFn));
 
+    unmapPatchFiles();
+
+    /* Skip the download without reading the patch file if neither the file
+       nor the patch in the NFCC changed since it was last found in the NVM */
+    tNFC_HAL_NV_PATCH_INFO saved;
+
+    sPatchInfoFound = nfc_hal_nv_co_read_patch_info(&saved);
+    sPatchInfoSaved = false;
+    if ((sPatchFn[0] == '\0') || !getPatchInfo(sPatchFn, chipid, &sPatchInfo))
+        memset(&sPatchInfo, 0, sizeof(sPatchInfo));
+    else if (sPatchInfoFound && isPatchInNvm(&saved, &sPatchInfo, true))
+    {
+        ALOGD("%s: patchfile %s unchanged and in NVM; skipping download", __FUNCTION__, sPatchFn);
+        postDownloadPatchram(HAL_NFC_STATUS_OK);
+        return;
+    }
+
     {
-        FILE *fd;
         /* If an I2C fix patch file was specified, then tell the stack about it */
         if (sPrePatchFn[0] != '\0')
         {
-            if ((fd = fopen(sPrePatchFn, "rb")) != NULL)
+            if ((sI2cFixPrmBuf = mapPatchFile(sPrePatchFn, &sI2cFixPrmBufLen)) != NULL)
             {
-                UINT32 lenPrmBuffer = getFileLength(fd);
-
-                if ((sI2cFixPrmBuf = malloc(lenPrmBuffer)) != NULL)
-                {
-                    fread(sI2cFixPrmBuf, lenPrmBuffer, 1, fd);
-
-                    ALOGD("%s Setting I2C fix to %s (size: %lu)", __FUNCTION__, sPrePatchFn, lenPrmBuffer);
-                    HAL_NfcPrmSetI2cPatch((UINT8*)sI2cFixPrmBuf, (UINT16)lenPrmBuffer, 0);
-                }
-                else
-                {
-                    ALOGE("%s Unable to get buffer to i2c fix (%lu bytes)", __FUNCTION__, lenPrmBuffer);
-                }
-
-                fclose(fd);
+                ALOGD("%s Setting I2C fix to %s (size: %lu)", __FUNCTION__, sPrePatchFn, sI2cFixPrmBufLen);
+                HAL_NfcPrmSetI2cPatch((UINT8*)sI2cFixPrmBuf, (UINT16)sI2cFixPrmBufLen, 0);
             }
             else
             {
-                ALOGE("%s Unable to open i2c fix patchfile %s", __FUNCTION__, sPrePatchFn);
+                ALOGE("%s Unable to map i2c fix patchfile %s", __FUNCTION__, sPrePatchFn);
             }
         }
     }
 
     {
-        FILE *fd;
-
         /* If a patch file was specified, then download it now */
         if (sPatchFn[0] != '\0')
         {
             UINT32 bDownloadStarted = false;
+            unsigned long window = 0;
 
-            /* open patchfile, read it into a buffer */
-            if ((fd = fopen(sPatchFn, "rb")) != NULL)
+            /* map the patchfile; the HAL reads the segments from the mapping */
+            if ((sPrmBuf = mapPatchFile(sPatchFn, &sPrmBufLen)) != NULL)
             {
-                UINT32 lenPrmBuffer = getFileLength(fd);
                 tNFC_HAL_PRM_FORMAT patch_format = NFC_HAL_PRM_FORMAT_NCD;
 
-                GetNumValue((char*)NFA_CONFIG_FORMAT, &patch_format, sizeof(patch_format));
-
-                ALOGD("%s Downloading patchfile %s (size: %lu) format=%u", __FUNCTION__, sPatchFn, lenPrmBuffer, patch_format);
-                if ((sPrmBuf = malloc(lenPrmBuffer)) != NULL)
+                if (sPatchInfo.magic == NFC_HAL_NV_PATCH_INFO_MAGIC)
                 {
-                    fread(sPrmBuf, lenPrmBuffer, 1, fd);
+                    sPatchInfo.file_size = sPrmBufLen;
+                    sPatchInfo.content_hash = hashBytes(HASH_INIT, sPrmBuf, sPrmBufLen);
 
-                    if (!SpdHelper::isPatchBad((UINT8*)sPrmBuf, lenPrmBuffer))
+                    /* The file was replaced by the same patch (e.g. by a system update) */
+                    if (sPatchInfoFound && isPatchInNvm(&saved, &sPatchInfo, false))
                     {
-                        /* Download patch using static memeory mode */
-                        HAL_NfcPrmDownloadStart(patch_format, 0, (UINT8*)sPrmBuf, lenPrmBuffer, 0, prmCallback);
-                        bDownloadStarted = true;
+                        ALOGD("%s: patchfile %s contents unchanged and in NVM; skipping download", __FUNCTION__, sPatchFn);
+                        nfc_hal_nv_co_write_patch_info(&sPatchInfo);
+                        postDownloadPatchram(HAL_NFC_STATUS_OK);
+                        return;
                     }
                 }
-                else
-                    ALOGE("%s Unable to buffer to hold patchram (%lu bytes)", __FUNCTION__, lenPrmBuffer);
 
-                fclose(fd);
+                GetNumValue((char*)NFA_CONFIG_FORMAT, &patch_format, sizeof(patch_format));
+                if (GetNumValue((char*)SPD_WINDOW, &window, sizeof(window)))
+                    HAL_NfcPrmSetSpdWindow((UINT8)window);
+
+                ALOGD("%s Downloading patchfile %s (size: %lu) format=%u", __FUNCTION__, sPatchFn, sPrmBufLen, patch_format);
+                if (!SpdHelper::isPatchBad((UINT8*)sPrmBuf, sPrmBufLen))
+                {
+                    /* Download patch using static memeory mode */
+                    HAL_NfcPrmDownloadStart(patch_format, 0, (UINT8*)sPrmBuf, sPrmBufLen, 0, prmCallback);
+                    bDownloadStarted = true;
+                }
             }
             else
-                ALOGE("%s Unable to open patchfile %s", __FUNCTION__, sPatchFn);
+                ALOGE("%s Unable to map patchfile %s", __FUNCTION__, sPatchFn);
 
             /* If the download never got started */
             if (!bDownloadStarted)
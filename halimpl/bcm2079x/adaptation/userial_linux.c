@@ -32,9 +32,11 @@
 #include <gki_int.h>
 #include "hcidefs.h"
 #include <poll.h>
+#include <sys/uio.h>
 #include "upio.h"
 #include "bcm2079x.h"
 #include "config.h"
+#include "nfc_latency.h"
 
 #define HCISU_EVT                           EVENT_MASK(APPL_EVT_0)
 #define MAX_ERROR                           10
@@ -118,9 +120,8 @@ static UINT8 spi_nego_res[20];
 #define USERIAL_IO_BT_WAKE_GET_ST   0x8005
 #endif
 
-/* the read limit in this current implementation depends on the GKI_BUF3_SIZE
- * It would be better to use some ring buffer from the USERIAL_Read() is reading
- * instead of putting it into GKI buffers.
+/* the read limit depends on the GKI_BUF3_SIZE when the received data is put
+ * into GKI buffers (USERIAL_RX_RING_INCLUDED == FALSE)
  */
 #define READ_LIMIT (USERIAL_POOL_BUF_SIZE-BT_HDR_SIZE)
 /*
@@ -247,6 +248,7 @@ void perf_update(tPERF_DATA* t, long lapse, long bytes)
 static tPERF_DATA   perf_poll = {"USERIAL_Poll", 0, 0, 0, 0};
 static tPERF_DATA   perf_read = {"USERIAL_Read", 0, 0, 0, 9};
 static tPERF_DATA   perf_write = {"USERIAL_Write", 0, 0, 0, 3};
+static tPERF_DATA   perf_writev = {"USERIAL_WriteV", 0, 0, 0, 3};
 static tPERF_DATA   perf_poll_2_poll = {"USERIAL_Poll_to_Poll", 0, 0, 0, 0};
 static clock_t      _poll_t0 = 0;
 
@@ -482,6 +484,23 @@ typedef unsigned char uchar;
 
 BUFFER_Q Userial_in_q;
 
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+#if (USERIAL_RX_READ_BATCH < MIN_BUFSIZE)
+#error "USERIAL_RX_READ_BATCH must hold a full sized packet"
+#endif
+/* Receive ring, written only by userial_read_thread and read only by the HAL
+ * task. The indices run freely and are masked on access. A read may go past the
+ * end of the ring into the spill area, which is then folded back to the start.
+ */
+#define USERIAL_RX_RING_MASK        (USERIAL_RX_RING_SIZE - 1)
+static UINT8            userial_rx_ring[USERIAL_RX_RING_SIZE + USERIAL_RX_READ_BATCH];
+static volatile UINT32  userial_rx_head = 0;    /* next byte written by the read thread */
+static volatile UINT32  userial_rx_tail = 0;    /* next byte read by the HAL task */
+/* time (ms) to wait for the HAL task to drain a full ring */
+#define RX_RING_FULL_RECOVER_TIME   5
+#define USERIAL_RX_RING_FREE()      (USERIAL_RX_RING_SIZE - (userial_rx_head - userial_rx_tail))
+#endif
+
 /*******************************************************************************
  **
  ** Function           USERIAL_GetLineSpeed
@@ -566,11 +585,18 @@ int my_read(int fd, uchar *pbuf, int len)
     int ret = 0;
     int count = 0;
     int offset = 0;
+    int bPacketRead;
     clock_t t1, t2;
 
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+    /* frame boundaries are found by the consumer of the receive ring */
+    bPacketRead = FALSE;
+#else
+    bPacketRead = (bSerialPortDevice && len >= MIN_BUFSIZE);
+    memset(pbuf, 0, len);
+#endif
     if (!isLowSpeedTransport && _timeout != POLL_TIMEOUT)
         ALOGD_IF((appl_trace_level>=BT_TRACE_LEVEL_DEBUG), "%s: enter, pbuf=%lx, len = %d\n", __func__, (unsigned long)pbuf, len);
-    memset(pbuf, 0, len);
     /* need to use select in order to avoid collistion between read and close on same fd */
     /* Initialize the input set */
     fds[0].fd = fd;
@@ -603,7 +629,7 @@ int my_read(int fd, uchar *pbuf, int len)
         reset_signal();
         return -1;
     }
-    if (!bSerialPortDevice || len < MIN_BUFSIZE)
+    if (!bPacketRead)
         count = len;
     else
         count = 1;
@@ -613,7 +639,7 @@ int my_read(int fd, uchar *pbuf, int len)
         if (ret > 0)
             perf_update(&perf_read, clock()-t2, ret);
 
-        if (ret <= 0 || !bSerialPortDevice || len < MIN_BUFSIZE)
+        if (ret <= 0 || !bPacketRead)
             break;
 
         if (isLowSpeedTransport)
@@ -689,6 +715,46 @@ done:
 extern BOOLEAN gki_chk_buf_damage(void *p_buf);
 static int sRxLength = 0;
 
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+/*******************************************************************************
+ **
+ ** Function           userial_ring_read
+ **
+ ** Description        Read whatever the driver has ready into the receive ring
+ **                    with a single read() call. The ring must have room for a
+ **                    full sized packet.
+ **
+ ** Output Parameter   None
+ **
+ ** Returns            number of bytes added to the ring or error code
+ **
+ *******************************************************************************/
+static int userial_ring_read(int fd)
+{
+    UINT32 head = userial_rx_head;
+    UINT32 idx  = head & USERIAL_RX_RING_MASK;
+    UINT32 len  = USERIAL_RX_RING_FREE();
+    int rx_length;
+
+    if (len > USERIAL_RX_READ_BATCH)
+        len = USERIAL_RX_READ_BATCH;
+
+    rx_length = my_read(fd, userial_rx_ring + idx, (int)len);
+    if (rx_length > 0)
+    {
+        /* fold what went past the end of the ring back to its start */
+        if (idx + rx_length > USERIAL_RX_RING_SIZE)
+            memcpy(userial_rx_ring, userial_rx_ring + USERIAL_RX_RING_SIZE,
+                   idx + rx_length - USERIAL_RX_RING_SIZE);
+
+        /* data must be visible before the new head */
+        __sync_synchronize();
+        userial_rx_head = head + rx_length;
+    }
+    return rx_length;
+}
+#endif
+
 /*******************************************************************************
  **
  ** Function           userial_read_thread
@@ -715,6 +781,15 @@ UINT32 userial_read_thread(UINT32 arg)
 
     for (;linux_cb.sock > 0;)
     {
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+        if (USERIAL_RX_RING_FREE() < MIN_BUFSIZE)
+        {
+            /* the HAL task has not drained the ring yet */
+            GKI_delay( RX_RING_FULL_RECOVER_TIME );
+            continue;
+        }
+        rx_length = userial_ring_read(linux_cb.sock);
+#else
         BT_HDR *p_buf;
         UINT8 *current_packet;
 
@@ -734,18 +809,28 @@ UINT32 userial_read_thread(UINT32 arg)
             GKI_delay( NO_GKI_BUFFER_RECOVER_TIME );
             continue;
         }
+#endif
         if (rx_length > 0)
         {
+#if (NFC_LATENCY_INCLUDED == TRUE)
+            nfc_lat_rx_time = nfc_lat_now();
+#endif
             bErrorReported = 0;
             error_count = 0;
             iMaxError = 3;
             if (rx_length > sRxLength)
                 sRxLength = rx_length;
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+            if (!isLowSpeedTransport)
+                ALOGD_IF((appl_trace_level>=BT_TRACE_LEVEL_DEBUG), "userial_read_thread(): length=%d, ring free=%d\n",
+                            rx_length, (int)USERIAL_RX_RING_FREE());
+#else
             p_buf->len = (UINT16)rx_length;
             GKI_enqueue(&Userial_in_q, p_buf);
             if (!isLowSpeedTransport)
                 ALOGD_IF((appl_trace_level>=BT_TRACE_LEVEL_DEBUG), "userial_read_thread(): enqueued p_buf=%p, count=%d, length=%d\n",
                             p_buf, Userial_in_q.count, rx_length);
+#endif
 
             if (linux_cb.ser_cb != NULL)
                 (*linux_cb.ser_cb)(linux_cb.port, USERIAL_RX_READY_EVT, (tUSERIAL_EVT_DATA *)p_buf);
@@ -754,7 +839,9 @@ UINT32 userial_read_thread(UINT32 arg)
         }
         else
         {
+#if (USERIAL_RX_RING_INCLUDED == FALSE)
             GKI_freebuf( p_buf );
+#endif
             if (rx_length == -EAGAIN)
                 continue;
             else if (rx_length == -1)
@@ -1018,6 +1105,9 @@ UDRV_API void USERIAL_Open(tUSERIAL_PORT port, tUSERIAL_OPEN_CFG *p_cfg, tUSERIA
     linux_cb.ser_cb     = p_cback;
     linux_cb.port = port;
     memcpy(&linux_cb.open_cfg, p_cfg, sizeof(tUSERIAL_OPEN_CFG));
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+    userial_rx_head = userial_rx_tail = 0;
+#endif
     GKI_create_task ((TASKPTR)userial_read_thread, USERIAL_HAL_TASK, (INT8*)"USERIAL_HAL_TASK", 0, 0, (pthread_cond_t*)NULL, NULL);
 
 
@@ -1049,6 +1139,29 @@ done_open:
 **
 *******************************************************************************/
 
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+UDRV_API UINT16  USERIAL_Read(tUSERIAL_PORT port, UINT8 *p_data, UINT16 len)
+{
+    UINT16 total_len = 0;
+    UINT16 copy_len;
+    UINT8  *p;
+
+    while ((total_len < len) && ((copy_len = USERIAL_ReadPeek(port, &p)) > 0))
+    {
+        if (copy_len > len - total_len)
+            copy_len = len - total_len;
+
+        memcpy(p_data + total_len, p, copy_len);
+        USERIAL_ReadConsume(port, copy_len);
+        total_len += copy_len;
+    }
+
+#if (defined USERIAL_DEBUG) && (USERIAL_DEBUG == TRUE)
+    ALOGD( "%s: returned %d bytes", __func__, total_len);
+#endif
+    return total_len;
+}
+#else
 static BT_HDR *pbuf_USERIAL_Read = NULL;
 
 UDRV_API UINT16  USERIAL_Read(tUSERIAL_PORT port, UINT8 *p_data, UINT16 len)
@@ -1095,6 +1208,7 @@ UDRV_API UINT16  USERIAL_Read(tUSERIAL_PORT port, UINT8 *p_data, UINT16 len)
 #endif
     return total_len;
 }
+#endif
 
 /*******************************************************************************
 **
@@ -1115,8 +1229,81 @@ UDRV_API UINT16  USERIAL_Read(tUSERIAL_PORT port, UINT8 *p_data, UINT16 len)
 
 UDRV_API void    USERIAL_ReadBuf(tUSERIAL_PORT port, BT_HDR **p_buf)
 {
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+    UINT8 *p;
+
+    *p_buf = NULL;
+    if (USERIAL_ReadPeek(port, &p) == 0)
+        return;
+
+    if ((*p_buf = (BT_HDR *) GKI_getpoolbuf( USERIAL_POOL_ID )) != NULL)
+    {
+        (*p_buf)->offset = 0;
+        (*p_buf)->layer_specific = 0;
+        (*p_buf)->len = USERIAL_Read(port, (UINT8 *) (*p_buf + 1), READ_LIMIT);
+    }
+#else
+    if (pbuf_USERIAL_Read != NULL)
+    {
+        /* hand over the rest of the buffer USERIAL_Read() was consuming */
+        *p_buf = pbuf_USERIAL_Read;
+        pbuf_USERIAL_Read = NULL;
+    }
+    else
+        *p_buf = (BT_HDR *)GKI_dequeue(&Userial_in_q);
+#endif
+}
+
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+/*******************************************************************************
+**
+** Function           USERIAL_ReadPeek
+**
+** Description        Get the received data from the serial port in place.
+**                    Only the part up to the end of the receive ring is
+**                    returned; call again after USERIAL_ReadConsume() for the
+**                    rest.
+**
+** Output Parameter   Pointer to the received data.
+**
+** Returns            Number of contiguous bytes at *pp_data.
+**
+*******************************************************************************/
+UDRV_API UINT16  USERIAL_ReadPeek(tUSERIAL_PORT port, UINT8 **pp_data)
+{
+    UINT32 tail = userial_rx_tail;
+    UINT32 idx  = tail & USERIAL_RX_RING_MASK;
+    UINT32 len  = userial_rx_head - tail;
 
+    /* data is read only after the head which published it */
+    __sync_synchronize();
+
+    if (len > USERIAL_RX_RING_SIZE - idx)
+        len = USERIAL_RX_RING_SIZE - idx;
+
+    *pp_data = userial_rx_ring + idx;
+    return (UINT16) len;
+}
+
+/*******************************************************************************
+**
+** Function           USERIAL_ReadConsume
+**
+** Description        Release len bytes returned by USERIAL_ReadPeek() back to
+**                    the read thread.
+**
+** Output Parameter   None
+**
+** Returns            Nothing
+**
+*******************************************************************************/
+UDRV_API void    USERIAL_ReadConsume(tUSERIAL_PORT port, UINT16 len)
+{
+    /* finish with the data before the read thread may overwrite it */
+    __sync_synchronize();
+    userial_rx_tail += len;
 }
+#endif
 
 /*******************************************************************************
 **
@@ -1179,6 +1366,76 @@ UDRV_API UINT16  USERIAL_Write(tUSERIAL_PORT port, UINT8 *p_data, UINT16 len)
     return ((UINT16)total);
 }
 
+/*******************************************************************************
+**
+** Function           USERIAL_WriteV
+**
+** Description        Write several data segments to a serial port with a single
+**                    writev(), e.g. NCI packet headers and payloads kept in
+**                    different buffers, or several queued NCI packets.
+**
+** Output Parameter   None
+**
+** Returns            Number of bytes actually written to the transport.  This
+**                    may be less than the total length of the segments.
+**
+*******************************************************************************/
+UDRV_API UINT16  USERIAL_WriteV(tUSERIAL_PORT port, tUSERIAL_IOVEC *p_iov, UINT8 iov_cnt)
+{
+    struct iovec iov[USERIAL_MAX_WRITE_IOV];
+    struct iovec *p_cur = iov;
+    int ret = 0, total = 0, len = 0;
+    int i, cnt;
+    clock_t t;
+
+    if (iov_cnt > USERIAL_MAX_WRITE_IOV)
+    {
+        ALOGE("USERIAL_WriteV: too many segments (%d)\n", iov_cnt);
+        return 0;
+    }
+
+    for (i = 0; i < iov_cnt; i++)
+    {
+        iov[i].iov_base = p_iov[i].p_data;
+        iov[i].iov_len  = p_iov[i].len;
+        len += p_iov[i].len;
+    }
+    cnt = iov_cnt;
+
+    doWriteDelay();
+    ALOGD_IF((appl_trace_level>=BT_TRACE_LEVEL_DEBUG), "USERIAL_WriteV: (%d bytes in %d segments) - \n", len, iov_cnt);
+    t = clock();
+    while (len != 0)
+    {
+        ret = writev(linux_cb.sock, p_cur, cnt);
+        if (ret < 0)
+            break;
+        total += ret;
+        len -= ret;
+
+        /* skip the segments written completely, then the written part of the next one */
+        while ((cnt > 0) && (ret >= (int) p_cur->iov_len))
+        {
+            ret -= p_cur->iov_len;
+            p_cur++;
+            cnt--;
+        }
+        if (cnt > 0)
+        {
+            p_cur->iov_base  = (UINT8 *) p_cur->iov_base + ret;
+            p_cur->iov_len  -= ret;
+        }
+    }
+    perf_update(&perf_writev, clock() - t, total);
+
+    ALOGD_IF((appl_trace_level>=BT_TRACE_LEVEL_DEBUG), "USERIAL_WriteV len = %d, ret =  %d, errno = %d\n", len, ret, errno);
+
+    /* register a delay for next write
+     */
+    setWriteDelay(total * nfc_write_delay / 1000);
+    return ((UINT16)total);
+}
+
 /*******************************************************************************
 **
 ** Function           userial_change_rate
@@ -320,6 +320,31 @@
 #endif /* GKI_NUM_FIXED_BUF_POOLS < 16 */
 
 
+/* TRUE to keep timer lists in a hierarchical timing wheel instead of a sorted
+** delta list. Start, stop and remaining time are then O(1) and expired entries
+** are collected a wheel slot at a time.
+*/
+#ifndef GKI_USE_TIMER_WHEEL
+#define GKI_USE_TIMER_WHEEL         TRUE
+#endif
+
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+/* Each level has (1 << GKI_TIMER_WHEEL_BITS) slots. Timers further out than
+** (1 << (GKI_TIMER_WHEEL_BITS * GKI_TIMER_WHEEL_LEVELS)) units wait in the
+** last level and are moved down when it comes round.
+*/
+#ifndef GKI_TIMER_WHEEL_BITS
+#define GKI_TIMER_WHEEL_BITS        6
+#endif
+
+#ifndef GKI_TIMER_WHEEL_LEVELS
+#define GKI_TIMER_WHEEL_LEVELS      4
+#endif
+
+#define GKI_TIMER_WHEEL_SLOTS       (1 << GKI_TIMER_WHEEL_BITS)
+#define GKI_TIMER_WHEEL_MAP_WORDS   ((GKI_TIMER_WHEEL_SLOTS + 31) / 32)
+#endif
+
 /* Timer list entry callback type
 */
 typedef void (TIMER_CBACK)(void *p_tle);
@@ -341,15 +366,32 @@ typedef struct _tle
     TIMER_PARAM_TYPE   param;
     UINT16        event;
     UINT8         in_use;
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+    struct _tle  *p_slot_next;      /* next entry in the same wheel slot */
+    struct _tle **pp_slot_prev;     /* link pointing at this entry in the wheel slot */
+    UINT32        expiry;           /* expiration time in timer list units */
+#endif
 } TIMER_LIST_ENT;
 
 /* Define a timer list queue
+**
+** With GKI_USE_TIMER_WHEEL, p_first still lists every entry in use, expired
+** entries (ticks of 0) first, so that "p_first == NULL" and the expiry loops
+** over p_first work the same for both implementations.
 */
 typedef struct
 {
     TIMER_LIST_ENT   *p_first;
     TIMER_LIST_ENT   *p_last;
     INT32             last_ticks;
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+    TIMER_LIST_ENT   *p_last_expired;   /* last expired entry in the p_first list */
+    UINT32            now;              /* number of units since the list was initialized */
+    UINT16            num_expired;      /* number of expired entries */
+    UINT16            num_pending;      /* number of entries in the wheel */
+    TIMER_LIST_ENT   *wheel[GKI_TIMER_WHEEL_LEVELS][GKI_TIMER_WHEEL_SLOTS];
+    UINT32            slot_map[GKI_TIMER_WHEEL_LEVELS][GKI_TIMER_WHEEL_MAP_WORDS]; /* bit set for slots which may have entries */
+#endif
 } TIMER_LIST_Q;
 
 
@@ -405,6 +447,8 @@ GKI_API extern void GKI_shiftup (UINT8 *p_dest, UINT8 *p_src, UINT32 len);
 /* To send buffers and events between tasks
 */
 GKI_API extern UINT8   GKI_isend_event (UINT8, UINT16);
+GKI_API extern UINT8   GKI_add_wait_fd (UINT8, int, UINT16);
+GKI_API extern UINT8   GKI_remove_wait_fd (UINT8, int);
 GKI_API extern void    GKI_isend_msg (UINT8, UINT8, void *);
 GKI_API extern void   *GKI_read_mbox  (UINT8);
 GKI_API extern void    GKI_send_msg   (UINT8, UINT8, void *);
@@ -425,6 +469,8 @@ GKI_API extern void   *GKI_getbuf_debug (UINT16, const char *, int);
 GKI_API extern void   *GKI_getbuf (UINT16);
 #endif
 GKI_API extern UINT16  GKI_get_buf_size (void *);
+GKI_API extern void    GKI_set_buf_time (void *, UINT32);
+GKI_API extern UINT32  GKI_get_buf_time (void *);
 #if GKI_BUFFER_DEBUG
 #define GKI_getpoolbuf(id)    GKI_getpoolbuf_debug(id, __FUNCTION__, __LINE__)
 GKI_API extern void   *GKI_getpoolbuf_debug (UINT8, const char *, int);
@@ -503,9 +549,13 @@ GKI_API extern void    GKI_exception (UINT16, char *);
 GKI_API extern void    GKI_PrintBufferUsage(UINT8 *p_num_pools, UINT16 *p_cur_used);
 GKI_API extern void    GKI_PrintBuffer(void);
 GKI_API extern void    GKI_print_task(void);
+GKI_API extern void    GKI_BufferBenchmark(UINT32 loops);
+GKI_API extern void    GKI_TimerListBenchmark(UINT16 num_timers, UINT32 max_ticks);
 #else
 #undef GKI_PrintBufferUsage
 #define GKI_PrintBuffer() NULL
+#define GKI_BufferBenchmark(loops)
+#define GKI_TimerListBenchmark(num_timers, max_ticks)
 #endif
 
 #ifdef __cplusplus
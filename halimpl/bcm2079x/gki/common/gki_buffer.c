@@ -25,8 +25,20 @@
 #if (!defined(BTU_STACK_LITE_ENABLED) || BTU_STACK_LITE_ENABLED == FALSE)
 static void gki_add_to_pool_list(UINT8 pool_id);
 static void gki_remove_from_pool_list(UINT8 pool_id);
+static void gki_build_size_class_table(void);
 #endif /*  BTU_STACK_LITE_ENABLED == FALSE */
 
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+/* head of a lock-free free list: buffer index in bits 0-15, ABA tag in bits 16-31 */
+#define GKI_LF_NONE             0xFFFF
+#define GKI_LF_IDX(h)           ((UINT16) ((h) & 0xFFFF))
+#define GKI_LF_TAG(h)           ((UINT16) ((h) >> 16))
+#define GKI_LF_HEAD(idx, tag)   ((((UINT32) (UINT16) (tag)) << 16) | (UINT16) (idx))
+
+static BUFFER_HDR_T *gki_lf_getbuf (UINT8 id, UINT8 task_id);
+static void gki_lf_freebuf (BUFFER_HDR_T *p_hdr);
+#endif
+
 #if GKI_BUFFER_DEBUG
 #define LOG_TAG "GKI_DEBUG"
 #define LOGD(format, ...)  LogMsg (TRACE_CTRL_GENERAL | TRACE_LAYER_GKI | TRACE_ORG_GKI | TRACE_TYPE_GENERIC, format, ## __VA_ARGS__)
@@ -55,13 +67,6 @@ static void gki_init_free_queue (UINT8 id, UINT16 size, UINT16 total, void *p_me
     tempsize = (INT32)ALIGN_POOL(size);
     act_size = (UINT16)(tempsize + BUFFER_PADDING_SIZE);
 
-    /* Remember pool start and end addresses */
-    if(p_mem)
-    {
-        p_cb->pool_start[id] = (UINT8 *)p_mem;
-        p_cb->pool_end[id]   = (UINT8 *)p_mem + (act_size * total);
-    }
-
     p_cb->pool_size[id]  = act_size;
 
     p_cb->freeq[id].size      = (UINT16) tempsize;
@@ -83,6 +88,9 @@ static void gki_init_free_queue (UINT8 id, UINT16 size, UINT16 total, void *p_me
             hdr->task_id = GKI_INVALID_TASK;
             hdr->q_id    = id;
             hdr->status  = BUF_STATUS_FREE;
+#if (GKI_BUF_TIME_INCLUDED == TRUE)
+            hdr->time    = 0;
+#endif
             magic        = (UINT32 *)((UINT8 *)hdr + BUFFER_HDR_SIZE + tempsize);
             *magic       = MAGIC_NO;
             hdr1         = hdr;
@@ -91,6 +99,16 @@ static void gki_init_free_queue (UINT8 id, UINT16 size, UINT16 total, void *p_me
         }
         hdr1->p_next = NULL;
         p_cb->freeq[id].p_last = hdr1;
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+        p_cb->freeq[id].lf_head = GKI_LF_HEAD (((total) ? 0 : GKI_LF_NONE), 0);
+
+        /* gki_lf_getbuf() tests pool_start without a lock: publish the pool
+        ** only after its free list is complete */
+        __sync_synchronize ();
+#endif
+        /* Remember pool start and end addresses */
+        p_cb->pool_end[id]   = (UINT8 *)p_mem + (act_size * total);
+        p_cb->pool_start[id] = (UINT8 *)p_mem;
     }
     return;
 }
@@ -102,7 +120,7 @@ static BOOLEAN gki_alloc_free_queue(UINT8 id)
     tGKI_COM_CB *p_cb = &gki_cb.com;
     printf("\ngki_alloc_free_queue in, id:%d \n", id);
 
-    Q = &p_cb->freeq[p_cb->pool_list[id]];
+    Q = &p_cb->freeq[id];
 
     if(Q->p_first == 0)
     {
@@ -122,6 +140,260 @@ static BOOLEAN gki_alloc_free_queue(UINT8 id)
 }
 #endif
 
+/*******************************************************************************
+**
+** Function         gki_build_size_class_table
+**
+** Description      Rebuilds the table used by GKI_getbuf() to find the public
+**                  pools that can hold a requested size. Requested sizes are
+**                  grouped in classes of (1 << GKI_BUF_SIZE_CLASS_SHIFT) bytes;
+**                  each class holds the first public pool, in the order of
+**                  size, that can hold the smallest size of the class.
+**
+**                  Must be called whenever the pool list or the pool
+**                  permissions change. GKI_getbuf() reads the table without
+**                  a lock, so the new table is built in the one not in use
+**                  and published with a single pointer store.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_build_size_class_table(void)
+{
+    tGKI_COM_CB *p_cb = &gki_cb.com;
+    tGKI_SIZE_CLASS_TBL *p_tbl;
+    UINT32      xx, yy;
+    UINT8       num_pools = 0;
+    UINT8       pool_id;
+
+    if (p_cb->p_size_class == &p_cb->size_class_tbl[0])
+        p_tbl = &p_cb->size_class_tbl[1];
+    else
+        p_tbl = &p_cb->size_class_tbl[0];
+
+    /* Collect the public pools, arranged in the order of size */
+    for (xx = 0; xx < p_cb->curr_total_no_of_pools; xx++)
+    {
+        pool_id = p_cb->pool_list[xx];
+
+        if (((UINT16)1 << pool_id) & p_cb->pool_access_mask)
+            continue;
+
+        for (yy = num_pools; yy > 0; yy--)
+        {
+            if (p_cb->freeq[p_tbl->pools[yy - 1]].size <= p_cb->freeq[pool_id].size)
+                break;
+            p_tbl->pools[yy] = p_tbl->pools[yy - 1];
+        }
+        p_tbl->pools[yy] = pool_id;
+        num_pools++;
+    }
+    p_tbl->num_pools = num_pools;
+
+    /* Map each size class to the first pool that can hold its smallest size */
+    for (xx = 0, yy = 0; xx < GKI_NUM_BUF_SIZE_CLASSES; xx++)
+    {
+        while (  (yy < num_pools)
+               &&(p_cb->freeq[p_tbl->pools[yy]].size < (xx << GKI_BUF_SIZE_CLASS_SHIFT) + 1)  )
+            yy++;
+
+        p_tbl->first[xx] = (UINT8) yy;
+    }
+
+    /* the table must be complete before GKI_getbuf() can see it */
+    __sync_synchronize ();
+    p_cb->p_size_class = p_tbl;
+}
+
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+/*******************************************************************************
+**
+** Function         gki_lf_hdr
+**
+** Description      Convert an index in a lock-free free list to its buffer
+**
+** Returns          buffer header
+**
+*******************************************************************************/
+static BUFFER_HDR_T *gki_lf_hdr (UINT8 id, UINT16 idx)
+{
+    return ((BUFFER_HDR_T *) (gki_cb.com.pool_start[id] + (UINT32) idx * gki_cb.com.pool_size[id]));
+}
+
+/*******************************************************************************
+**
+** Function         gki_lf_idx
+**
+** Description      Convert a buffer to its index in a lock-free free list
+**
+** Returns          index, or GKI_LF_NONE for NULL
+**
+*******************************************************************************/
+static UINT16 gki_lf_idx (UINT8 id, BUFFER_HDR_T *p_hdr)
+{
+    if (p_hdr == NULL)
+        return (GKI_LF_NONE);
+
+    return ((UINT16) (((UINT8 *) p_hdr - gki_cb.com.pool_start[id]) / gki_cb.com.pool_size[id]));
+}
+
+/*******************************************************************************
+**
+** Function         gki_lf_pop
+**
+** Description      Take the first buffer from the free list of a pool.
+**
+**                  The list head carries a tag which is bumped on every
+**                  change, so a head which was popped and pushed back by
+**                  another task in the meantime fails the compare-and-swap.
+**
+** Returns          buffer header, or NULL if the list is empty
+**
+*******************************************************************************/
+static BUFFER_HDR_T *gki_lf_pop (UINT8 id)
+{
+    FREE_QUEUE_T  *Q = &gki_cb.com.freeq[id];
+    BUFFER_HDR_T  *p_hdr;
+    UINT32        old_head, new_head;
+
+    do
+    {
+        old_head = Q->lf_head;
+        if (GKI_LF_IDX (old_head) == GKI_LF_NONE)
+            return (NULL);
+
+        p_hdr    = gki_lf_hdr (id, GKI_LF_IDX (old_head));
+        new_head = GKI_LF_HEAD (gki_lf_idx (id, p_hdr->p_next), GKI_LF_TAG (old_head) + 1);
+    } while (!__sync_bool_compare_and_swap (&Q->lf_head, old_head, new_head));
+
+    return (p_hdr);
+}
+
+/*******************************************************************************
+**
+** Function         gki_lf_push
+**
+** Description      Return a buffer to the free list of its pool
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_lf_push (UINT8 id, BUFFER_HDR_T *p_hdr)
+{
+    FREE_QUEUE_T  *Q = &gki_cb.com.freeq[id];
+    UINT16        idx = gki_lf_idx (id, p_hdr);
+    UINT32        old_head, new_head;
+
+    do
+    {
+        old_head = Q->lf_head;
+        if (GKI_LF_IDX (old_head) == GKI_LF_NONE)
+            p_hdr->p_next = NULL;
+        else
+            p_hdr->p_next = gki_lf_hdr (id, GKI_LF_IDX (old_head));
+
+        new_head = GKI_LF_HEAD (idx, GKI_LF_TAG (old_head) + 1);
+    } while (!__sync_bool_compare_and_swap (&Q->lf_head, old_head, new_head));
+}
+
+/*******************************************************************************
+**
+** Function         gki_lf_getbuf
+**
+** Description      Take a free buffer from a pool without GKI_disable(). The
+**                  task cache is used first, if configured. The pool memory is
+**                  allocated on first use.
+**
+**                  cur_cnt/max_cnt are updated atomically but only as
+**                  statistics; availability is decided by the free list.
+**
+** Returns          buffer header, or NULL if the pool is empty
+**
+*******************************************************************************/
+static BUFFER_HDR_T *gki_lf_getbuf (UINT8 id, UINT8 task_id)
+{
+    tGKI_COM_CB   *p_cb = &gki_cb.com;
+    FREE_QUEUE_T  *Q = &p_cb->freeq[id];
+    BUFFER_HDR_T  *p_hdr = NULL;
+    UINT16        cnt, max;
+
+    if (Q->total == 0)
+        return (NULL);
+
+#if (GKI_BUF_TASK_CACHE_SIZE > 0)
+    if ((task_id < GKI_MAX_TASKS) && (p_cb->task_buf_cache_cnt[task_id][id] > 0))
+    {
+        p_hdr = p_cb->task_buf_cache[task_id][id][--p_cb->task_buf_cache_cnt[task_id][id]];
+    }
+#endif
+
+    if (p_hdr == NULL)
+    {
+#ifdef GKI_USE_DEFERED_ALLOC_BUF_POOLS
+        if (p_cb->pool_start[id] == NULL)
+        {
+            GKI_disable();
+            if ((p_cb->pool_start[id] == NULL) && (gki_alloc_free_queue (id) != TRUE))
+            {
+                GKI_enable();
+                GKI_TRACE_ERROR_0("GKI_getbuf() out of buffer");
+                return (NULL);
+            }
+            GKI_enable();
+        }
+#endif
+        if ((p_hdr = gki_lf_pop (id)) == NULL)
+            return (NULL);
+    }
+
+    cnt = __sync_add_and_fetch (&Q->cur_cnt, 1);
+    while (cnt > (max = Q->max_cnt))
+    {
+        if (__sync_bool_compare_and_swap (&Q->max_cnt, max, cnt))
+            break;
+    }
+
+    return (p_hdr);
+}
+
+/*******************************************************************************
+**
+** Function         gki_lf_freebuf
+**
+** Description      Return a buffer to the task cache, if configured and not
+**                  full, or to the free list of its pool
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_lf_freebuf (BUFFER_HDR_T *p_hdr)
+{
+    FREE_QUEUE_T  *Q = &gki_cb.com.freeq[p_hdr->q_id];
+    UINT16        cnt;
+#if (GKI_BUF_TASK_CACHE_SIZE > 0)
+    tGKI_COM_CB   *p_cb = &gki_cb.com;
+    UINT8         task_id = GKI_get_taskid();
+#endif
+
+    do
+    {
+        cnt = Q->cur_cnt;
+    } while ((cnt > 0) && (!__sync_bool_compare_and_swap (&Q->cur_cnt, cnt, cnt - 1)));
+
+#if (GKI_BUF_TASK_CACHE_SIZE > 0)
+    if (  (task_id < GKI_MAX_TASKS)
+        &&(p_cb->task_buf_cache_cnt[task_id][p_hdr->q_id] < GKI_BUF_TASK_CACHE_SIZE)  )
+    {
+        p_hdr->p_next = NULL;
+        p_cb->task_buf_cache[task_id][p_hdr->q_id][p_cb->task_buf_cache_cnt[task_id][p_hdr->q_id]++] = p_hdr;
+        return;
+    }
+#endif
+
+    gki_lf_push (p_hdr->q_id, p_hdr);
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         gki_buffer_init
@@ -144,6 +416,9 @@ void gki_buffer_init(void)
         {
             p_cb->OSTaskQFirst[tt][mb] = NULL;
             p_cb->OSTaskQLast [tt][mb] = NULL;
+#if (GKI_BATCH_MBOX_READ == TRUE)
+            p_cb->OSTaskQBatch[tt][mb] = NULL;
+#endif
         }
     }
 
@@ -159,6 +434,9 @@ void gki_buffer_init(void)
         p_cb->freeq[tt].total   = 0;
         p_cb->freeq[tt].cur_cnt = 0;
         p_cb->freeq[tt].max_cnt = 0;
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+        p_cb->freeq[tt].lf_head = GKI_LF_HEAD (GKI_LF_NONE, 0);
+#endif
     }
 
     /* Use default from target.h */
@@ -305,6 +583,8 @@ void gki_buffer_init(void)
 
     p_cb->curr_total_no_of_pools = GKI_NUM_FIXED_BUF_POOLS;
 
+    gki_build_size_class_table();
+
     return;
 }
 
@@ -350,9 +630,15 @@ void *GKI_getbuf (UINT16 size)
 #endif
 {
     UINT8         i;
+#if (GKI_USE_LOCKFREE_BUF_POOLS != TRUE)
     FREE_QUEUE_T  *Q;
+#endif
     BUFFER_HDR_T  *p_hdr;
     tGKI_COM_CB *p_cb = &gki_cb.com;
+    tGKI_SIZE_CLASS_TBL *p_tbl = p_cb->p_size_class;
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    UINT8         task_id;
+#endif
 #if GKI_BUFFER_DEBUG
     UINT8         x;
 #endif
@@ -367,34 +653,65 @@ void *GKI_getbuf (UINT16 size)
     LOGD("GKI_getbuf() requesting %d func:%s(line=%d)", size, _function_, _line_);
 #endif
     /* Find the first buffer pool that is public that can hold the desired size */
-    for (i=0; i < p_cb->curr_total_no_of_pools; i++)
+    i = p_tbl->first[(size - 1) >> GKI_BUF_SIZE_CLASS_SHIFT];
+    while ((i < p_tbl->num_pools) && (size > p_cb->freeq[p_tbl->pools[i]].size))
+        i++;
+
+    if (i == p_tbl->num_pools)
     {
-        if ( size <= p_cb->freeq[p_cb->pool_list[i]].size )
-            break;
+        /* Only report sizes that no pool at all can hold */
+        for (i = 0; i < p_cb->curr_total_no_of_pools; i++)
+        {
+            if (size <= p_cb->freeq[p_cb->pool_list[i]].size)
+                break;
+        }
+
+        if (i == p_cb->curr_total_no_of_pools)
+            GKI_exception (GKI_ERROR_BUF_SIZE_TOOBIG, "getbuf: Size is too big");
+        else
+            GKI_TRACE_ERROR_0("GKI_getbuf() unable to allocate buffer!!!!!");
+
+        return (NULL);
     }
 
-    if(i == p_cb->curr_total_no_of_pools)
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    task_id = GKI_get_taskid();
+
+    /* search the public buffer pools that are big enough to hold the size
+     * until a free buffer is found */
+    for ( ; i < p_tbl->num_pools; i++)
     {
-        GKI_exception (GKI_ERROR_BUF_SIZE_TOOBIG, "getbuf: Size is too big");
-        return (NULL);
+        if ((p_hdr = gki_lf_getbuf (p_tbl->pools[i], task_id)) != NULL)
+        {
+            p_hdr->task_id = task_id;
+
+            p_hdr->status  = BUF_STATUS_UNLINKED;
+            p_hdr->p_next  = NULL;
+            p_hdr->Type    = 0;
+#if GKI_BUFFER_DEBUG
+            strncpy(p_hdr->_function, _function_, _GKI_MAX_FUNCTION_NAME_LEN);
+            p_hdr->_function[_GKI_MAX_FUNCTION_NAME_LEN] = '\0';
+            p_hdr->_line = _line_;
+#endif
+            return ((void *) ((UINT8 *)p_hdr + BUFFER_HDR_SIZE));
+        }
     }
 
+    GKI_TRACE_ERROR_0("GKI_getbuf() unable to allocate buffer!!!!!");
+    return (NULL);
+#else
     /* Make sure the buffers aren't disturbed til finished with allocation */
     GKI_disable();
 
     /* search the public buffer pools that are big enough to hold the size
      * until a free buffer is found */
-    for ( ; i < p_cb->curr_total_no_of_pools; i++)
+    for ( ; i < p_tbl->num_pools; i++)
     {
-        /* Only look at PUBLIC buffer pools (bypass RESTRICTED pools) */
-        if (((UINT16)1 << p_cb->pool_list[i]) & p_cb->pool_access_mask)
-            continue;
-
-        Q = &p_cb->freeq[p_cb->pool_list[i]];
+        Q = &p_cb->freeq[p_tbl->pools[i]];
         if(Q->cur_cnt < Q->total)
         {
         #ifdef GKI_USE_DEFERED_ALLOC_BUF_POOLS
-            if(Q->p_first == 0 && gki_alloc_free_queue(i) != TRUE)
+            if(Q->p_first == 0 && gki_alloc_free_queue(p_tbl->pools[i]) != TRUE)
             {
                 GKI_TRACE_ERROR_0("GKI_getbuf() out of buffer");
                 return NULL;
@@ -460,6 +777,7 @@ void *GKI_getbuf (UINT16 size)
     GKI_enable();
 
     return (NULL);
+#endif
 }
 
 
@@ -484,9 +802,14 @@ void *GKI_getpoolbuf_debug (UINT8 pool_id, const char * _function_, int _line_)
 void *GKI_getpoolbuf (UINT8 pool_id)
 #endif
 {
+#if (GKI_USE_LOCKFREE_BUF_POOLS != TRUE)
     FREE_QUEUE_T  *Q;
+#endif
     BUFFER_HDR_T  *p_hdr;
     tGKI_COM_CB *p_cb = &gki_cb.com;
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    UINT8         task_id;
+#endif
 
     if (pool_id >= GKI_NUM_TOTAL_BUF_POOLS)
         return (NULL);
@@ -494,6 +817,24 @@ void *GKI_getpoolbuf (UINT8 pool_id)
 #if GKI_BUFFER_DEBUG
     LOGD("GKI_getpoolbuf() requesting from %d func:%s(line=%d)", pool_id, _function_, _line_);
 #endif
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    task_id = GKI_get_taskid();
+
+    if ((p_hdr = gki_lf_getbuf (pool_id, task_id)) != NULL)
+    {
+        p_hdr->task_id = task_id;
+
+        p_hdr->status  = BUF_STATUS_UNLINKED;
+        p_hdr->p_next  = NULL;
+        p_hdr->Type    = 0;
+#if GKI_BUFFER_DEBUG
+        strncpy(p_hdr->_function, _function_, _GKI_MAX_FUNCTION_NAME_LEN);
+        p_hdr->_function[_GKI_MAX_FUNCTION_NAME_LEN] = '\0';
+        p_hdr->_line = _line_;
+#endif
+        return ((void *) ((UINT8 *)p_hdr + BUFFER_HDR_SIZE));
+    }
+#else
     /* Make sure the buffers aren't disturbed til finished with allocation */
     GKI_disable();
 
@@ -534,6 +875,7 @@ void *GKI_getpoolbuf (UINT8 pool_id)
 
     /* If here, no buffers in the specified pool */
     GKI_enable();
+#endif
 
 #if GKI_BUFFER_DEBUG
     /* try for free buffers in public pools */
@@ -557,7 +899,9 @@ void *GKI_getpoolbuf (UINT8 pool_id)
 *******************************************************************************/
 void GKI_freebuf (void *p_buf)
 {
+#if (GKI_USE_LOCKFREE_BUF_POOLS != TRUE)
     FREE_QUEUE_T    *Q;
+#endif
     BUFFER_HDR_T    *p_hdr;
 
 #if (GKI_ENABLE_BUF_CORRUPTION_CHECK == TRUE)
@@ -586,6 +930,16 @@ void GKI_freebuf (void *p_buf)
         return;
     }
 
+#if (GKI_BUF_TIME_INCLUDED == TRUE)
+    p_hdr->time = 0;
+#endif
+
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    p_hdr->status  = BUF_STATUS_FREE;
+    p_hdr->task_id = GKI_INVALID_TASK;
+
+    gki_lf_freebuf (p_hdr);
+#else
     GKI_disable();
 
     /*
@@ -605,6 +959,7 @@ void GKI_freebuf (void *p_buf)
         Q->cur_cnt--;
 
     GKI_enable();
+#endif
 
     return;
 }
@@ -638,6 +993,49 @@ UINT16 GKI_get_buf_size (void *p_buf)
     return (0);
 }
 
+
+/*******************************************************************************
+**
+** Function         GKI_set_buf_time
+**
+** Description      Called by an application to store a time in a buffer, e.g.
+**                  when the data it holds was received. The time follows the
+**                  buffer through queues and mailboxes until it is freed.
+**
+** Parameters       p_buf - (input) address of the beginning of a buffer.
+**                  time  - (input) time in units of the caller's choice
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_set_buf_time (void *p_buf, UINT32 time)
+{
+#if (GKI_BUF_TIME_INCLUDED == TRUE)
+    ((BUFFER_HDR_T *) ((UINT8 *) p_buf - BUFFER_HDR_SIZE))->time = time;
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         GKI_get_buf_time
+**
+** Description      Called by an application to get the time stored in a
+**                  buffer by GKI_set_buf_time().
+**
+** Parameters       p_buf - (input) address of the beginning of a buffer.
+**
+** Returns          the time, or 0 if none was set since the buffer was taken
+**
+*******************************************************************************/
+UINT32 GKI_get_buf_time (void *p_buf)
+{
+#if (GKI_BUF_TIME_INCLUDED == TRUE)
+    return (((BUFFER_HDR_T *) ((UINT8 *) p_buf - BUFFER_HDR_SIZE))->time);
+#else
+    return (0);
+#endif
+}
+
 /*******************************************************************************
 **
 ** Function         gki_chk_buf_damage
@@ -735,6 +1133,11 @@ void GKI_send_msg (UINT8 task_id, UINT8 mbox, void *msg)
 ** Description      Called by applications to read a buffer from one of
 **                  the task mailboxes.  A task can only read its own mailbox.
 **
+**                  With GKI_BATCH_MBOX_READ the whole mailbox is moved to a
+**                  task private batch in one critical section; the following
+**                  reads are served from that batch without locking, so a
+**                  task draining N messages takes the GKI lock once, not N times.
+**
 ** Parameters:      mbox  - (input) mailbox ID to read (0, 1, 2, or 3)
 **
 ** Returns          NULL if the mailbox was empty, else the address of a buffer
@@ -749,6 +1152,31 @@ void *GKI_read_mbox (UINT8 mbox)
     if ((task_id >= GKI_MAX_TASKS) || (mbox >= NUM_TASK_MBOX))
         return (NULL);
 
+#if (GKI_BATCH_MBOX_READ == TRUE)
+    /* Only the owner task touches its batch, so it needs no protection. An
+    ** unlocked peek at the mailbox is enough to skip the lock when it is empty;
+    ** a message racing in is seen on the next read after GKI_wait().
+    */
+    if ((gki_cb.com.OSTaskQBatch[task_id][mbox] == NULL) && (gki_cb.com.OSTaskQFirst[task_id][mbox] != NULL))
+    {
+        GKI_disable();
+
+        gki_cb.com.OSTaskQBatch[task_id][mbox] = gki_cb.com.OSTaskQFirst[task_id][mbox];
+        gki_cb.com.OSTaskQFirst[task_id][mbox] = NULL;
+
+        GKI_enable();
+    }
+
+    if ((p_hdr = gki_cb.com.OSTaskQBatch[task_id][mbox]) != NULL)
+    {
+        gki_cb.com.OSTaskQBatch[task_id][mbox] = p_hdr->p_next;
+
+        p_hdr->p_next = NULL;
+        p_hdr->status = BUF_STATUS_UNLINKED;
+
+        p_buf = (UINT8 *)p_hdr + BUFFER_HDR_SIZE;
+    }
+#else
     GKI_disable();
 
     if (gki_cb.com.OSTaskQFirst[task_id][mbox])
@@ -763,6 +1191,7 @@ void *GKI_read_mbox (UINT8 mbox)
     }
 
     GKI_enable();
+#endif
 
     return (p_buf);
 }
@@ -1127,6 +1556,8 @@ UINT8 GKI_set_pool_permission(UINT8 pool_id, UINT8 permission)
         else    /* mark the pool as public */
             p_cb->pool_access_mask = (UINT16)(p_cb->pool_access_mask & ~(1 << pool_id));
 
+        gki_build_size_class_table();
+
         return (GKI_SUCCESS);
     }
     else
@@ -1164,6 +1595,9 @@ static void gki_add_to_pool_list(UINT8 pool_id)
     }
 
     p_cb->pool_list[i] = pool_id;
+    p_cb->curr_total_no_of_pools++;
+
+    gki_build_size_class_table();
 
     return;
 }
@@ -1193,6 +1627,9 @@ static void gki_remove_from_pool_list(UINT8 pool_id)
         p_cb->pool_list[i] = p_cb->pool_list[i+1];
         i++;
     }
+    p_cb->curr_total_no_of_pools--;
+
+    gki_build_size_class_table();
 
     return;
 }
@@ -1211,13 +1648,27 @@ static void gki_remove_from_pool_list(UINT8 pool_id)
 *******************************************************************************/
 void *GKI_igetpoolbuf (UINT8 pool_id)
 {
+#if (GKI_USE_LOCKFREE_BUF_POOLS != TRUE)
     FREE_QUEUE_T  *Q;
+#endif
     BUFFER_HDR_T  *p_hdr;
 
     if (pool_id >= GKI_NUM_TOTAL_BUF_POOLS)
         return (NULL);
 
 
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    if ((p_hdr = gki_lf_getbuf (pool_id, GKI_INVALID_TASK)) != NULL)
+    {
+        p_hdr->task_id = GKI_get_taskid();
+
+        p_hdr->status  = BUF_STATUS_UNLINKED;
+        p_hdr->p_next  = NULL;
+        p_hdr->Type    = 0;
+
+        return ((void *) ((UINT8 *)p_hdr + BUFFER_HDR_SIZE));
+    }
+#else
     Q = &gki_cb.com.freeq[pool_id];
     if(Q->cur_cnt < Q->total)
     {
@@ -1238,6 +1689,7 @@ void *GKI_igetpoolbuf (UINT8 pool_id)
 
         return ((void *) ((UINT8 *)p_hdr + BUFFER_HDR_SIZE));
     }
+#endif
 
     return (NULL);
 }
@@ -1423,7 +1875,6 @@ UINT8 GKI_create_pool (UINT16 size, UINT16 count, UINT8 permission, void *p_mem_
         gki_init_free_queue (xx, size, count, p_mem_pool);
         gki_add_to_pool_list(xx);
         (void) GKI_set_pool_permission (xx, permission);
-        p_cb->curr_total_no_of_pools++;
 
         return (xx);
     }
@@ -1463,6 +1914,9 @@ void GKI_delete_pool (UINT8 pool_id)
         Q->max_cnt   = 0;
         Q->p_first   = NULL;
         Q->p_last    = NULL;
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+        Q->lf_head   = GKI_LF_HEAD (GKI_LF_NONE, 0);
+#endif
 
         GKI_os_free (p_cb->pool_start[pool_id]);
 
@@ -1471,7 +1925,6 @@ void GKI_delete_pool (UINT8 pool_id)
         p_cb->pool_size[pool_id]  = 0;
 
         gki_remove_from_pool_list(pool_id);
-        p_cb->curr_total_no_of_pools--;
     }
     else
         GKI_exception(GKI_ERROR_DELETE_POOL_BAD_QID, "Deleting bad pool");
@@ -16,6 +16,7 @@
  *
  ******************************************************************************/
 #include "gki_int.h"
+#include <string.h>
 
 #ifndef BT_ERROR_TRACE_0
 #define BT_ERROR_TRACE_0(l,m)
@@ -147,7 +148,12 @@ BOOLEAN gki_timers_is_timer_running(void)
 *******************************************************************************/
 UINT32  GKI_get_tick_count(void)
 {
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+    /* The timer thread only accounts ticks when it wakes up, so read the clock */
+    return (gki_timer_get_ticks ());
+#else
     return gki_cb.com.OSTicks;
+#endif
 }
 
 
@@ -212,6 +218,12 @@ void GKI_start_timer (UINT8 tnum, INT32 ticks, BOOLEAN is_continuous)
     else
         reload = 0;
 
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+    /* Account for the ticks since the timer thread last woke up, so that the
+    ** new timer counts from now. Must be done before GKI_disable(). */
+    gki_timer_catch_up ();
+#endif
+
     GKI_disable();
 
     if(gki_timers_is_timer_running() == FALSE)
@@ -352,6 +364,9 @@ void GKI_stop_timer (UINT8 tnum)
                 /* set inactivity delay timer */
                 /* when timer expires, system tick will be stopped */
                 gki_cb.com.OSTicksTilStop = GKI_DELAY_STOP_SYS_TICK;
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+                gki_timer_rearm ();
+#endif
             }
 #else
             gki_cb.com.system_tick_running = FALSE;
@@ -628,6 +643,14 @@ void GKI_init_timer_list (TIMER_LIST_Q *p_timer_listq)
     p_timer_listq->p_first    = NULL;
     p_timer_listq->p_last     = NULL;
     p_timer_listq->last_ticks = 0;
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+    p_timer_listq->p_last_expired = NULL;
+    p_timer_listq->now            = 0;
+    p_timer_listq->num_expired    = 0;
+    p_timer_listq->num_pending    = 0;
+    memset (p_timer_listq->wheel, 0, sizeof (p_timer_listq->wheel));
+    memset (p_timer_listq->slot_map, 0, sizeof (p_timer_listq->slot_map));
+#endif
 
     return;
 }
@@ -651,8 +674,516 @@ void GKI_init_timer_list_entry (TIMER_LIST_ENT  *p_tle)
     p_tle->p_prev  = NULL;
     p_tle->ticks   = GKI_UNUSED_LIST_ENTRY;
     p_tle->in_use  = FALSE;
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+    p_tle->p_slot_next  = NULL;
+    p_tle->pp_slot_prev = NULL;
+    p_tle->expiry       = 0;
+#endif
 }
 
+/*******************************************************************************
+**
+** Function         gki_register_timer_queue
+**
+** Description      Adds a timer list queue to the array of active queues, if
+**                  it is not there yet
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_register_timer_queue (TIMER_LIST_Q *p_timer_listq)
+{
+    UINT8 tt;
+
+    /* if we already add this timer queue to the array */
+    for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
+    {
+         if (gki_cb.com.timer_queues[tt] == p_timer_listq)
+             return;
+    }
+    /* add this timer queue to the array */
+    for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
+    {
+         if (gki_cb.com.timer_queues[tt] == NULL)
+             break;
+    }
+    if (tt < GKI_MAX_TIMER_QUEUES)
+    {
+        gki_cb.com.timer_queues[tt] = p_timer_listq;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         gki_deregister_timer_queue
+**
+** Description      Removes an empty timer list queue from the array of active
+**                  queues
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_deregister_timer_queue (TIMER_LIST_Q *p_timer_listq)
+{
+    UINT8 tt;
+
+    for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
+    {
+        if (gki_cb.com.timer_queues[tt] == p_timer_listq)
+        {
+            gki_cb.com.timer_queues[tt] = NULL;
+            break;
+        }
+    }
+}
+
+#if (GKI_USE_TIMER_WHEEL == TRUE)
+
+#define GKI_TIMER_WHEEL_MASK            (GKI_TIMER_WHEEL_SLOTS - 1)
+#define GKI_TIMER_WHEEL_SLOT(t, level)  (((t) >> (GKI_TIMER_WHEEL_BITS * (level))) & GKI_TIMER_WHEEL_MASK)
+
+/* Bits of slot_map are set on insert and cleared only when the slot is emptied
+** by GKI_update_timer_list, so a stopped timer may leave a bit set. That costs
+** one stop at an empty slot, never a missed one. */
+#define GKI_TIMER_WHEEL_MAP_SET(map, slot)  ((map)[(slot) >> 5] |= ((UINT32) 1 << ((slot) & 31)))
+#define GKI_TIMER_WHEEL_MAP_CLR(map, slot)  ((map)[(slot) >> 5] &= ~((UINT32) 1 << ((slot) & 31)))
+
+/*******************************************************************************
+**
+** Function         gki_timer_wheel_insert
+**
+** Description      Links a pending entry into the wheel slot of its expiry.
+**                  Level N holds the entries expiring within
+**                  (1 << (GKI_TIMER_WHEEL_BITS * (N + 1))) units.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_wheel_insert (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT *p_tle)
+{
+    UINT32          delta  = p_tle->expiry - p_timer_listq->now;
+    UINT32          expiry = p_tle->expiry;
+    UINT8           level;
+    TIMER_LIST_ENT  **pp_slot;
+
+    /* Only happens when an entry comes down the wheel in its last unit */
+    if ((INT32) delta < 0)
+    {
+        delta  = 0;
+        expiry = p_timer_listq->now;
+    }
+
+    for (level = 0; level < GKI_TIMER_WHEEL_LEVELS - 1; level++)
+    {
+        if (delta < ((UINT32) 1 << (GKI_TIMER_WHEEL_BITS * (level + 1))))
+            break;
+    }
+
+#if (GKI_TIMER_WHEEL_BITS * GKI_TIMER_WHEEL_LEVELS < 32)
+    /* Too far out: wait in the last slot of the last level and come back later */
+    if (delta >= ((UINT32) 1 << (GKI_TIMER_WHEEL_BITS * GKI_TIMER_WHEEL_LEVELS)))
+        expiry = p_timer_listq->now + ((UINT32) 1 << (GKI_TIMER_WHEEL_BITS * GKI_TIMER_WHEEL_LEVELS)) - 1;
+#endif
+
+    pp_slot = &p_timer_listq->wheel[level][GKI_TIMER_WHEEL_SLOT (expiry, level)];
+    GKI_TIMER_WHEEL_MAP_SET (p_timer_listq->slot_map[level], GKI_TIMER_WHEEL_SLOT (expiry, level));
+
+    p_tle->p_slot_next  = *pp_slot;
+    p_tle->pp_slot_prev = pp_slot;
+    if (*pp_slot)
+        (*pp_slot)->pp_slot_prev = &p_tle->p_slot_next;
+    *pp_slot = p_tle;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_wheel_unlink
+**
+** Description      Unlinks a pending entry from its wheel slot
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_wheel_unlink (TIMER_LIST_ENT *p_tle)
+{
+    *p_tle->pp_slot_prev = p_tle->p_slot_next;
+    if (p_tle->p_slot_next)
+        p_tle->p_slot_next->pp_slot_prev = p_tle->pp_slot_prev;
+
+    p_tle->p_slot_next  = NULL;
+    p_tle->pp_slot_prev = NULL;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_unlink
+**
+** Description      Unlinks an entry from the p_first list of a timer list queue
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_unlink (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT *p_tle)
+{
+    if (p_timer_listq->p_last_expired == p_tle)
+        p_timer_listq->p_last_expired = p_tle->p_prev;
+
+    if (p_tle->p_prev)
+        p_tle->p_prev->p_next = p_tle->p_next;
+    else
+        p_timer_listq->p_first = p_tle->p_next;
+
+    if (p_tle->p_next)
+        p_tle->p_next->p_prev = p_tle->p_prev;
+    else
+        p_timer_listq->p_last = p_tle->p_prev;
+
+    p_tle->p_next = p_tle->p_prev = NULL;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_append
+**
+** Description      Adds an entry to the end of the p_first list of a timer
+**                  list queue
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_append (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT *p_tle)
+{
+    p_tle->p_next = NULL;
+    p_tle->p_prev = p_timer_listq->p_last;
+
+    if (p_timer_listq->p_last)
+        p_timer_listq->p_last->p_next = p_tle;
+    else
+        p_timer_listq->p_first = p_tle;
+
+    p_timer_listq->p_last = p_tle;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_list_expire
+**
+** Description      Marks an entry as expired and moves it behind the other
+**                  expired entries at the front of the p_first list
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_list_expire (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT *p_tle)
+{
+    TIMER_LIST_ENT  *p_prev;
+
+    gki_timer_list_unlink (p_timer_listq, p_tle);
+
+    p_prev = p_timer_listq->p_last_expired;
+
+    p_tle->p_prev = p_prev;
+    if (p_prev)
+    {
+        p_tle->p_next  = p_prev->p_next;
+        p_prev->p_next = p_tle;
+    }
+    else
+    {
+        p_tle->p_next          = p_timer_listq->p_first;
+        p_timer_listq->p_first = p_tle;
+    }
+
+    if (p_tle->p_next)
+        p_tle->p_next->p_prev = p_tle;
+    else
+        p_timer_listq->p_last = p_tle;
+
+    /* We set the number of ticks to '0' so that the legacy code
+     * that assumes a '0' or nonzero value will still work as coded. */
+    p_tle->ticks = 0;
+
+    p_timer_listq->p_last_expired = p_tle;
+    p_timer_listq->num_expired++;
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_wheel_scan
+**
+** Description      Finds the first slot of a level which may have entries,
+**                  going round from slot start.
+**
+** Returns          number of slots from start to that slot, or
+**                  GKI_TIMER_WHEEL_SLOTS if the level is empty
+**
+*******************************************************************************/
+static UINT16 gki_timer_wheel_scan (UINT32 *p_map, UINT16 start)
+{
+    UINT16 steps = 0;
+    UINT16 slot, num_bits;
+    UINT32 bits;
+
+    while (steps < GKI_TIMER_WHEEL_SLOTS)
+    {
+        slot = (start + steps) & GKI_TIMER_WHEEL_MASK;
+        bits = p_map[slot >> 5] >> (slot & 31);
+
+        if (bits)
+            return (steps + __builtin_ctz (bits));
+
+        /* rest of this word, up to the end of the level */
+        num_bits = 32 - (slot & 31);
+        if (num_bits > GKI_TIMER_WHEEL_SLOTS - slot)
+            num_bits = GKI_TIMER_WHEEL_SLOTS - slot;
+        steps += num_bits;
+    }
+
+    return (GKI_TIMER_WHEEL_SLOTS);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_wheel_next
+**
+** Description      Gets the number of units until the wheel turns to a slot
+**                  which has entries to expire or to move down a level.
+**
+** Returns          number of units, 0xFFFFFFFF if the wheel is empty
+**
+*******************************************************************************/
+static UINT32 gki_timer_wheel_next (TIMER_LIST_Q *p_timer_listq)
+{
+    UINT32 now  = p_timer_listq->now;
+    UINT32 next = 0xFFFFFFFF;
+    UINT32 units;
+    UINT16 steps;
+    UINT8  level;
+
+    for (level = 0; level < GKI_TIMER_WHEEL_LEVELS; level++)
+    {
+        steps = gki_timer_wheel_scan (p_timer_listq->slot_map[level],
+                                      (GKI_TIMER_WHEEL_SLOT (now, level) + 1) & GKI_TIMER_WHEEL_MASK);
+        if (steps == GKI_TIMER_WHEEL_SLOTS)
+            continue;
+
+        /* slot of a level is reached when all the levels below come round */
+        units = (((UINT32) steps + 1) << (GKI_TIMER_WHEEL_BITS * level))
+                - (now & (((UINT32) 1 << (GKI_TIMER_WHEEL_BITS * level)) - 1));
+        if (units < next)
+            next = units;
+    }
+
+    return (next);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_update_timer_list
+**
+** Description      This function is called by the applications when they
+**                  want to update a timer list. This should be at every
+**                  timer list unit tick, e.g. once per sec, once per minute etc.
+**
+**                  The wheel is turned straight to the next slot which has
+**                  entries, so the cost does not depend on the number of units.
+**                  Entries of a higher level are moved down when the level
+**                  below has come round.
+**
+** Parameters       p_timer_listq   - (input) pointer to the timer list queue object
+**                  num_units_since_last_update - (input) number of units since the last update
+**                                  (allows for variable unit update)
+**
+**      NOTE: The following timer list update routines should not be used for exact time
+**            critical purposes.  The timer tasks should be used when exact timing is needed.
+**
+** Returns          the number of timers that have expired
+**
+*******************************************************************************/
+UINT16 GKI_update_timer_list (TIMER_LIST_Q *p_timer_listq, INT32 num_units_since_last_update)
+{
+    TIMER_LIST_ENT  *p_tle;
+    TIMER_LIST_ENT  *p_next;
+    UINT16          num_time_out = 0;
+    UINT32          units;
+    UINT16          slot;
+    UINT8           level;
+
+    while ((num_units_since_last_update > 0) && (p_timer_listq->num_pending > 0))
+    {
+        units = gki_timer_wheel_next (p_timer_listq);
+        if (units > (UINT32) num_units_since_last_update)
+            break;
+
+        p_timer_listq->now += units;
+        num_units_since_last_update -= units;
+
+        /* Move the entries of the next level down each time a level has come round */
+        for (level = 1;
+             (level < GKI_TIMER_WHEEL_LEVELS) && (GKI_TIMER_WHEEL_SLOT (p_timer_listq->now, level - 1) == 0);
+             level++)
+        {
+            slot  = GKI_TIMER_WHEEL_SLOT (p_timer_listq->now, level);
+            p_tle = p_timer_listq->wheel[level][slot];
+            p_timer_listq->wheel[level][slot] = NULL;
+            GKI_TIMER_WHEEL_MAP_CLR (p_timer_listq->slot_map[level], slot);
+
+            while (p_tle)
+            {
+                p_next = p_tle->p_slot_next;
+                gki_timer_wheel_insert (p_timer_listq, p_tle);
+                p_tle = p_next;
+            }
+        }
+
+        /* Expire the whole slot */
+        slot  = GKI_TIMER_WHEEL_SLOT (p_timer_listq->now, 0);
+        p_tle = p_timer_listq->wheel[0][slot];
+        p_timer_listq->wheel[0][slot] = NULL;
+        GKI_TIMER_WHEEL_MAP_CLR (p_timer_listq->slot_map[0], slot);
+
+        while (p_tle)
+        {
+            p_next = p_tle->p_slot_next;
+            p_tle->p_slot_next  = NULL;
+            p_tle->pp_slot_prev = NULL;
+
+            p_timer_listq->num_pending--;
+            gki_timer_list_expire (p_timer_listq, p_tle);
+            num_time_out++;
+            p_tle = p_next;
+        }
+    }
+
+    /* No slot to visit in the remaining units */
+    p_timer_listq->now += num_units_since_last_update;
+
+    return (num_time_out);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_get_remaining_ticks
+**
+** Description      This function is called by an application to get remaining
+**                  ticks to expire
+**
+** Parameters       p_timer_listq   - (input) pointer to the timer list queue object
+**                  p_target_tle    - (input) pointer to a timer list queue entry
+**
+** Returns          0 if timer is not used or timer is not in the list
+**                  remaining ticks if success
+**
+*******************************************************************************/
+UINT32 GKI_get_remaining_ticks (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_target_tle)
+{
+    if (!p_target_tle->in_use)
+    {
+        BT_ERROR_TRACE_0(TRACE_LAYER_GKI, "GKI_get_remaining_ticks: timer entry is not active");
+        return (0);
+    }
+
+    /* expired */
+    if (p_target_tle->ticks == 0)
+        return (0);
+
+    return (p_target_tle->expiry - p_timer_listq->now);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_add_to_timer_list
+**
+** Description      This function is called by an application to add a timer
+**                  entry to a timer list.
+**
+**                  Note: A timer value of '0' will effectively insert an already
+**                      expired event.  Negative tick values will be ignored.
+**
+** Parameters       p_timer_listq   - (input) pointer to the timer list queue object
+**                  p_tle           - (input) pointer to a timer list queue entry
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_add_to_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
+{
+    if (p_tle == NULL || p_timer_listq == NULL) {
+        GKI_TRACE_3("%s: invalid argument %x, %x****************************<<", __func__, p_timer_listq, p_tle);
+        return;
+    }
+
+    /* Only process valid tick values */
+    if (p_tle->ticks >= 0)
+    {
+        gki_timer_list_append (p_timer_listq, p_tle);
+
+        if (p_tle->ticks == 0)
+        {
+            gki_timer_list_expire (p_timer_listq, p_tle);
+        }
+        else
+        {
+            p_tle->expiry = p_timer_listq->now + p_tle->ticks;
+            gki_timer_wheel_insert (p_timer_listq, p_tle);
+            p_timer_listq->num_pending++;
+        }
+
+        p_tle->in_use = TRUE;
+
+        gki_register_timer_queue (p_timer_listq);
+    }
+
+    return;
+}
+
+/*******************************************************************************
+**
+** Function         GKI_remove_from_timer_list
+**
+** Description      This function is called by an application to remove a timer
+**                  entry from a timer list.
+**
+** Parameters       p_timer_listq   - (input) pointer to the timer list queue object
+**                  p_tle           - (input) pointer to a timer list queue entry
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_remove_from_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
+{
+    /* Verify that the entry is valid */
+    if (p_tle == NULL || p_tle->in_use == FALSE || p_timer_listq->p_first == NULL)
+    {
+        return;
+    }
+
+    gki_timer_list_unlink (p_timer_listq, p_tle);
+
+    if (p_tle->ticks == 0)
+    {
+        p_timer_listq->num_expired--;
+    }
+    else
+    {
+        gki_timer_wheel_unlink (p_tle);
+        p_timer_listq->num_pending--;
+    }
+
+    p_tle->ticks = GKI_UNUSED_LIST_ENTRY;
+    p_tle->in_use = FALSE;
+
+    /* if timer queue is empty */
+    if (p_timer_listq->p_first == NULL)
+    {
+        gki_deregister_timer_queue (p_timer_listq);
+    }
+
+    return;
+}
+
+#else /* GKI_USE_TIMER_WHEEL */
+
 
 /*******************************************************************************
 **
@@ -794,7 +1325,6 @@ UINT32 GKI_get_remaining_ticks (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_
 void GKI_add_to_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
 {
     UINT32           nr_ticks_total;
-    UINT8 tt;
     TIMER_LIST_ENT  *p_temp;
     if (p_tle == NULL || p_timer_listq == NULL) {
         GKI_TRACE_3("%s: invalid argument %x, %x****************************<<", __func__, p_timer_listq, p_tle);
@@ -859,22 +1389,7 @@ void GKI_add_to_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
 
         p_tle->in_use = TRUE;
 
-        /* if we already add this timer queue to the array */
-        for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
-        {
-             if (gki_cb.com.timer_queues[tt] == p_timer_listq)
-                 return;
-        }
-        /* add this timer queue to the array */
-        for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
-        {
-             if (gki_cb.com.timer_queues[tt] == NULL)
-                 break;
-        }
-        if (tt < GKI_MAX_TIMER_QUEUES)
-        {
-            gki_cb.com.timer_queues[tt] = p_timer_listq;
-        }
+        gki_register_timer_queue (p_timer_listq);
     }
 
     return;
@@ -896,8 +1411,6 @@ void GKI_add_to_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
 *******************************************************************************/
 void GKI_remove_from_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p_tle)
 {
-    UINT8 tt;
-
     /* Verify that the entry is valid */
     if (p_tle == NULL || p_tle->in_use == FALSE || p_timer_listq->p_first == NULL)
     {
@@ -964,19 +1477,14 @@ void GKI_remove_from_timer_list (TIMER_LIST_Q *p_timer_listq, TIMER_LIST_ENT  *p
     /* if timer queue is empty */
     if (p_timer_listq->p_first == NULL && p_timer_listq->p_last == NULL)
     {
-        for (tt = 0; tt < GKI_MAX_TIMER_QUEUES; tt++)
-        {
-            if (gki_cb.com.timer_queues[tt] == p_timer_listq)
-            {
-                gki_cb.com.timer_queues[tt] = NULL;
-                break;
-            }
-        }
+        gki_deregister_timer_queue (p_timer_listq);
     }
 
     return;
 }
 
+#endif /* GKI_USE_TIMER_WHEEL */
+
 
 /*******************************************************************************
 **
@@ -1004,6 +1512,10 @@ void gki_adjust_timer_count (INT32 ticks)
         {
             gki_cb.com.OSNumOrigTicks = (gki_cb.com.OSNumOrigTicks - gki_cb.com.OSTicksTilExp) + ticks;
             gki_cb.com.OSTicksTilExp = ticks;
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+            /* wake the timer thread up earlier */
+            gki_timer_rearm ();
+#endif
         }
     }
 
@@ -28,6 +28,18 @@
 #include <sys/times.h>
 #endif
 
+/* TRUE to wake tasks up through a per task eventfd polled with epoll instead of
+** the task condition variable. Tasks can then also wait on other file
+** descriptors (e.g. a transport) registered with GKI_add_wait_fd() */
+#ifndef GKI_USE_EVENTFD_WAKEUP
+#define GKI_USE_EVENTFD_WAKEUP  FALSE
+#endif
+
+/* Max number of ready file descriptors handled by one wait of a task */
+#ifndef GKI_MAX_WAIT_FDS
+#define GKI_MAX_WAIT_FDS        4
+#endif
+
 typedef struct
 {
     pthread_mutex_t     GKI_mutex;
@@ -36,10 +48,17 @@ typedef struct
     pthread_cond_t      thread_evt_cond[GKI_MAX_TASKS];
     pthread_mutex_t     thread_timeout_mutex[GKI_MAX_TASKS];
     pthread_cond_t      thread_timeout_cond[GKI_MAX_TASKS];
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    int                 thread_evt_fd[GKI_MAX_TASKS];   /* eventfd written to wake the task up, -1 if none */
+    int                 thread_epoll_fd[GKI_MAX_TASKS]; /* epoll set the task waits on, -1 if none */
+#endif
     int                 no_timer_suspend;   /* 1: no suspend, 0 stop calling GKI_timer_update() */
     pthread_mutex_t     gki_timer_mutex;
     pthread_cond_t      gki_timer_cond;
     int                 gki_timer_wake_lock_on;
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+    UINT64              timer_base_ns;      /* monotonic time of the last tick accounted by the timer thread */
+#endif
 #if (GKI_DEBUG == TRUE)
     pthread_mutex_t     GKI_trace_mutex;
 #endif
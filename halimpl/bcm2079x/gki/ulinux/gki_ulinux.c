@@ -26,6 +26,11 @@
 #include <hardware_legacy/power.h>  /* Android header */
 #include "gki_int.h"
 #include "gki_target.h"
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 /* Temp android logging...move to android tgt config file */
 
@@ -62,6 +67,15 @@ tGKI_CB   gki_cb;
 #define UNLOCK(m) pthread_mutex_unlock(&m)
 #define INIT(m) pthread_mutex_init(&m, NULL)
 
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+static UINT64 gki_timer_now_ns (void);
+#endif
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+static void gki_open_wait_fds (UINT8 task_id);
+static void gki_close_wait_fds (UINT8 task_id);
+static void gki_wait_fds (UINT8 task_id, UINT32 timeout);
+#endif
+
 
 /* this kind of mutex go into tGKI_OS control block!!!! */
 /* static pthread_mutex_t GKI_sched_mutex; */
@@ -153,6 +167,10 @@ void GKI_init(void)
     tGKI_OS             *p_os;
 
     memset (&gki_cb, 0, sizeof (gki_cb));
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    memset (gki_cb.os.thread_evt_fd, 0xFF, sizeof (gki_cb.os.thread_evt_fd));
+    memset (gki_cb.os.thread_epoll_fd, 0xFF, sizeof (gki_cb.os.thread_epoll_fd));
+#endif
 
     gki_buffer_init();
     gki_timers_init();
@@ -177,6 +195,9 @@ void GKI_init(void)
     p_os->no_timer_suspend = GKI_TIMER_TICK_RUN_COND;
     pthread_mutex_init(&p_os->gki_timer_mutex, NULL);
     pthread_cond_init(&p_os->gki_timer_cond, NULL);
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+    p_os->timer_base_ns = gki_timer_now_ns ();
+#endif
 }
 
 
@@ -243,6 +264,9 @@ UINT8 GKI_create_task (TASKPTR task_entry, UINT8 task_id, INT8 *taskname, UINT16
     pthread_cond_init (&gki_cb.os.thread_evt_cond[task_id], NULL);
     pthread_mutex_init(&gki_cb.os.thread_timeout_mutex[task_id], NULL);
     pthread_cond_init (&gki_cb.os.thread_timeout_cond[task_id], NULL);
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    gki_open_wait_fds (task_id);
+#endif
 
     pthread_attr_init(&attr1);
     /* by default, pthread creates a joinable thread */
@@ -382,6 +406,10 @@ void GKI_shutdown(void)
     *p_run_cond = GKI_TIMER_TICK_EXIT_COND;
     if (oldCOnd == GKI_TIMER_TICK_STOP_COND)
         pthread_cond_signal( &gki_cb.os.gki_timer_cond );
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+    else
+        gki_timer_rearm ();     /* timer thread may be waiting for the next expiration */
+#endif
 
 }
 
@@ -420,8 +448,12 @@ void gki_system_tick_start_stop_cback(BOOLEAN start)
         /* restart GKI_timer_update() loop */
         acquire_wake_lock(PARTIAL_WAKE_LOCK, WAKE_LOCK_ID);
         gki_cb.os.gki_timer_wake_lock_on = 1;
-        *p_run_cond = GKI_TIMER_TICK_RUN_COND;
         pthread_mutex_lock( &p_os->gki_timer_mutex );
+        *p_run_cond = GKI_TIMER_TICK_RUN_COND;
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+        /* ticks count from now, not from when the tick was stopped */
+        p_os->timer_base_ns = gki_timer_now_ns ();
+#endif
         pthread_cond_signal( &p_os->gki_timer_cond );
         pthread_mutex_unlock( &p_os->gki_timer_mutex );
 
@@ -432,6 +464,166 @@ void gki_system_tick_start_stop_cback(BOOLEAN start)
 }
 
 
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+#define GKI_TICK_NS     ((UINT64) LINUX_SEC * NANOSEC_PER_MILLISEC)
+
+/*******************************************************************************
+**
+** Function         gki_timer_now_ns
+**
+** Description      Monotonic time for the tickless timer thread
+**
+** Returns          time in nanoseconds
+**
+*******************************************************************************/
+static UINT64 gki_timer_now_ns (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((UINT64) ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_elapsed_ticks
+**
+** Description      Counts the whole ticks since the last accounted tick and
+**                  accounts them. Time while the system tick is stopped is not
+**                  counted. Called with gki_timer_mutex held.
+**
+** Returns          number of ticks
+**
+*******************************************************************************/
+static UINT32 gki_timer_elapsed_ticks (void)
+{
+    UINT64  now = gki_timer_now_ns ();
+    UINT32  ticks = 0;
+
+    if (gki_cb.os.no_timer_suspend != GKI_TIMER_TICK_RUN_COND)
+    {
+        gki_cb.os.timer_base_ns = now;
+    }
+    else if (now > gki_cb.os.timer_base_ns)
+    {
+        ticks = (UINT32) ((now - gki_cb.os.timer_base_ns) / GKI_TICK_NS);
+        gki_cb.os.timer_base_ns += (UINT64) ticks * GKI_TICK_NS;
+    }
+
+    return (ticks);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_catch_up
+**
+** Description      Runs GKI_timer_update() for the ticks elapsed since the
+**                  timer thread last woke up. Must not be called with
+**                  GKI_disable() held.
+**
+** Returns          void
+**
+*******************************************************************************/
+void gki_timer_catch_up (void)
+{
+    UINT32  ticks;
+
+    pthread_mutex_lock (&gki_cb.os.gki_timer_mutex);
+    ticks = gki_timer_elapsed_ticks ();
+    pthread_mutex_unlock (&gki_cb.os.gki_timer_mutex);
+
+    if (ticks)
+    {
+        GKI_disable();
+        GKI_timer_update ((INT32) ticks);
+        GKI_enable();
+    }
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_get_ticks
+**
+** Description      Reads the monotonic clock in ticks. Lock free, as the tick
+**                  count accounted by the timer thread lags while it sleeps.
+**
+** Returns          number of ticks
+**
+*******************************************************************************/
+UINT32 gki_timer_get_ticks (void)
+{
+    return ((UINT32) (gki_timer_now_ns () / GKI_TICK_NS));
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_rearm
+**
+** Description      Wakes the timer thread up to recompute its next expiration,
+**                  e.g. when an earlier timer has been started
+**
+** Returns          void
+**
+*******************************************************************************/
+void gki_timer_rearm (void)
+{
+    pthread_mutex_lock (&gki_cb.os.gki_timer_mutex);
+    pthread_cond_signal (&gki_cb.os.gki_timer_cond);
+    pthread_mutex_unlock (&gki_cb.os.gki_timer_mutex);
+}
+
+/*******************************************************************************
+**
+** Function         gki_timer_sleep
+**
+** Description      Sleeps until the next timer expiration or the end of the
+**                  inactivity delay, whichever comes first, or until re-armed.
+**                  Sleeps until re-armed if no timer is running.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_timer_sleep (void)
+{
+    volatile int    *p_run_cond = &gki_cb.os.no_timer_suspend;
+    struct timespec abstime;
+    UINT64          deadline;
+    INT32           ticks;
+
+    pthread_mutex_lock (&gki_cb.os.gki_timer_mutex);
+
+    /* Read under gki_timer_mutex so that a gki_timer_rearm() cannot be missed */
+    ticks = gki_cb.com.OSTicksTilExp;
+#if (defined(GKI_DELAY_STOP_SYS_TICK) && (GKI_DELAY_STOP_SYS_TICK > 0))
+    if ((gki_cb.com.OSTicksTilStop > 0) && ((ticks <= 0) || (gki_cb.com.OSTicksTilStop < (UINT32) ticks)))
+        ticks = (INT32) gki_cb.com.OSTicksTilStop;
+#endif
+
+    if (GKI_TIMER_TICK_RUN_COND == *p_run_cond)
+    {
+        if (ticks == 0)
+        {
+            pthread_cond_wait (&gki_cb.os.gki_timer_cond, &gki_cb.os.gki_timer_mutex);
+        }
+        else
+        {
+            /* Overdue: check again on the next tick */
+            if (ticks < 0)
+                ticks = 1;
+
+            deadline = gki_cb.os.timer_base_ns + (UINT64) ticks * GKI_TICK_NS;
+            abstime.tv_sec  = (time_t) (deadline / NSEC_PER_SEC);
+            abstime.tv_nsec = (long) (deadline % NSEC_PER_SEC);
+
+            pthread_cond_timedwait_monotonic (&gki_cb.os.gki_timer_cond, &gki_cb.os.gki_timer_mutex, &abstime);
+        }
+    }
+
+    pthread_mutex_unlock (&gki_cb.os.gki_timer_mutex);
+}
+#endif
+
+
 /*******************************************************************************
 **
 ** Function         timer_thread
@@ -513,8 +705,10 @@ void GKI_run (void *p_task_id)
 void* GKI_run_worker_thread (void* dummy)
 {
     GKI_TRACE_1("%s: enter", __func__);
+#if (GKI_USE_TICKLESS_TIMER != TRUE)
     struct timespec delay;
     int err = 0;
+#endif
     volatile int * p_run_cond = &gki_cb.os.no_timer_suspend;
 
 #ifndef GKI_NO_TICK_STOP
@@ -546,6 +740,12 @@ void* GKI_run_worker_thread (void* dummy)
     {
         do
         {
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+            /* sleep until the next timer expires or an earlier timer is started, then
+             * update the timers with the number of ticks elapsed meanwhile */
+            gki_timer_sleep ();
+            gki_timer_catch_up ();
+#else
             /* adjust hear bit tick in btld by changning TICKS_PER_SEC!!!!! this formula works only for
              * 1-1000ms heart beat units! */
             delay.tv_sec = LINUX_SEC / 1000;
@@ -562,6 +762,7 @@ void* GKI_run_worker_thread (void* dummy)
              */
             GKI_timer_update( 1 );
             /* BT_TRACE_2( TRACE_LAYER_HCI, TRACE_TYPE_DEBUG, "update: tv_sec: %d, tv_nsec: %d", delay.tv_sec, delay.tv_nsec ); */
+#endif
         } while ( GKI_TIMER_TICK_RUN_COND == *p_run_cond);
 
         /* currently on reason to exit above loop is no_timer_suspend == GKI_TIMER_TICK_STOP_COND
@@ -620,6 +821,114 @@ void GKI_stop (void)
 }
 
 
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+/*******************************************************************************
+**
+** Function         gki_open_wait_fds
+**
+** Description      Create the eventfd and the epoll set a task waits on. On
+**                  failure the task keeps waiting on its condition variable.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_open_wait_fds (UINT8 task_id)
+{
+    struct epoll_event ev;
+    int evt_fd, epoll_fd;
+
+    gki_cb.os.thread_evt_fd[task_id]   = -1;
+    gki_cb.os.thread_epoll_fd[task_id] = -1;
+
+    if ((evt_fd = eventfd (0, EFD_NONBLOCK)) < 0)
+    {
+        GKI_TRACE_2("gki_open_wait_fds: eventfd failed(%d) for task %d", errno, task_id);
+        return;
+    }
+
+    if ((epoll_fd = epoll_create (GKI_MAX_WAIT_FDS + 1)) < 0)
+    {
+        GKI_TRACE_2("gki_open_wait_fds: epoll_create failed(%d) for task %d", errno, task_id);
+        close (evt_fd);
+        return;
+    }
+
+    /* event 0 marks the wakeup eventfd, the event bits are already in OSWaitEvt */
+    memset (&ev, 0, sizeof (ev));
+    ev.events   = EPOLLIN;
+    ev.data.u32 = 0;
+    if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, evt_fd, &ev) < 0)
+    {
+        GKI_TRACE_2("gki_open_wait_fds: epoll_ctl failed(%d) for task %d", errno, task_id);
+        close (epoll_fd);
+        close (evt_fd);
+        return;
+    }
+
+    gki_cb.os.thread_evt_fd[task_id]   = evt_fd;
+    gki_cb.os.thread_epoll_fd[task_id] = epoll_fd;
+}
+
+/*******************************************************************************
+**
+** Function         gki_close_wait_fds
+**
+** Description      Close the eventfd and the epoll set of a task.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_close_wait_fds (UINT8 task_id)
+{
+    if (gki_cb.os.thread_epoll_fd[task_id] >= 0)
+        close (gki_cb.os.thread_epoll_fd[task_id]);
+    if (gki_cb.os.thread_evt_fd[task_id] >= 0)
+        close (gki_cb.os.thread_evt_fd[task_id]);
+
+    gki_cb.os.thread_evt_fd[task_id]   = -1;
+    gki_cb.os.thread_epoll_fd[task_id] = -1;
+}
+
+/*******************************************************************************
+**
+** Function         gki_wait_fds
+**
+** Description      Block the task on its epoll set until it is woken up, one
+**                  of its registered fds becomes readable or the timeout (in
+**                  milliseconds, 0 for infinite) expires. Must be called with
+**                  thread_evt_mutex held; it is released while blocked.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void gki_wait_fds (UINT8 task_id, UINT32 timeout)
+{
+    struct epoll_event events[GKI_MAX_WAIT_FDS + 1];
+    UINT64  count;
+    UINT16  evt = 0;
+    int     n, i;
+
+    pthread_mutex_unlock (&gki_cb.os.thread_evt_mutex[task_id]);
+
+    /* EINTR is handled like a spurious wakeup of pthread_cond_wait() */
+    n = epoll_wait (gki_cb.os.thread_epoll_fd[task_id], events, GKI_MAX_WAIT_FDS + 1,
+                    (timeout) ? (int) timeout : -1);
+
+    for (i = 0; i < n; i++)
+    {
+        if (events[i].data.u32 == 0)
+            read (gki_cb.os.thread_evt_fd[task_id], &count, sizeof (count));
+        else
+            evt |= (UINT16) events[i].data.u32;
+    }
+
+    pthread_mutex_lock (&gki_cb.os.thread_evt_mutex[task_id]);
+
+    gki_cb.com.OSWaitEvt[task_id] |= evt;
+}
+#endif
+
+
 /*******************************************************************************
 **
 ** Function         GKI_wait
@@ -682,6 +991,13 @@ UINT16 GKI_wait (UINT16 flag, UINT32 timeout)
 
     if (!(gki_cb.com.OSWaitEvt[rtask] & flag))
     {
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+        if (gki_cb.os.thread_epoll_fd[rtask] >= 0)
+        {
+            gki_wait_fds (rtask, timeout);
+        }
+        else
+#endif
         if (timeout)
         {
             //            timeout = GKI_MS_TO_TICKS(timeout);     /* convert from milliseconds to ticks */
@@ -717,13 +1033,13 @@ UINT16 GKI_wait (UINT16 flag, UINT32 timeout)
          should NOT be lost! */
         // we are waking up after waiting for some events, so refresh variables
         // no need to call GKI_disable() here as we know that we will have some events as we've been waking up after condition pending or timeout
-        if (gki_cb.com.OSTaskQFirst[rtask][0])
+        if (GKI_MBOX_NOT_EMPTY(rtask, 0))
             gki_cb.com.OSWaitEvt[rtask] |= TASK_MBOX_0_EVT_MASK;
-        if (gki_cb.com.OSTaskQFirst[rtask][1])
+        if (GKI_MBOX_NOT_EMPTY(rtask, 1))
             gki_cb.com.OSWaitEvt[rtask] |= TASK_MBOX_1_EVT_MASK;
-        if (gki_cb.com.OSTaskQFirst[rtask][2])
+        if (GKI_MBOX_NOT_EMPTY(rtask, 2))
             gki_cb.com.OSWaitEvt[rtask] |= TASK_MBOX_2_EVT_MASK;
-        if (gki_cb.com.OSTaskQFirst[rtask][3])
+        if (GKI_MBOX_NOT_EMPTY(rtask, 3))
             gki_cb.com.OSWaitEvt[rtask] |= TASK_MBOX_3_EVT_MASK;
 
         if (gki_cb.com.OSRdyTbl[rtask] == TASK_DEAD)
@@ -817,6 +1133,8 @@ void GKI_delay (UINT32 timeout)
 *******************************************************************************/
 UINT8 GKI_send_event (UINT8 task_id, UINT16 event)
 {
+    UINT16 new_evt;
+
     GKI_TRACE_2("GKI_send_event %d %x", task_id, event);
 
     /* use efficient coding to avoid pipeline stalls */
@@ -825,10 +1143,27 @@ UINT8 GKI_send_event (UINT8 task_id, UINT16 event)
         /* protect OSWaitEvt[task_id] from manipulation in GKI_wait() */
         pthread_mutex_lock(&gki_cb.os.thread_evt_mutex[task_id]);
 
+        /* Only the bits that were not pending yet can change what the task waits for */
+        new_evt = event & ~gki_cb.com.OSWaitEvt[task_id];
+
         /* Set the event bit */
         gki_cb.com.OSWaitEvt[task_id] |= event;
 
-        pthread_cond_signal(&gki_cb.os.thread_evt_cond[task_id]);
+        /* Wake the task up only if it is blocked on one of the new bits. A
+        ** running task finds them in OSWaitEvt on its next GKI_wait(), so a
+        ** burst of messages costs one wakeup instead of one per message */
+        if (  (new_evt & gki_cb.com.OSWaitForEvt[task_id])
+            ||(gki_cb.com.OSRdyTbl[task_id] == TASK_DEAD)  )
+        {
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+            UINT64 one = 1;
+
+            if (gki_cb.os.thread_evt_fd[task_id] >= 0)
+                write (gki_cb.os.thread_evt_fd[task_id], &one, sizeof (one));
+            else
+#endif
+            pthread_cond_signal(&gki_cb.os.thread_evt_cond[task_id]);
+        }
 
         pthread_mutex_unlock(&gki_cb.os.thread_evt_mutex[task_id]);
 
@@ -867,6 +1202,73 @@ UINT8 GKI_isend_event (UINT8 task_id, UINT16 event)
 }
 
 
+/*******************************************************************************
+**
+** Function         GKI_add_wait_fd
+**
+** Description      This function adds a file descriptor to the set a task
+**                  waits on in GKI_wait(). While the fd is readable, GKI_wait()
+**                  of that task returns with the given event set, so the task
+**                  should include it in its wait flags and read the fd.
+**
+** Parameters:      task_id -  (input) The task that waits on the fd.
+**                  fd      -  (input) The file descriptor
+**                  event   -  (input) The event flag reported for the fd
+**
+** Returns          GKI_SUCCESS if all OK, else GKI_FAILURE (also when the
+**                  eventfd wakeup is not compiled in)
+**
+*******************************************************************************/
+UINT8 GKI_add_wait_fd (UINT8 task_id, int fd, UINT16 event)
+{
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    struct epoll_event ev;
+
+    if ((task_id < GKI_MAX_TASKS) && (event != 0) && (gki_cb.os.thread_epoll_fd[task_id] >= 0))
+    {
+        memset (&ev, 0, sizeof (ev));
+        ev.events   = EPOLLIN;
+        ev.data.u32 = event;
+
+        if (epoll_ctl (gki_cb.os.thread_epoll_fd[task_id], EPOLL_CTL_ADD, fd, &ev) == 0)
+            return (GKI_SUCCESS);
+
+        GKI_TRACE_2("GKI_add_wait_fd: epoll_ctl failed(%d) for task %d", errno, task_id);
+    }
+#endif
+    return (GKI_FAILURE);
+}
+
+/*******************************************************************************
+**
+** Function         GKI_remove_wait_fd
+**
+** Description      This function removes a file descriptor added with
+**                  GKI_add_wait_fd() from the set a task waits on.
+**
+** Parameters:      task_id -  (input) The task that waits on the fd.
+**                  fd      -  (input) The file descriptor
+**
+** Returns          GKI_SUCCESS if all OK, else GKI_FAILURE
+**
+*******************************************************************************/
+UINT8 GKI_remove_wait_fd (UINT8 task_id, int fd)
+{
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    struct epoll_event ev;
+
+    if ((task_id < GKI_MAX_TASKS) && (gki_cb.os.thread_epoll_fd[task_id] >= 0))
+    {
+        /* pre 2.6.9 kernels require a non NULL event even for EPOLL_CTL_DEL */
+        memset (&ev, 0, sizeof (ev));
+        if (epoll_ctl (gki_cb.os.thread_epoll_fd[task_id], EPOLL_CTL_DEL, fd, &ev) == 0)
+            return (GKI_SUCCESS);
+    }
+#endif
+    return (GKI_FAILURE);
+}
+
+
 /*******************************************************************************
 **
 ** Function         GKI_get_taskid
@@ -1227,6 +1629,9 @@ void GKI_exit_task (UINT8 task_id)
     pthread_cond_destroy (&gki_cb.os.thread_evt_cond[task_id]);
     pthread_mutex_destroy(&gki_cb.os.thread_timeout_mutex[task_id]);
     pthread_cond_destroy (&gki_cb.os.thread_timeout_cond[task_id]);
+#if (GKI_USE_EVENTFD_WAKEUP == TRUE)
+    gki_close_wait_fds (task_id);
+#endif
 
     GKI_enable();
 
@@ -501,10 +501,21 @@ void nfc_hal_dm_proc_msg_during_init (NFC_HDR *p_msg)
             /* make sure this is the RSP we are waiting for before updating the command window */
             if ((old_gid == gid) && (old_oid == op_code))
             {
-                nfc_hal_cb.ncit_cb.nci_wait_rsp = NFC_HAL_WAIT_RSP_NONE;
                 p_cback = (tNFC_HAL_NCI_CBACK *)nfc_hal_cb.ncit_cb.p_vsc_cback;
-                nfc_hal_cb.ncit_cb.p_vsc_cback  = NULL;
-                nfc_hal_main_stop_quick_timer (&nfc_hal_cb.ncit_cb.nci_wait_rsp_timer);
+
+                if (  (p_cback == nfc_hal_prm_nci_command_complete_cback)
+                    &&(nfc_hal_cb.prm.spd_in_flight > 1)  )
+                {
+                    /* more patch segments are in flight; keep the command window for them */
+                    nfc_hal_main_start_quick_timer (&nfc_hal_cb.ncit_cb.nci_wait_rsp_timer, (UINT16)(NFC_HAL_TTYPE_NCI_WAIT_RSP),
+                                                    ((UINT32) NFC_HAL_CMD_TOUT) * QUICK_TIMER_TICKS_PER_SEC / 1000);
+                }
+                else
+                {
+                    nfc_hal_cb.ncit_cb.nci_wait_rsp = NFC_HAL_WAIT_RSP_NONE;
+                    nfc_hal_cb.ncit_cb.p_vsc_cback  = NULL;
+                    nfc_hal_main_stop_quick_timer (&nfc_hal_cb.ncit_cb.nci_wait_rsp_timer);
+                }
             }
         }
     }
@@ -576,6 +587,10 @@ void nfc_hal_dm_proc_msg_during_init (NFC_HDR *p_msg)
         else if (  (op_code == NFC_VS_GET_PATCH_VERSION_EVT)
                  &&(nfc_hal_cb.dev_cb.initializing_state == NFC_HAL_INIT_STATE_W4_PATCH_INFO)  )
         {
+            /* keep the response; the platform may compare it with the one after the last patch download */
+            nfc_hal_cb.dev_cb.patch_version_len = (*p < NFC_HAL_PATCH_VERSION_MAX_LEN) ? *p : NFC_HAL_PATCH_VERSION_MAX_LEN;
+            memcpy (nfc_hal_cb.dev_cb.patch_version, p + 1, nfc_hal_cb.dev_cb.patch_version_len);
+
             p += NCI_PATCH_INFO_OFFSET_NVMTYPE;
 
             NFC_HAL_SET_INIT_STATE (NFC_HAL_INIT_STATE_W4_APP_COMPLETE);
@@ -943,6 +958,30 @@ void HAL_NfcPreInitDone (tHAL_NFC_STATUS status)
     }
 }
 
+/*******************************************************************************
+**
+** Function         HAL_NfcGetPatchVersion
+**
+** Description      Get the GET_PATCH_VERSION response received from NFCC while
+**                  initializing, before patch download.
+**
+**                  p_buf           - buffer to copy the response payload into
+**                  max_len         - size of p_buf
+**
+** Returns          length of the response payload copied into p_buf
+**
+*******************************************************************************/
+UINT8 HAL_NfcGetPatchVersion (UINT8 *p_buf, UINT8 max_len)
+{
+    UINT8 len = nfc_hal_cb.dev_cb.patch_version_len;
+
+    if (len > max_len)
+        len = max_len;
+    memcpy (p_buf, nfc_hal_cb.dev_cb.patch_version, len);
+
+    return (len);
+}
+
 /*******************************************************************************
 **
 ** Function         HAL_NfcReInit
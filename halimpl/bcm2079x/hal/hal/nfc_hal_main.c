@@ -25,6 +25,7 @@
 #include "nfc_hal_int.h"
 #include "userial.h"
 #include "upio.h"
+#include "nfc_latency.h"
 
 /****************************************************************************
 ** Definitions
@@ -43,11 +44,26 @@ NFC_HAL_TRANS_CFG_QUALIFIER tNFC_HAL_TRANS_CFG nfc_hal_trans_cfg =
 tNFC_HAL_CB nfc_hal_cb;
 #endif
 
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+/* NCI data packets taken from the mailbox, not written to the transport yet */
+static NFC_HDR        *nfc_hal_tx_gather_msg[NFC_HAL_TX_GATHER_MAX];
+static tUSERIAL_IOVEC  nfc_hal_tx_gather_iov[NFC_HAL_TX_GATHER_MAX];
+static UINT8           nfc_hal_tx_gather_cnt;
+
+/* TRUE if the message is an NCI data packet (nothing to do but writing it to the transport) */
+#define NFC_HAL_IS_TX_DATA_MSG(p)   (  (((p)->event & NFC_EVT_MASK) == NFC_HAL_EVT_TO_NFC_NCI)   \
+                                     &&((p)->layer_specific != NFC_HAL_WAIT_RSP_CMD)           \
+                                     &&((p)->layer_specific != NFC_HAL_WAIT_RSP_VSC)  )
+#endif
+
 /****************************************************************************
 ** Internal function prototypes
 ****************************************************************************/
 static void nfc_hal_main_userial_cback (tUSERIAL_PORT port, tUSERIAL_EVT evt, tUSERIAL_EVT_DATA *p_data);
 static void nfc_hal_main_handle_terminate (void);
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+static void nfc_hal_main_flush_tx_data (void);
+#endif
 
 
 #if (NFC_HAL_DEBUG == TRUE)
@@ -408,8 +424,83 @@ static void nfc_hal_main_send_message (NFC_HDR *p_msg)
         delta = p_msg->len - len;
         DISP_NCI (ps + delta, (UINT16) (p_msg->len - delta), FALSE);
 #endif
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+        /* written with the data packets following it in the mailbox */
+        nfc_hal_tx_gather_msg[nfc_hal_tx_gather_cnt]        = p_msg;
+        nfc_hal_tx_gather_iov[nfc_hal_tx_gather_cnt].p_data = ps;
+        nfc_hal_tx_gather_iov[nfc_hal_tx_gather_cnt].len    = p_msg->len;
+        if (++nfc_hal_tx_gather_cnt == NFC_HAL_TX_GATHER_MAX)
+            nfc_hal_main_flush_tx_data ();
+#else
         USERIAL_Write (USERIAL_NFC_PORT, ps, p_msg->len);
         GKI_freebuf (p_msg);
+#endif
+    }
+}
+
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+/*******************************************************************************
+**
+** Function         nfc_hal_main_flush_tx_data
+**
+** Description      Write the gathered NCI data packets to the transport with
+**                  a single USERIAL_WriteV and free them.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_hal_main_flush_tx_data (void)
+{
+    UINT8 xx;
+
+    if (nfc_hal_tx_gather_cnt == 0)
+        return;
+
+    if (nfc_hal_tx_gather_cnt == 1)
+        USERIAL_Write (USERIAL_NFC_PORT, nfc_hal_tx_gather_iov[0].p_data, nfc_hal_tx_gather_iov[0].len);
+    else
+        USERIAL_WriteV (USERIAL_NFC_PORT, nfc_hal_tx_gather_iov, nfc_hal_tx_gather_cnt);
+
+    for (xx = 0; xx < nfc_hal_tx_gather_cnt; xx++)
+        GKI_freebuf (nfc_hal_tx_gather_msg[xx]);
+
+    nfc_hal_tx_gather_cnt = 0;
+}
+#endif
+
+/*******************************************************************************
+**
+** Function         nfc_hal_main_proc_rx_nci_msg
+**
+** Description      Process the NCI message received in ncit_cb.p_rcv_msg;
+**                  reassemble it if required and send it to the stack.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_hal_main_proc_rx_nci_msg (void)
+{
+    /* complete of receiving NCI message */
+    nfc_hal_nci_assemble_nci_msg ();
+    if (nfc_hal_cb.ncit_cb.p_rcv_msg)
+    {
+        if (nfc_hal_nci_preproc_rx_nci_msg (nfc_hal_cb.ncit_cb.p_rcv_msg))
+        {
+#if (NFC_LATENCY_INCLUDED == TRUE)
+            /* the last byte of the message came with the latest transport read */
+            nfc_lat_since (NFC_LAT_HAL_RX, nfc_lat_rx_time);
+#endif
+            /* Send NCI message to the stack */
+            nfc_hal_cb.p_data_cback(nfc_hal_cb.ncit_cb.p_rcv_msg->len, (UINT8 *)((nfc_hal_cb.ncit_cb.p_rcv_msg + 1)
+                                             + nfc_hal_cb.ncit_cb.p_rcv_msg->offset));
+
+        }
+    }
+
+    if (nfc_hal_cb.ncit_cb.p_rcv_msg)
+    {
+        GKI_freebuf(nfc_hal_cb.ncit_cb.p_rcv_msg);
+        nfc_hal_cb.ncit_cb.p_rcv_msg = NULL;
     }
 }
 
@@ -425,7 +516,9 @@ static void nfc_hal_main_send_message (NFC_HDR *p_msg)
 UINT32 nfc_hal_main_task (UINT32 param)
 {
     UINT16   event;
+#if (NFC_HAL_NCI_BULK_RX_INCLUDED != TRUE)
     UINT8    byte;
+#endif
     UINT8    num_interfaces;
     UINT8    *p;
     NFC_HDR  *p_msg;
@@ -481,6 +574,11 @@ UINT32 nfc_hal_main_task (UINT32 param)
         {
             while ((p_msg = (NFC_HDR *) GKI_read_mbox (NFC_HAL_TASK_MBOX)) != NULL)
             {
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+                /* keep the transport in order; anything else may write to it */
+                if (!NFC_HAL_IS_TX_DATA_MSG (p_msg))
+                    nfc_hal_main_flush_tx_data ();
+#endif
                 free_msg = TRUE;
                 switch (p_msg->event & NFC_EVT_MASK)
                 {
@@ -527,11 +625,30 @@ UINT32 nfc_hal_main_task (UINT32 param)
                 if (free_msg)
                     GKI_freebuf (p_msg);
             }
+#if (NFC_HAL_TX_GATHER_MAX > 1)
+            nfc_hal_main_flush_tx_data ();
+#endif
         }
 
         /* Data waiting to be read from serial port */
         if (event & NFC_HAL_TASK_EVT_DATA_RDY)
         {
+#if (NFC_HAL_NCI_BULK_RX_INCLUDED == TRUE) && (USERIAL_RX_RING_INCLUDED == TRUE)
+            /* parse NCI frames directly from the receive ring of transport */
+            nfc_hal_nci_receive_ring ();
+#elif (NFC_HAL_NCI_BULK_RX_INCLUDED == TRUE)
+            /* parse NCI frames directly over the buffers received from transport */
+            while (TRUE)
+            {
+                USERIAL_ReadBuf (USERIAL_NFC_PORT, &p_msg);
+                if (p_msg == NULL)
+                {
+                    break;
+                }
+
+                nfc_hal_nci_receive_buf (p_msg);
+            }
+#else
             while (TRUE)
             {
                 /* Read one byte to see if there is anything waiting to be read */
@@ -542,26 +659,10 @@ UINT32 nfc_hal_main_task (UINT32 param)
 
                 if (nfc_hal_nci_receive_msg (byte))
                 {
-                    /* complete of receiving NCI message */
-                    nfc_hal_nci_assemble_nci_msg ();
-                    if (nfc_hal_cb.ncit_cb.p_rcv_msg)
-                    {
-                        if (nfc_hal_nci_preproc_rx_nci_msg (nfc_hal_cb.ncit_cb.p_rcv_msg))
-                        {
-                            /* Send NCI message to the stack */
-                            nfc_hal_cb.p_data_cback(nfc_hal_cb.ncit_cb.p_rcv_msg->len, (UINT8 *)((nfc_hal_cb.ncit_cb.p_rcv_msg + 1)
-                                                             + nfc_hal_cb.ncit_cb.p_rcv_msg->offset));
-
-                        }
-                    }
-
-                    if (nfc_hal_cb.ncit_cb.p_rcv_msg)
-                    {
-                        GKI_freebuf(nfc_hal_cb.ncit_cb.p_rcv_msg);
-                        nfc_hal_cb.ncit_cb.p_rcv_msg = NULL;
-                    }
+                    nfc_hal_main_proc_rx_nci_msg ();
                 }
             } /* while (TRUE) */
+#endif
         }
 
         /* Process quick timer tick */
@@ -510,6 +510,279 @@ BOOLEAN nfc_hal_nci_receive_msg (UINT8 byte)
     return (msg_received);
 }
 
+#if (NFC_HAL_NCI_BULK_RX_INCLUDED == TRUE)
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_receive_partial
+**
+** Description
+**      Continue receiving a message which is split across transport buffers.
+**      Packet type and header bytes go through the byte-wise state machine,
+**      the payload is copied as one block.
+**
+** Returns          number of bytes consumed from p_data
+**
+*****************************************************************************/
+static UINT16 nfc_hal_nci_receive_partial (UINT8 *p_data, UINT16 len)
+{
+    tNFC_HAL_NCIT_CB *p_cb = &(nfc_hal_cb.ncit_cb);
+    UINT16  consumed = 0;
+    UINT16  copy_len;
+    BOOLEAN is_nci;
+
+    while (consumed < len)
+    {
+        if (  (p_cb->rcv_state == NFC_HAL_RCV_NCI_PAYLOAD_ST)
+            ||(p_cb->rcv_state == NFC_HAL_RCV_BT_PAYLOAD_ST)  )
+        {
+            is_nci   = (p_cb->rcv_state == NFC_HAL_RCV_NCI_PAYLOAD_ST);
+            copy_len = len - consumed;
+            if (copy_len > p_cb->rcv_len)
+                copy_len = p_cb->rcv_len;
+
+            if (p_cb->p_rcv_msg)
+            {
+                memcpy ((UINT8 *) (p_cb->p_rcv_msg + 1) + p_cb->p_rcv_msg->offset + p_cb->p_rcv_msg->len,
+                        p_data + consumed, copy_len);
+                p_cb->p_rcv_msg->len += copy_len;
+            }
+            consumed      += copy_len;
+            p_cb->rcv_len -= copy_len;
+
+            if (p_cb->rcv_len == 0)
+            {
+                p_cb->rcv_state = NFC_HAL_RCV_IDLE_ST;
+
+                if (is_nci)
+                {
+                    nfc_hal_main_proc_rx_nci_msg ();
+                }
+                else
+                {
+#if (NFC_HAL_TRACE_PROTOCOL == TRUE)
+                    if (p_cb->p_rcv_msg)
+                        DispHciEvt (p_cb->p_rcv_msg);
+#endif
+                    nfc_hal_nci_proc_rx_bt_msg ();
+                }
+                break;
+            }
+        }
+        else
+        {
+            /* packet type and header; payload is never read from here */
+            if (nfc_hal_nci_receive_msg (p_data[consumed++]))
+            {
+                /* NCI message without payload */
+                nfc_hal_main_proc_rx_nci_msg ();
+            }
+
+            if (p_cb->rcv_state == NFC_HAL_RCV_IDLE_ST)
+                break;
+        }
+    }
+
+    return (consumed);
+}
+
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_frame_len
+**
+** Description
+**      Find the size of the message starting at p_data, if no message is in
+**      progress and the message is complete within len bytes.
+**
+** Returns          size of the message following the packet type, or 0
+**
+*****************************************************************************/
+static UINT16 nfc_hal_nci_frame_len (UINT8 *p_data, UINT16 len)
+{
+    UINT16 frame_len = 0;
+
+    if (nfc_hal_cb.ncit_cb.rcv_state != NFC_HAL_RCV_IDLE_ST)
+        return (0);
+
+    if ((p_data[0] == HCIT_TYPE_NFC) && (len > NCI_MSG_HDR_SIZE))
+        frame_len = NCI_MSG_HDR_SIZE + p_data[NCI_MSG_HDR_SIZE];
+    else if ((p_data[0] == HCIT_TYPE_EVENT) && (len > HCIE_PREAMBLE_SIZE))
+        frame_len = HCIE_PREAMBLE_SIZE + p_data[HCIE_PREAMBLE_SIZE];
+
+    if (frame_len + 1 > len)
+        frame_len = 0;
+
+    return (frame_len);
+}
+
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_copy_frame
+**
+** Description
+**      Copy a complete message found by nfc_hal_nci_frame_len () into its
+**      own buffer.
+**
+** Returns          buffer, or NULL if out of buffers
+**
+*****************************************************************************/
+static NFC_HDR *nfc_hal_nci_copy_frame (UINT8 *p_data, UINT16 frame_len)
+{
+    NFC_HDR *p_msg;
+
+    p_msg = (NFC_HDR *) GKI_getpoolbuf (NFC_HAL_NCI_POOL_ID);
+    if (p_msg != NULL)
+    {
+        p_msg->offset = 0;
+        memcpy ((UINT8 *) (p_msg + 1), p_data + 1, frame_len);
+    }
+    else
+    {
+        NCI_TRACE_ERROR0 ("Unable to allocate buffer for incoming NCI message.");
+    }
+
+    return (p_msg);
+}
+
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_proc_rx_frame
+**
+** Description
+**      Process a complete message received in p_msg
+**
+** Returns          void
+**
+*****************************************************************************/
+static void nfc_hal_nci_proc_rx_frame (NFC_HDR *p_msg, UINT8 pkt_type, UINT16 frame_len)
+{
+    p_msg->len            = frame_len;
+    p_msg->event          = 0;
+    p_msg->layer_specific = 0;
+    nfc_hal_cb.ncit_cb.p_rcv_msg = p_msg;
+
+    if (pkt_type == HCIT_TYPE_NFC)
+    {
+        nfc_hal_main_proc_rx_nci_msg ();
+    }
+    else
+    {
+#if (NFC_HAL_TRACE_PROTOCOL == TRUE)
+        DispHciEvt (p_msg);
+#endif
+        nfc_hal_nci_proc_rx_bt_msg ();
+    }
+}
+
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_receive_buf
+**
+** Description
+**      Handle a buffer of incoming data from the serial port.
+**
+**      Complete NCI/BT messages are parsed in place. The last message in the
+**      buffer is handed up in the transport buffer itself; any other message
+**      is copied once into its own buffer. Messages split across transport
+**      buffers fall back to the byte-wise state machine.
+**
+**      The buffer is consumed by this function.
+**
+** Returns          void
+**
+*****************************************************************************/
+void nfc_hal_nci_receive_buf (NFC_HDR *p_buf)
+{
+    NFC_HDR *p_msg;
+    UINT8   *p;
+    UINT8   pkt_type;
+    UINT16  frame_len, consumed;
+
+    while ((p_buf) && (p_buf->len > 0))
+    {
+        p         = (UINT8 *) (p_buf + 1) + p_buf->offset;
+        pkt_type  = *p;
+        frame_len = nfc_hal_nci_frame_len (p, p_buf->len);
+
+        if (frame_len == 0)
+        {
+            /* partial message, or a message already in progress */
+            consumed        = nfc_hal_nci_receive_partial (p, p_buf->len);
+            p_buf->offset  += consumed;
+            p_buf->len     -= consumed;
+            continue;
+        }
+
+        if (frame_len + 1 == p_buf->len)
+        {
+            /* last message in this buffer; no need to copy */
+            p_msg           = p_buf;
+            p_msg->offset  += 1;
+            p_buf           = NULL;
+        }
+        else
+        {
+            p_msg           = nfc_hal_nci_copy_frame (p, frame_len);
+            p_buf->offset  += frame_len + 1;
+            p_buf->len     -= frame_len + 1;
+
+            if (p_msg == NULL)
+                continue;
+        }
+
+        nfc_hal_nci_proc_rx_frame (p_msg, pkt_type, frame_len);
+    }
+
+    if (p_buf)
+        GKI_freebuf (p_buf);
+}
+
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+/*****************************************************************************
+**
+** Function         nfc_hal_nci_receive_ring
+**
+** Description
+**      Handle all incoming data waiting in the receive ring of the serial
+**      port. Each contiguous span of the ring goes through the same parser
+**      as nfc_hal_nci_receive_buf (): messages complete in the span are
+**      copied once into their own buffer, and only messages split across
+**      spans fall back to the state machine.
+**
+** Returns          void
+**
+*****************************************************************************/
+void nfc_hal_nci_receive_ring (void)
+{
+    NFC_HDR *p_msg;
+    UINT8   *p;
+    UINT16  len, consumed, frame_len;
+
+    while ((len = USERIAL_ReadPeek (USERIAL_NFC_PORT, &p)) > 0)
+    {
+        consumed = 0;
+        while (consumed < len)
+        {
+            frame_len = nfc_hal_nci_frame_len (p + consumed, (UINT16) (len - consumed));
+
+            if (frame_len == 0)
+            {
+                /* partial message, or a message already in progress */
+                consumed += nfc_hal_nci_receive_partial (p + consumed, (UINT16) (len - consumed));
+                continue;
+            }
+
+            p_msg     = nfc_hal_nci_copy_frame (p + consumed, frame_len);
+            if (p_msg != NULL)
+                nfc_hal_nci_proc_rx_frame (p_msg, p[consumed], frame_len);
+            consumed += frame_len + 1;
+        }
+
+        USERIAL_ReadConsume (USERIAL_NFC_PORT, len);
+    }
+}
+#endif
+#endif
+
 /*******************************************************************************
 **
 ** Function         nfc_hal_nci_preproc_rx_nci_msg
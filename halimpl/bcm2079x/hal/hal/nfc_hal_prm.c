@@ -18,6 +18,7 @@
 #include <string.h>
 #include "nfc_hal_int.h"
 #include "userial.h"
+#include "nfc_latency.h"
 
 /*****************************************************************************
 * Definitions
@@ -47,6 +48,10 @@
 const UINT8 NFC_HAL_PRM_BCM20791B3_STR[]   = "20791B3";
 #define NFC_HAL_PRM_BCM20791B3_STR_LEN     (sizeof (NFC_HAL_PRM_BCM20791B3_STR)-1)
 
+/* SPD segments which may be sent while others are in flight */
+#define NFC_HAL_PRM_SPD_IS_DATA(type)      (((type) >= NCI_SPD_TYPE_SRAM) && ((type) <= NCI_SPD_TYPE_CONTROLLED_CONFIG))
+#define NFC_HAL_PRM_SPD_CUR_WINDOW()       (nfc_hal_cb.spd_window ? nfc_hal_cb.spd_window : NFC_HAL_PRM_SPD_WINDOW)
+
 #define NFC_HAL_PRM_SPD_TOUT                   (6000)  /* timeout for SPD events (in ms)   */
 #define NFC_HAL_PRM_END_DELAY                  (250)   /* delay before sending any new command (ms)*/
 
@@ -71,6 +76,31 @@ void nfc_hal_prm_post_baud_update (tHAL_NFC_STATUS status);
 *****************************************************************************/
 extern BOOLEAN nfc_hal_prm_nvm_required;
 
+#if (NFC_LATENCY_INCLUDED == TRUE)
+/*******************************************************************************
+**
+** Function         nfc_hal_prm_spd_set_phase
+**
+** Description      Account the time spent in the current download phase and
+**                  start timing the next one
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_hal_prm_spd_set_phase (UINT8 phase)
+{
+    UINT32 now = nfc_lat_now ();
+
+    if (nfc_hal_cb.prm.spd_phase < NFC_HAL_PRM_NUM_PHASES)
+        nfc_hal_cb.prm.spd_phase_time[nfc_hal_cb.prm.spd_phase] += now - nfc_hal_cb.prm.spd_phase_start;
+
+    nfc_hal_cb.prm.spd_phase       = phase;
+    nfc_hal_cb.prm.spd_phase_start = now;
+}
+#else
+#define nfc_hal_prm_spd_set_phase(phase)
+#endif
+
 /*******************************************************************************
 **
 ** Function         nfc_hal_prm_spd_handle_download_complete
@@ -82,6 +112,16 @@ extern BOOLEAN nfc_hal_prm_nvm_required;
 *******************************************************************************/
 void nfc_hal_prm_spd_handle_download_complete (UINT8 event)
 {
+    nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_NONE);
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    NCI_TRACE_DEBUG6 ("Patch download timing (ms): version=%u, download=%u (%u segments, window %u), auth=%u, nvm=%u",
+                      nfc_hal_cb.prm.spd_phase_time[NFC_HAL_PRM_PHASE_VERSION] / 1000,
+                      nfc_hal_cb.prm.spd_phase_time[NFC_HAL_PRM_PHASE_DOWNLOAD] / 1000,
+                      nfc_hal_cb.prm.spd_segments, NFC_HAL_PRM_SPD_CUR_WINDOW (),
+                      nfc_hal_cb.prm.spd_phase_time[NFC_HAL_PRM_PHASE_AUTH] / 1000,
+                      nfc_hal_cb.prm.spd_phase_time[NFC_HAL_PRM_PHASE_NVM] / 1000);
+#endif
+
     nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_IDLE;
 
     /* Notify application now */
@@ -91,14 +131,42 @@ void nfc_hal_prm_spd_handle_download_complete (UINT8 event)
 
 /*******************************************************************************
 **
-** Function         nfc_hal_prm_spd_send_next_segment
+** Function         nfc_hal_prm_spd_can_pipeline
 **
-** Description      Send next patch segment (for secure patch download)
+** Description      Check if the next patch segment may be sent before the
+**                  segments in flight are acknowledged: only data segments
+**                  following a data segment are, up to the SPD window.
 **
-** Returns          void
+** Returns          TRUE if the next segment can be sent now
 **
 *******************************************************************************/
-void nfc_hal_prm_spd_send_next_segment (void)
+static BOOLEAN nfc_hal_prm_spd_can_pipeline (void)
+{
+    const UINT8 *p;
+
+    if (  (nfc_hal_cb.prm.spd_in_flight >= NFC_HAL_PRM_SPD_CUR_WINDOW ())
+        ||(!NFC_HAL_PRM_SPD_IS_DATA (nfc_hal_cb.prm.spd_last_type))
+        ||(nfc_hal_cb.prm.cur_patch_len_remaining < NCI_MSG_HDR_SIZE + 2)  )
+        return FALSE;
+
+    /* HCIT, NCI header, SPD type */
+    p = nfc_hal_cb.prm.p_cur_patch_data + nfc_hal_cb.prm.cur_patch_offset;
+
+    return (  (p[2] == NCI_MSG_SECURE_PATCH_DOWNLOAD)
+            &&(NFC_HAL_PRM_SPD_IS_DATA (p[4]))
+            &&(nfc_hal_cb.prm.cur_patch_len_remaining >= p[3] + NCI_MSG_HDR_SIZE + 1)  );
+}
+
+/*******************************************************************************
+**
+** Function         nfc_hal_prm_spd_send_segment
+**
+** Description      Send one patch segment (for secure patch download)
+**
+** Returns          TRUE if the segment was sent
+**
+*******************************************************************************/
+static BOOLEAN nfc_hal_prm_spd_send_segment (void)
 {
     UINT8   *p_src;
     UINT16  len, offset = nfc_hal_cb.prm.cur_patch_offset;
@@ -106,13 +174,22 @@ void nfc_hal_prm_spd_send_next_segment (void)
     UINT8   chipverlen;
     UINT8   chipverstr[NCI_SPD_HEADER_CHIPVER_LEN];
     UINT8   patch_hdr_size = NCI_MSG_HDR_SIZE + 1; /* 1 is for HCIT */
+    NFC_HDR *p_buf = NULL;
 
     /* Validate that segment is at least big enought to have NCI_MSG_HDR_SIZE + 1 (hcit) */
     if (nfc_hal_cb.prm.cur_patch_len_remaining < patch_hdr_size)
     {
         NCI_TRACE_ERROR0 ("Unexpected end of patch.");
         nfc_hal_prm_spd_handle_download_complete (NFC_HAL_PRM_ABORT_INVALID_PATCH_EVT);
-        return;
+        return FALSE;
+    }
+
+    /* The command window is held by the segments in flight; send directly */
+    if (  (nfc_hal_cb.prm.spd_in_flight > 0)
+        &&((p_buf = (NFC_HDR *) GKI_getpoolbuf (NFC_HAL_NCI_POOL_ID)) == NULL)  )
+    {
+        /* try again when the next response frees the window */
+        return FALSE;
     }
 
     /* Parse NCI command header */
@@ -127,6 +204,7 @@ void nfc_hal_prm_spd_send_next_segment (void)
     /* Update number of bytes comsumed */
     nfc_hal_cb.prm.cur_patch_offset += (len + patch_hdr_size);
     nfc_hal_cb.prm.cur_patch_len_remaining -=  (len + patch_hdr_size);
+    nfc_hal_cb.prm.spd_last_type = (oid == NCI_MSG_SECURE_PATCH_DOWNLOAD) ? type : 0xFF;
 
     /* Check if sending signature byte */
     if (  (oid == NCI_MSG_SECURE_PATCH_DOWNLOAD )
@@ -155,9 +233,48 @@ void nfc_hal_prm_spd_send_next_segment (void)
         }
     }
 
+    nfc_hal_cb.prm.spd_in_flight++;
+    nfc_hal_cb.prm.spd_segments++;
+
     /* Send the command (not including HCIT here) */
-    nfc_hal_dm_send_nci_cmd ((UINT8*) (nfc_hal_cb.prm.p_cur_patch_data + offset + 1), (UINT8) (len + NCI_MSG_HDR_SIZE),
-                             nfc_hal_prm_nci_command_complete_cback);
+    if (p_buf)
+    {
+        p_buf->offset = NFC_HAL_NCI_MSG_OFFSET_SIZE;
+        p_buf->event  = NFC_HAL_EVT_TO_NFC_NCI;
+        p_buf->len    = len + NCI_MSG_HDR_SIZE;
+        memcpy ((UINT8 *) (p_buf + 1) + p_buf->offset, nfc_hal_cb.prm.p_cur_patch_data + offset + 1, p_buf->len);
+
+        nfc_hal_nci_send_cmd (p_buf);
+
+        /* restart the command-timeout timer for the last segment */
+        nfc_hal_main_start_quick_timer (&nfc_hal_cb.ncit_cb.nci_wait_rsp_timer, (UINT16)(NFC_HAL_TTYPE_NCI_WAIT_RSP),
+                                        ((UINT32) NFC_HAL_CMD_TOUT) * QUICK_TIMER_TICKS_PER_SEC / 1000);
+    }
+    else
+    {
+        nfc_hal_dm_send_nci_cmd ((UINT8*) (nfc_hal_cb.prm.p_cur_patch_data + offset + 1), (UINT8) (len + NCI_MSG_HDR_SIZE),
+                                 nfc_hal_prm_nci_command_complete_cback);
+    }
+    return TRUE;
+}
+
+/*******************************************************************************
+**
+** Function         nfc_hal_prm_spd_send_next_segment
+**
+** Description      Send next patch segment (for secure patch download), and
+**                  the following ones while the SPD window allows
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_hal_prm_spd_send_next_segment (void)
+{
+    while ((nfc_hal_cb.prm.spd_in_flight == 0) || nfc_hal_prm_spd_can_pipeline ())
+    {
+        if (!nfc_hal_prm_spd_send_segment ())
+            break;
+    }
 }
 
 /*******************************************************************************
@@ -217,6 +334,7 @@ void nfc_hal_prm_spd_handle_next_patch_start (void)
     /* Begin downloading patch */
     NCI_TRACE_DEBUG1 ("Downloading patch for power_mode %i.", nfc_hal_cb.prm.spd_patch_desc[nfc_hal_cb.prm.spd_cur_patch_idx].power_mode);
     nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_SPD_DOWNLOADING;
+    nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_DOWNLOAD);
     nfc_hal_prm_spd_send_next_segment ();
 }
 
@@ -287,6 +405,7 @@ void nfc_hal_prm_spd_download_i2c_fix (void)
         nfc_hal_cb.prm.cur_patch_offset += (UINT16) (p - p_start);              /* Bytes of patchfile transmitted/processed so far */
 
         /* Begin sending patch to the NFCC */
+        nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_DOWNLOAD);
         nfc_hal_prm_spd_send_next_segment ();
     }
     else
@@ -579,6 +698,8 @@ void nfc_hal_prm_nci_command_complete_cback (tNFC_HAL_NCI_EVT event, UINT16 data
     /* Handle GET_PATCH_VERSION Rsp */
     if (event == NFC_VS_GET_PATCH_VERSION_EVT)
     {
+        nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_NONE);
+
         /* Get project id */
         STREAM_TO_UINT16 (nfc_hal_cb.prm.spd_project_id, p);
 
@@ -656,6 +777,13 @@ void nfc_hal_prm_nci_command_complete_cback (tNFC_HAL_NCI_EVT event, UINT16 data
         STREAM_TO_UINT8 (status, p);
         STREAM_TO_UINT8 (u8, p);
 
+        if (nfc_hal_cb.prm.spd_in_flight > 0)
+            nfc_hal_cb.prm.spd_in_flight--;
+
+        /* Download was aborted while segments were in flight; drop their responses */
+        if (nfc_hal_cb.prm.state == NFC_HAL_PRM_ST_IDLE)
+            return;
+
         if (status != NCI_STATUS_OK)
         {
 #if (NFC_HAL_TRACE_VERBOSE == TRUE)
@@ -674,6 +802,7 @@ void nfc_hal_prm_nci_command_complete_cback (tNFC_HAL_NCI_EVT event, UINT16 data
         {
             /* Wait for authentication complate (SECURE_PATCH_DOWNLOAD NTF) */
             nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_SPD_AUTHENTICATING;
+            nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_AUTH);
             nfc_hal_main_start_quick_timer (&nfc_hal_cb.prm.timer, 0x00,
                                             (NFC_HAL_PRM_SPD_TOUT * QUICK_TIMER_TICKS_PER_SEC) / 1000);
             return;
@@ -721,6 +850,7 @@ void nfc_hal_prm_nci_command_complete_cback (tNFC_HAL_NCI_EVT event, UINT16 data
 
                 /* Resume normal patch download */
                 nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_SPD_GET_PATCH_HEADER;
+                nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_NONE);
                 nfc_hal_cb.prm.flags &= ~NFC_HAL_PRM_FLAGS_SIGNATURE_SENT;
 
                 /* Post PreI2C delay */
@@ -755,6 +885,7 @@ void nfc_hal_prm_nci_command_complete_cback (tNFC_HAL_NCI_EVT event, UINT16 data
             }
 
             nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_SPD_AUTH_DONE;
+            nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_NVM);
 
             nfc_hal_main_start_quick_timer (&nfc_hal_cb.prm.timer, 0x00,
                                             (post_signature_delay * QUICK_TIMER_TICKS_PER_SEC) / 1000);
@@ -883,6 +1014,7 @@ void nfc_hal_prm_process_timeout (void *p_tle)
     if (nfc_hal_cb.prm.state == NFC_HAL_PRM_ST_IDLE)
     {
         nfc_hal_cb.prm.state = NFC_HAL_PRM_ST_SPD_GET_VERSION;
+        nfc_hal_prm_spd_set_phase (NFC_HAL_PRM_PHASE_VERSION);
 
         /* Get currently downloaded patch version */
         nfc_hal_dm_send_nci_cmd (nfc_hal_prm_get_patch_version_cmd, NCI_MSG_HDR_SIZE, nfc_hal_prm_nci_command_complete_cback);
@@ -957,6 +1089,7 @@ BOOLEAN HAL_NfcPrmDownloadStart (tNFC_HAL_PRM_FORMAT format_type,
     NCI_TRACE_API0 ("HAL_NfcPrmDownloadStart ()");
 
     memset (&nfc_hal_cb.prm, 0, sizeof (tNFC_HAL_PRM_CB));
+    nfc_hal_cb.prm.spd_phase = NFC_HAL_PRM_PHASE_NONE;
 
     if (p_patchram_buf)
     {
@@ -1117,3 +1250,50 @@ tHAL_NFC_STATUS HAL_NfcPrmSetSpdNciCmdPayloadSize (UINT8 max_payload_size)
         return (HAL_NFC_STATUS_OK);
     }
 }
+
+/*******************************************************************************
+**
+** Function         HAL_NfcPrmSetSpdWindow
+**
+** Description      Set the number of secure patch download segments sent to
+**                  the NFCC without waiting for their responses
+**
+** Returns          HAL_NFC_STATUS_OK if successful
+**                  HAL_NFC_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tHAL_NFC_STATUS HAL_NfcPrmSetSpdWindow (UINT8 window)
+{
+    if ((window == 0) || (window > NFC_HAL_PRM_SPD_MAX_WINDOW))
+    {
+        NCI_TRACE_ERROR2 ("HAL_NfcPrmSetSpdWindow: invalid window (%i). Must be between 1 and %i", window, NFC_HAL_PRM_SPD_MAX_WINDOW);
+        return (HAL_NFC_STATUS_FAILED);
+    }
+
+    NCI_TRACE_API1 ("HAL_NfcPrmSetSpdWindow: %i segments in flight during download", window);
+    nfc_hal_cb.spd_window = window;
+    return (HAL_NFC_STATUS_OK);
+}
+
+/*******************************************************************************
+**
+** Function         HAL_NfcPrmPatchInNvm
+**
+** Description      Check if the last patch download found the patch file in
+**                  the NVM of the NFCC already, so nothing was downloaded and
+**                  the NFCC keeps the patch over power cycles.
+**
+**                  Only valid after NFC_HAL_PRM_COMPLETE_EVT.
+**
+** Returns          TRUE if nothing had to be downloaded to the NVM
+**
+*******************************************************************************/
+BOOLEAN HAL_NfcPrmPatchInNvm (void)
+{
+    return (  (nfc_hal_cb.prm.spd_segments == 0)
+            &&(nfc_hal_cb.prm.spd_project_id != 0)
+            &&(nfc_hal_cb.prm.spd_nvm_patch_mask != 0)
+            &&(!(nfc_hal_cb.prm.flags & (NFC_HAL_PRM_FLAGS_NO_NVM
+                                         | NFC_HAL_PRM_FLAGS_NVM_FPM_CORRUPTED
+                                         | NFC_HAL_PRM_FLAGS_NVM_LPM_CORRUPTED)))  );
+}
@@ -37,6 +37,11 @@
 #define NFC_HAL_NCI_POOL_BUF_SIZE               GKI_BUF1_SIZE
 #endif
 
+/* Parse NCI frames directly over the USERIAL receive buffers instead of byte by byte */
+#ifndef NFC_HAL_NCI_BULK_RX_INCLUDED
+#define NFC_HAL_NCI_BULK_RX_INCLUDED            TRUE
+#endif
+
 /* Initial Max Control Packet Payload Size (until receiving payload size in INIT_CORE_RSP) */
 #ifndef NFC_HAL_NCI_INIT_CTRL_PAYLOAD_SIZE
 #define NFC_HAL_NCI_INIT_CTRL_PAYLOAD_SIZE      0xFF
@@ -47,6 +52,12 @@
 #define NFC_HAL_NCI_MSG_OFFSET_SIZE             1
 #endif
 
+/* Max number of queued NCI data packets written to the transport in one USERIAL_WriteV
+** (1: one write per packet; at most USERIAL_MAX_WRITE_IOV) */
+#ifndef NFC_HAL_TX_GATHER_MAX
+#define NFC_HAL_TX_GATHER_MAX                   8
+#endif
+
 /* NFC-WAKE */
 #ifndef NFC_HAL_LP_NFC_WAKE_GPIO
 #define NFC_HAL_LP_NFC_WAKE_GPIO                UPIO_GENERAL3
@@ -109,6 +120,17 @@
 #define NFC_HAL_PRM_MIN_NCI_CMD_PAYLOAD_SIZE    (32)
 #endif
 
+/* Number of secure patch download segments sent without waiting for responses */
+/* (HAL_NfcPrmSetSpdWindow); 1 as NCI allows only one command at a time          */
+#ifndef NFC_HAL_PRM_SPD_WINDOW
+#define NFC_HAL_PRM_SPD_WINDOW                  (1)
+#endif
+
+/* Largest window accepted by HAL_NfcPrmSetSpdWindow */
+#ifndef NFC_HAL_PRM_SPD_MAX_WINDOW
+#define NFC_HAL_PRM_SPD_MAX_WINDOW              (8)
+#endif
+
 /* amount of time to wait for RESET NTF after patch download */
 #ifndef NFC_HAL_PRM_RESET_NTF_DELAY
 #define NFC_HAL_PRM_RESET_NTF_DELAY             (10000)
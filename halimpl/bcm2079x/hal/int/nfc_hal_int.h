@@ -173,6 +173,9 @@ typedef UINT8 tNFC_HAL_LP_EVT;
 #define NFC_HAL_SAVED_HDR_SIZE          (2)
 #define NFC_HAL_SAVED_CMD_SIZE          (2)
 
+/* Max length of the GET_PATCH_VERSION response kept while initializing NFCC */
+#define NFC_HAL_PATCH_VERSION_MAX_LEN   (48)
+
 #ifndef NFC_HAL_DEBUG
 #define NFC_HAL_DEBUG  TRUE
 #endif
@@ -277,6 +280,14 @@ typedef UINT8 tNFC_HAL_PRM_STATE;
 #define NFC_HAL_PRM_MAX_PATCH_COUNT    2
 #define NFC_HAL_PRM_PATCH_MASK_ALL     0xFFFFFFFF
 
+/* Patch download phases, timed separately */
+#define NFC_HAL_PRM_PHASE_VERSION      0       /* getting the patch version in NVM     */
+#define NFC_HAL_PRM_PHASE_DOWNLOAD     1       /* sending patch segments               */
+#define NFC_HAL_PRM_PHASE_AUTH         2       /* waiting for signature authentication */
+#define NFC_HAL_PRM_PHASE_NVM          3       /* waiting for NFCC to store the patch  */
+#define NFC_HAL_PRM_NUM_PHASES         4
+#define NFC_HAL_PRM_PHASE_NONE         0xFF
+
 /* Structures for PRM Control Block */
 typedef struct
 {
@@ -317,6 +328,16 @@ typedef struct
     tNFC_HAL_PRM_FORMAT format;                 /* format of patch ram              */
     tNFC_HAL_PRM_CBACK  *p_cback;               /* Callback for download status notifications */
     UINT32              patchram_delay;         /* the dealy after patch */
+
+    /* Pipelined download */
+    UINT8               spd_in_flight;          /* segments sent and not acknowledged yet */
+    UINT8               spd_last_type;          /* SPD type of the last segment sent      */
+    UINT16              spd_segments;           /* number of segments sent                */
+
+    /* Timing */
+    UINT8               spd_phase;              /* NFC_HAL_PRM_PHASE_xxx being timed      */
+    UINT32              spd_phase_start;        /* start of spd_phase (in us)             */
+    UINT32              spd_phase_time[NFC_HAL_PRM_NUM_PHASES]; /* time in each phase (in us) */
 } tNFC_HAL_PRM_CB;
 
 /* Patch for I2C fix */
@@ -350,6 +371,8 @@ typedef struct
     tNFC_HAL_INIT_STATE     initializing_state;     /* state of initializing NFCC               */
 
     UINT32                  brcm_hw_id;             /* BRCM NFCC HW ID                          */
+    UINT8                   patch_version_len;      /* length of patch_version                  */
+    UINT8                   patch_version[NFC_HAL_PATCH_VERSION_MAX_LEN]; /* GET_PATCH_VERSION RSP payload */
     tNFC_HAL_DM_CONFIG      next_dm_config;         /* next config in post initialization       */
     UINT8                   next_startup_vsc;       /* next start-up VSC offset in post init    */
 
@@ -396,6 +419,7 @@ typedef struct
 
     tNFC_HAL_NCI_CBACK      *p_reinit_cback;
     UINT8                   max_rf_credits;     /* NFC Max RF data credits */
+    UINT8                   spd_window;         /* SPD segments in flight, 0 for NFC_HAL_PRM_SPD_WINDOW */
     UINT8                   trace_level;        /* NFC HAL trace level */
 } tNFC_HAL_CB;
 
@@ -418,9 +442,12 @@ void   nfc_hal_main_pre_init_done (tHAL_NFC_STATUS);
 void   nfc_hal_main_start_quick_timer (TIMER_LIST_ENT *p_tle, UINT16 type, UINT32 timeout);
 void   nfc_hal_main_stop_quick_timer (TIMER_LIST_ENT *p_tle);
 void   nfc_hal_main_send_error (tHAL_NFC_STATUS status);
+void   nfc_hal_main_proc_rx_nci_msg (void);
 
 /* nfc_hal_nci.c */
 BOOLEAN nfc_hal_nci_receive_msg (UINT8 byte);
+void    nfc_hal_nci_receive_buf (NFC_HDR *p_buf);
+void    nfc_hal_nci_receive_ring (void);
 BOOLEAN nfc_hal_nci_preproc_rx_nci_msg (NFC_HDR *p_msg);
 void    nfc_hal_nci_assemble_nci_msg (void);
 void    nfc_hal_nci_add_nfc_pkt_type (NFC_HDR *p_msg);
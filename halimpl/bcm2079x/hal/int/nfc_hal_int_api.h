@@ -113,6 +113,21 @@ extern "C" {
 *******************************************************************************/
 void HAL_NfcPreInitDone (tHAL_NFC_STATUS status);
 
+/*******************************************************************************
+**
+** Function         HAL_NfcGetPatchVersion
+**
+** Description      Get the GET_PATCH_VERSION response received from NFCC while
+**                  initializing, before patch download.
+**
+**                  p_buf           - buffer to copy the response payload into
+**                  max_len         - size of p_buf
+**
+** Returns          length of the response payload copied into p_buf
+**
+*******************************************************************************/
+UINT8 HAL_NfcGetPatchVersion (UINT8 *p_buf, UINT8 max_len);
+
 /*******************************************************************************
 **
 ** Function         HAL_NfcReInit
@@ -260,6 +275,41 @@ void HAL_NfcPrmSetI2cPatch (UINT8 *p_i2c_patchfile_buf,
 *******************************************************************************/
 tHAL_NFC_STATUS HAL_NfcPrmSetSpdNciCmdPayloadSize (UINT8 max_payload_size);
 
+/*******************************************************************************
+**
+** Function         HAL_NfcPrmSetSpdWindow
+**
+** Description      Set the number of secure patch download segments sent to
+**                  the NFCC without waiting for their responses
+**
+**                  NCI allows only one command at a time, so a window above 1
+**                  must only be used with NFCC firmware which accepts more
+**                  SECURE_PATCH_DOWNLOAD commands in flight. Header and
+**                  signature segments are always sent alone.
+**
+**                  Valid window range: 1 to NFC_HAL_PRM_SPD_MAX_WINDOW.
+**
+** Returns          HAL_NFC_STATUS_OK if successful
+**                  HAL_NFC_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tHAL_NFC_STATUS HAL_NfcPrmSetSpdWindow (UINT8 window);
+
+/*******************************************************************************
+**
+** Function         HAL_NfcPrmPatchInNvm
+**
+** Description      Check if the last patch download found the patch file in
+**                  the NVM of the NFCC already, so nothing was downloaded and
+**                  the NFCC keeps the patch over power cycles.
+**
+**                  Only valid after NFC_HAL_PRM_COMPLETE_EVT.
+**
+** Returns          TRUE if nothing had to be downloaded to the NVM
+**
+*******************************************************************************/
+BOOLEAN HAL_NfcPrmPatchInNvm (void);
+
 /*******************************************************************************
 **
 ** Function         HAL_NfcSetMaxRfDataCredits
@@ -25,6 +25,7 @@
 #define NFC_HAL_NV_CO_H
 
 #include <time.h>
+#include <stdint.h>
 
 
 /*****************************************************************************
@@ -54,6 +55,27 @@ typedef UINT8 tNFC_HAL_NV_CO_STATUS;
 #define  HC_F3_NV_BLOCK         0x02
 #define  HC_F4_NV_BLOCK         0x03
 #define  HC_DH_NV_BLOCK         0x04
+#define  PATCH_NV_BLOCK         0x05
+
+/* Max length of the GET_PATCH_VERSION response kept in tNFC_HAL_NV_PATCH_INFO */
+#define NFC_HAL_NV_PATCH_VERSION_LEN    48
+
+#define NFC_HAL_NV_PATCH_INFO_MAGIC     0x4850434E  /* "NCPH" */
+
+/* Patch file found in the NVM of the NFCC after the last patch download */
+typedef struct
+{
+    uint32_t    magic;                  /* NFC_HAL_NV_PATCH_INFO_MAGIC              */
+    uint32_t    hw_id;                  /* BRCM NFCC HW ID                          */
+    uint64_t    name_hash;              /* hash of the patch file name              */
+    uint64_t    file_size;              /* size of the patch file                   */
+    uint64_t    file_ino;               /* inode of the patch file                  */
+    int64_t     mtime;                  /* modification time of the patch file      */
+    int64_t     ctime;                  /* status change time of the patch file     */
+    uint64_t    content_hash;           /* hash of the patch file contents          */
+    uint8_t     version_len;            /* length of version                        */
+    uint8_t     version[NFC_HAL_NV_PATCH_VERSION_LEN]; /* GET_PATCH_VERSION response payload */
+} tNFC_HAL_NV_PATCH_INFO;
 
 /*****************************************************************************
 **  Function Declarations
@@ -104,5 +126,34 @@ void nfc_hal_nv_co_read (UINT8 *p_buf, UINT16 nbytes, UINT8 block);
 *******************************************************************************/
 void nfc_hal_nv_co_write (const UINT8 *p_buf, UINT16 nbytes, UINT8 block);
 
+/*******************************************************************************
+**
+** Function         nfc_hal_nv_co_read_patch_info
+**
+** Description      Read the patch information saved by
+**                  nfc_hal_nv_co_write_patch_info. Unlike nfc_hal_nv_co_read,
+**                  this completes before returning.
+**
+** Parameters       p_info  - buffer to read the patch information into.
+**
+** Returns          TRUE if valid patch information was read
+**
+*******************************************************************************/
+BOOLEAN nfc_hal_nv_co_read_patch_info (tNFC_HAL_NV_PATCH_INFO *p_info);
+
+/*******************************************************************************
+**
+** Function         nfc_hal_nv_co_write_patch_info
+**
+** Description      Save the patch information, or erase it if p_info is NULL.
+**                  Unlike nfc_hal_nv_co_write, this completes before returning.
+**
+** Parameters       p_info  - patch information to save.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_hal_nv_co_write_patch_info (const tNFC_HAL_NV_PATCH_INFO *p_info);
+
 
 #endif /* NFC_HAL_NV_CO_H */
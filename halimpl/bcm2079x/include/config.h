@@ -69,6 +69,8 @@ int GetNumValue(const char* name, void* p_value, unsigned long len);
 #define NAME_SPD_DEBUG                  "SPD_DEBUG"
 #define NAME_SPD_MAXRETRYCOUNT          "SPD_MAX_RETRY_COUNT"
 #define NAME_SPI_NEGOTIATION            "SPI_NEGOTIATION"
+#define NAME_NFC_CAPTURE_FILE           "NFC_CAPTURE_FILE"
+#define NAME_NFC_CAPTURE_SIZE           "NFC_CAPTURE_SIZE"
 
 #define                     LPTD_PARAM_LEN (40)
 
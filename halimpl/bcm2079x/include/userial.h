@@ -236,6 +236,34 @@ typedef union
 /* callback for events */
 typedef void (tUSERIAL_CBACK)(tUSERIAL_PORT, tUSERIAL_EVT, tUSERIAL_EVT_DATA *);
 
+/* One segment of a gathered write (USERIAL_WriteV) */
+typedef struct
+{
+    UINT8   *p_data;
+    UINT16  len;
+} tUSERIAL_IOVEC;
+
+/* Max number of segments of one USERIAL_WriteV */
+#ifndef USERIAL_MAX_WRITE_IOV
+#define USERIAL_MAX_WRITE_IOV   16
+#endif
+
+/* Receive into a byte ring shared by the read thread and the HAL task
+** (USERIAL_ReadPeek/USERIAL_ReadConsume) instead of one GKI buffer per read */
+#ifndef USERIAL_RX_RING_INCLUDED
+#define USERIAL_RX_RING_INCLUDED    TRUE
+#endif
+
+/* Size of the receive ring; must be a power of 2 */
+#ifndef USERIAL_RX_RING_SIZE
+#define USERIAL_RX_RING_SIZE        4096
+#endif
+
+/* Max number of bytes asked from the driver by one read() into the ring */
+#ifndef USERIAL_RX_READ_BATCH
+#define USERIAL_RX_READ_BATCH       1024
+#endif
+
 /*******************************************************************************
 ** Function Prototypes
 *******************************************************************************/
@@ -248,8 +276,13 @@ UDRV_API extern void    USERIAL_Init(void *);
 UDRV_API extern void    USERIAL_Open(tUSERIAL_PORT, tUSERIAL_OPEN_CFG *, tUSERIAL_CBACK *);
 UDRV_API extern void    USERIAL_ReadBuf(tUSERIAL_PORT, BT_HDR **);
 UDRV_API extern UINT16  USERIAL_Read(tUSERIAL_PORT, UINT8 *, UINT16);
+#if (USERIAL_RX_RING_INCLUDED == TRUE)
+UDRV_API extern UINT16  USERIAL_ReadPeek(tUSERIAL_PORT, UINT8 **);
+UDRV_API extern void    USERIAL_ReadConsume(tUSERIAL_PORT, UINT16);
+#endif
 UDRV_API extern BOOLEAN USERIAL_WriteBuf(tUSERIAL_PORT, BT_HDR *);
 UDRV_API extern UINT16  USERIAL_Write(tUSERIAL_PORT, UINT8 *, UINT16);
+UDRV_API extern UINT16  USERIAL_WriteV(tUSERIAL_PORT, tUSERIAL_IOVEC *, UINT8);
 UDRV_API extern void    USERIAL_Ioctl(tUSERIAL_PORT, tUSERIAL_OP, tUSERIAL_IOCTL_DATA *);
 UDRV_API extern void    USERIAL_Close(tUSERIAL_PORT);
 UDRV_API extern BOOLEAN USERIAL_Feature(tUSERIAL_FEATURE);
@@ -22,8 +22,12 @@ extern "C"
     #include "gki.h"
     #include "nfa_api.h"
     #include "nfc_int.h"
+    #include "nfa_sys.h"
+    #include "nfa_dm_int.h"
 }
 #include "config.h"
+#include "nfc_capture.h"
+#include "nfc_latency.h"
 
 #define LOG_TAG "NfcAdaptation"
 
@@ -85,6 +89,39 @@ NfcAdaptation& NfcAdaptation::GetInstance()
     return *mpInstance;
 }
 
+/*******************************************************************************
+**
+** Function:    getStartupConfigId
+**
+** Description: Hash the settings the HAL sends to NFCC while it starts, so
+**              NFA knows when the NFCC config it saved is out of date.
+**
+** Returns:     identifier of the start-up config
+**
+*******************************************************************************/
+static UINT32 getStartupConfigId ()
+{
+    static const char* const names[] =
+    {
+        NAME_PREINIT_DSP_CFG,
+        NAME_NFA_DM_START_UP_CFG,
+        NAME_NFA_DM_START_UP_VSC_CFG,
+        NAME_LPTD_CFG
+    };
+    UINT8 value[256];
+    UINT32 hash = 2166136261u;  /* FNV-1a */
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        memset (value, 0, sizeof(value));
+        if (!GetStrValue (names[i], (char*)value, sizeof(value)))
+            continue;
+        for (size_t j = 0; j < sizeof(value); j++)
+            hash = (hash ^ value[j]) * 16777619u;
+    }
+    return hash;
+}
+
 /*******************************************************************************
 **
 ** Function:    NfcAdaptation::Initialize()
@@ -105,6 +142,10 @@ void NfcAdaptation::Initialize ()
     if ( GetNumValue ( NAME_PROTOCOL_TRACE_LEVEL, &num, sizeof ( num ) ) )
         ScrProtocolTraceFlag = num;
     initializeGlobalAppLogLevel ();
+    nfa_dm_startup_cfg_id = getStartupConfigId ();
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    nfc_cap_open_config (".nfa");
+#endif
 
     GKI_init ();
     GKI_enable ();
@@ -138,6 +179,12 @@ void NfcAdaptation::Finalize()
 
     ALOGD ("%s: enter", func);
     GKI_shutdown ();
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    nfc_cap_close ();
+#endif
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    nfc_lat_dump ();
+#endif
 
     resetConfig();
 
@@ -42,7 +42,7 @@ extern "C"
 *******************************************************************************/
 void ScrLog (UINT32 trace_set_mask, const char *fmt_str, ...)
 {
-    static char buffer[BTE_LOG_BUF_SIZE];
+    char buffer[BTE_LOG_BUF_SIZE];
     va_list ap;
 
     va_start(ap, fmt_str);
@@ -63,7 +63,7 @@ void ScrLog (UINT32 trace_set_mask, const char *fmt_str, ...)
 *******************************************************************************/
 void LogMsg (UINT32 trace_set_mask, const char *fmt_str, ...)
 {
-    static char buffer[BTE_LOG_BUF_SIZE];
+    char buffer[BTE_LOG_BUF_SIZE];
     va_list ap;
     UINT32 trace_type = trace_set_mask & 0x07; //lower 3 bits contain trace type
     int android_log_type = ANDROID_LOG_INFO;
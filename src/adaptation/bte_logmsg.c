@@ -20,11 +20,33 @@
 #include <stdarg.h>
 #include <time.h>
 #include <sys/time.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include "bt_target.h"
 #include "gki.h"
 
 #define BT_USE_TRACES   TRUE
 
+/* Record traces in per-thread rings and format them on a drain thread */
+#ifndef BTE_DEFERRED_TRACE
+#define BTE_DEFERRED_TRACE          TRUE
+#endif
+
+/* Number of trace records buffered per thread; must be a power of 2 */
+#ifndef BTE_TRACE_RING_SIZE
+#define BTE_TRACE_RING_SIZE         256
+#endif
+
+/* Max number of threads with their own trace ring */
+#ifndef BTE_TRACE_MAX_RINGS
+#define BTE_TRACE_MAX_RINGS         16
+#endif
+
+/* Time (ms) recorded traces are left to collect before they are formatted */
+#ifndef BTE_TRACE_DRAIN_INTERVAL
+#define BTE_TRACE_DRAIN_INTERVAL    50
+#endif
+
 #if MMI_INCLUDED == TRUE
 #include "mmi.h"
 #endif
@@ -107,6 +129,397 @@ ScrLog(UINT32 maskTraceSet, const char *strFormat, ...)
 }
 #endif
 
+#if (BTE_DEFERRED_TRACE == TRUE)
+/********************************************************************************
+**
+**  Deferred trace
+**
+**  LogMsg_x() only records the trace set mask, format string and raw arguments
+**  with a timestamp in a ring owned by the calling thread. A drain thread merges
+**  the rings in time order and formats the records with LogMsg() later on, so
+**  the caller never pays for vsnprintf() or the log write.
+**
+**  Errors and traces with string arguments (which may not outlive the caller)
+**  are still written out at once.
+**
+*********************************************************************************/
+
+/* ring states */
+#define BTE_TRACE_RING_FREE     0   /* may be taken by a new thread */
+#define BTE_TRACE_RING_ACTIVE   1   /* owned by a thread */
+#define BTE_TRACE_RING_EXITED   2   /* owner is gone; freed once drained */
+
+#define BTE_TRACE_RING_MASK     (BTE_TRACE_RING_SIZE - 1)
+#define BTE_TRACE_MAX_LEN       1000
+
+typedef struct
+{
+    UINT64          time_ns;            /* CLOCK_MONOTONIC when recorded */
+    UINT32          trace_set_mask;     /* layer, origin and type of trace */
+    const char      *p_fmt;             /* format string, identifies the trace */
+    UINT32          args[6];
+} tBTE_TRACE_REC;
+
+typedef struct
+{
+    tBTE_TRACE_REC  rec[BTE_TRACE_RING_SIZE];
+    volatile UINT32 head;               /* written by the owner thread only */
+    volatile UINT32 tail;               /* written by the drain thread only */
+    volatile UINT32 dropped;            /* records lost while the ring was full */
+    UINT32          reported;           /* dropped records already reported */
+    volatile UINT32 state;              /* BTE_TRACE_RING_xxx */
+} tBTE_TRACE_RING;
+
+static tBTE_TRACE_RING * volatile bte_trace_rings[BTE_TRACE_MAX_RINGS];
+static pthread_once_t   bte_trace_once = PTHREAD_ONCE_INIT;
+static pthread_key_t    bte_trace_key;
+static pthread_mutex_t  bte_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   bte_trace_cond  = PTHREAD_COND_INITIALIZER;
+static volatile UINT32  bte_trace_idle  = FALSE;    /* drain thread waits for a record */
+static BOOLEAN          bte_trace_started = FALSE;
+
+/*******************************************************************************
+**
+** Function         bte_trace_has_str
+**
+** Description      Check if a format string has a %s conversion.
+**
+** Returns          TRUE if so
+**
+*******************************************************************************/
+static BOOLEAN bte_trace_has_str (const char *p_fmt)
+{
+    while ((p_fmt = strchr (p_fmt, '%')) != NULL)
+    {
+        p_fmt++;
+        /* skip flags, width, precision and length */
+        while ((*p_fmt) && (strchr ("-+ #0123456789.lhz", *p_fmt) != NULL))
+            p_fmt++;
+
+        if (*p_fmt == 's')
+            return (TRUE);
+        if (*p_fmt == 0)
+            break;
+        p_fmt++;
+    }
+    return (FALSE);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_pending
+**
+** Description      Check if any trace ring has records to drain.
+**
+** Returns          TRUE if so
+**
+*******************************************************************************/
+static BOOLEAN bte_trace_pending (void)
+{
+    tBTE_TRACE_RING *p_ring;
+    int xx;
+
+    for (xx = 0; xx < BTE_TRACE_MAX_RINGS; xx++)
+    {
+        p_ring = bte_trace_rings[xx];
+        if ((p_ring) && (p_ring->head != p_ring->tail))
+            return (TRUE);
+    }
+    return (FALSE);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_now_ns
+**
+** Description      Get the time used to stamp traces.
+**
+** Returns          monotonic time in nanoseconds
+**
+*******************************************************************************/
+static UINT64 bte_trace_now_ns (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return ((UINT64) now.tv_sec * 1000000000 + now.tv_nsec);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_write
+**
+** Description      Format a trace and write it out with LogMsg(), prefixed
+**                  with the time it was made, so that traces written at once
+**                  and deferred ones can be put back in order.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void bte_trace_write (UINT32 maskTraceSet, UINT64 time_ns, const char *strFormat,
+                             UINT32 p1, UINT32 p2, UINT32 p3, UINT32 p4, UINT32 p5, UINT32 p6)
+{
+    char buffer[BTE_TRACE_MAX_LEN];
+
+    snprintf (buffer, sizeof (buffer), strFormat, p1, p2, p3, p4, p5, p6);
+    LogMsg (maskTraceSet, "[%lu.%06lu] %s",
+            (unsigned long) (time_ns / 1000000000),
+            (unsigned long) ((time_ns / 1000) % 1000000), buffer);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_drain
+**
+** Description      Format and write out all recorded traces, oldest first.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void bte_trace_drain (void)
+{
+    tBTE_TRACE_RING *p_ring, *p_oldest;
+    tBTE_TRACE_REC  *p_rec, *p_oldest_rec;
+    UINT32  dropped;
+    int     xx;
+
+    for (;;)
+    {
+        p_oldest     = NULL;
+        p_oldest_rec = NULL;
+
+        for (xx = 0; xx < BTE_TRACE_MAX_RINGS; xx++)
+        {
+            if ((p_ring = bte_trace_rings[xx]) == NULL)
+                continue;
+
+            dropped = p_ring->dropped;
+            if (dropped != p_ring->reported)
+            {
+                LogMsg (TRACE_CTRL_GENERAL | TRACE_LAYER_NONE | TRACE_ORG_STACK | TRACE_TYPE_WARNING,
+                        "%lu trace records lost", (unsigned long) (dropped - p_ring->reported));
+                p_ring->reported = dropped;
+            }
+
+            if (p_ring->head == p_ring->tail)
+            {
+                /* give the ring of an exited thread to the next new thread */
+                if (p_ring->state == BTE_TRACE_RING_EXITED)
+                    __sync_bool_compare_and_swap (&p_ring->state, BTE_TRACE_RING_EXITED, BTE_TRACE_RING_FREE);
+                continue;
+            }
+
+            p_rec = &p_ring->rec[p_ring->tail & BTE_TRACE_RING_MASK];
+            if ((p_oldest_rec == NULL) || (p_rec->time_ns < p_oldest_rec->time_ns))
+            {
+                p_oldest     = p_ring;
+                p_oldest_rec = p_rec;
+            }
+        }
+
+        if (p_oldest == NULL)
+            break;
+
+        /* record is read only after the head which published it */
+        __sync_synchronize ();
+
+        bte_trace_write (p_oldest_rec->trace_set_mask, p_oldest_rec->time_ns, p_oldest_rec->p_fmt,
+                         p_oldest_rec->args[0], p_oldest_rec->args[1], p_oldest_rec->args[2],
+                         p_oldest_rec->args[3], p_oldest_rec->args[4], p_oldest_rec->args[5]);
+
+        __sync_synchronize ();
+        p_oldest->tail++;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_drain_thread
+**
+** Description      Drain the trace rings. Sleeps while they are all empty, and
+**                  lets new records collect for BTE_TRACE_DRAIN_INTERVAL ms
+**                  before formatting them.
+**
+** Returns          never
+**
+*******************************************************************************/
+static void *bte_trace_drain_thread (void *p_arg)
+{
+    struct timespec deadline;
+
+    pthread_mutex_lock (&bte_trace_mutex);
+    for (;;)
+    {
+        pthread_mutex_unlock (&bte_trace_mutex);
+        bte_trace_drain ();
+        pthread_mutex_lock (&bte_trace_mutex);
+
+        bte_trace_idle = TRUE;
+        __sync_synchronize ();
+        if (bte_trace_pending ())
+            bte_trace_idle = FALSE;
+
+        while (bte_trace_idle)
+            pthread_cond_wait (&bte_trace_cond, &bte_trace_mutex);
+
+        clock_gettime (CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (BTE_TRACE_DRAIN_INTERVAL % 1000) * 1000000;
+        deadline.tv_sec  += (BTE_TRACE_DRAIN_INTERVAL / 1000) + (deadline.tv_nsec / 1000000000);
+        deadline.tv_nsec %= 1000000000;
+        pthread_cond_timedwait (&bte_trace_cond, &bte_trace_mutex, &deadline);
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_thread_exit
+**
+** Description      Called when a thread owning a trace ring exits.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void bte_trace_thread_exit (void *p_data)
+{
+    tBTE_TRACE_RING *p_ring = (tBTE_TRACE_RING *) p_data;
+
+    p_ring->state = BTE_TRACE_RING_EXITED;
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_init
+**
+** Description      Start the drain thread. Called once.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void bte_trace_init (void)
+{
+    pthread_attr_t  attr;
+    pthread_t       thread_id;
+
+    if (pthread_key_create (&bte_trace_key, bte_trace_thread_exit) != 0)
+        return;
+
+    pthread_attr_init (&attr);
+    pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create (&thread_id, &attr, bte_trace_drain_thread, NULL) == 0)
+        bte_trace_started = TRUE;
+    pthread_attr_destroy (&attr);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_get_ring
+**
+** Description      Get the trace ring of the calling thread, taking a free one
+**                  on first use.
+**
+** Returns          the ring, or NULL if none is available
+**
+*******************************************************************************/
+static tBTE_TRACE_RING *bte_trace_get_ring (void)
+{
+    tBTE_TRACE_RING *p_ring;
+    int xx;
+
+    pthread_once (&bte_trace_once, bte_trace_init);
+    if (!bte_trace_started)
+        return (NULL);
+
+    if ((p_ring = (tBTE_TRACE_RING *) pthread_getspecific (bte_trace_key)) != NULL)
+        return (p_ring);
+
+    for (xx = 0; xx < BTE_TRACE_MAX_RINGS; xx++)
+    {
+        p_ring = bte_trace_rings[xx];
+        if (p_ring == NULL)
+        {
+            if ((p_ring = (tBTE_TRACE_RING *) calloc (1, sizeof (tBTE_TRACE_RING))) == NULL)
+                return (NULL);
+
+            p_ring->state = BTE_TRACE_RING_ACTIVE;
+            if (!__sync_bool_compare_and_swap (&bte_trace_rings[xx], NULL, p_ring))
+            {
+                /* another thread took this slot */
+                free (p_ring);
+                continue;
+            }
+        }
+        else if (!__sync_bool_compare_and_swap (&p_ring->state, BTE_TRACE_RING_FREE, BTE_TRACE_RING_ACTIVE))
+        {
+            continue;
+        }
+
+        pthread_setspecific (bte_trace_key, p_ring);
+        return (p_ring);
+    }
+
+    return (NULL);
+}
+
+/*******************************************************************************
+**
+** Function         bte_trace_put
+**
+** Description      Record a trace in the ring of the calling thread.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void bte_trace_put (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
+                           UINT32 p3, UINT32 p4, UINT32 p5, UINT32 p6)
+{
+    tBTE_TRACE_RING *p_ring;
+    tBTE_TRACE_REC  *p_rec;
+    UINT32 head;
+
+    if (  (TRACE_GET_TYPE (maskTraceSet) == TRACE_TYPE_ERROR)
+        ||(bte_trace_has_str (strFormat))
+        ||((p_ring = bte_trace_get_ring ()) == NULL)  )
+    {
+        bte_trace_write (maskTraceSet, bte_trace_now_ns (), strFormat, p1, p2, p3, p4, p5, p6);
+        return;
+    }
+
+    head = p_ring->head;
+    if (head - p_ring->tail >= BTE_TRACE_RING_SIZE)
+    {
+        p_ring->dropped++;
+        return;
+    }
+
+    p_rec                 = &p_ring->rec[head & BTE_TRACE_RING_MASK];
+    p_rec->time_ns        = bte_trace_now_ns ();
+    p_rec->trace_set_mask = maskTraceSet;
+    p_rec->p_fmt          = strFormat;
+    p_rec->args[0]        = p1;
+    p_rec->args[1]        = p2;
+    p_rec->args[2]        = p3;
+    p_rec->args[3]        = p4;
+    p_rec->args[4]        = p5;
+    p_rec->args[5]        = p6;
+
+    /* record must be complete before the new head is seen */
+    __sync_synchronize ();
+    p_ring->head = ++head;
+    __sync_synchronize ();
+
+    /* wake the drain thread if it sleeps, or early if the ring fills up */
+    if (  ((bte_trace_idle) && (__sync_bool_compare_and_swap (&bte_trace_idle, TRUE, FALSE)))
+        ||(head - p_ring->tail == BTE_TRACE_RING_SIZE / 2)  )
+    {
+        pthread_mutex_lock (&bte_trace_mutex);
+        pthread_cond_signal (&bte_trace_cond);
+        pthread_mutex_unlock (&bte_trace_mutex);
+    }
+}
+#endif /* BTE_DEFERRED_TRACE */
+
 /********************************************************************************
 **
 **    Function Name:   LogMsg_0
@@ -121,6 +534,9 @@ ScrLog(UINT32 maskTraceSet, const char *strFormat, ...)
 *********************************************************************************/
 void LogMsg_0 (UINT32 maskTraceSet, const char *strFormat)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, 0, 0, 0, 0, 0, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -147,8 +563,7 @@ void LogMsg_0 (UINT32 maskTraceSet, const char *strFormat)
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat);
 #endif
-
-
+#endif
 }
 
 /********************************************************************************
@@ -165,6 +580,9 @@ void LogMsg_0 (UINT32 maskTraceSet, const char *strFormat)
 *********************************************************************************/
 void LogMsg_1 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, 0, 0, 0, 0, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -191,6 +609,7 @@ void LogMsg_1 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1)
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1);
 #endif
+#endif
 }
 
 /********************************************************************************
@@ -207,6 +626,9 @@ void LogMsg_1 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1)
 *********************************************************************************/
 void LogMsg_2 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, p2, 0, 0, 0, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -233,6 +655,7 @@ void LogMsg_2 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2)
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1, p2);
 #endif
+#endif
 }
 
 /********************************************************************************
@@ -249,6 +672,9 @@ void LogMsg_2 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2)
 *********************************************************************************/
 void LogMsg_3 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2, UINT32 p3)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, p2, p3, 0, 0, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -275,6 +701,7 @@ void LogMsg_3 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1, p2, p3);
 #endif
+#endif
 }
 
 /********************************************************************************
@@ -292,6 +719,9 @@ void LogMsg_3 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
 void LogMsg_4 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
                UINT32 p3, UINT32 p4)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, p2, p3, p4, 0, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -318,6 +748,7 @@ void LogMsg_4 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1, p2, p3, p4);
 #endif
+#endif
 }
 
 /********************************************************************************
@@ -335,6 +766,9 @@ void LogMsg_4 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
 void LogMsg_5 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
                UINT32 p3, UINT32 p4, UINT32 p5)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, p2, p3, p4, p5, 0);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -361,6 +795,7 @@ void LogMsg_5 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1, p2, p3, p4, p5);
 #endif
+#endif
 }
 
 /********************************************************************************
@@ -378,6 +813,9 @@ void LogMsg_5 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
 void LogMsg_6 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
                UINT32 p3, UINT32 p4, UINT32 p5, UINT32 p6)
 {
+#if (BTE_DEFERRED_TRACE == TRUE)
+    bte_trace_put (maskTraceSet, strFormat, p1, p2, p3, p4, p5, p6);
+#else
     if (bte_target_mode == BTE_MODE_APPL)
     {
 #if RPC_INCLUDED == TRUE
@@ -405,7 +843,7 @@ void LogMsg_6 (UINT32 maskTraceSet, const char *strFormat, UINT32 p1, UINT32 p2,
     else if (bte_target_mode == BTE_MODE_DONGLE)
         bte_hcisl_send_traces(maskTraceSet, strFormat, p1, p2, p3, p4, p5, p6);
 #endif
-
+#endif
 }
 
 #endif /* BT_USE_TRACES */
@@ -25,6 +25,7 @@
 #include "nfa_nv_co.h"
 #include "nfa_nv_ci.h"
 #include "config.h"
+#include "nfc_capture.h"
 
 #define LOG_TAG "BrcmNfcNfa"
 #define PRINT(s) __android_log_write(ANDROID_LOG_DEBUG, "BrcmNci", s)
@@ -109,19 +110,28 @@ NFC_API extern void nfa_nv_co_read(UINT8 *pBuffer, UINT16 nbytes, UINT8 block)
         if (actualRead > 0)
         {
             ALOGD ("%s: read bytes=%u", __FUNCTION__, actualRead);
-            nfa_nv_ci_read (actualRead, NFA_NV_CO_OK, block);
+            if (block == DM_NV_BLOCK)
+                nfa_dm_nv_ci_read (actualRead, NFA_NV_CO_OK);
+            else
+                nfa_nv_ci_read (actualRead, NFA_NV_CO_OK, block);
         }
         else
         {
             ALOGE ("%s: fail to read", __FUNCTION__);
-            nfa_nv_ci_read (actualRead, NFA_NV_CO_FAIL, block);
+            if (block == DM_NV_BLOCK)
+                nfa_dm_nv_ci_read (actualRead, NFA_NV_CO_FAIL);
+            else
+                nfa_nv_ci_read (actualRead, NFA_NV_CO_FAIL, block);
         }
         close (fileStream);
     }
     else
     {
         ALOGE ("%s: fail to open", __FUNCTION__);
-        nfa_nv_ci_read (0, NFA_NV_CO_FAIL, block);
+        if (block == DM_NV_BLOCK)
+            nfa_dm_nv_ci_read (0, NFA_NV_CO_FAIL);
+        else
+            nfa_nv_ci_read (0, NFA_NV_CO_FAIL, block);
     }
 }
 
@@ -164,19 +174,28 @@ NFC_API extern void nfa_nv_co_write(const UINT8 *pBuffer, UINT16 nbytes, UINT8 b
         size_t actualWritten = write (fileStream, pBuffer, nbytes);
         ALOGD ("%s: %d bytes written", __FUNCTION__, actualWritten);
         if (actualWritten > 0) {
-            nfa_nv_ci_write (NFA_NV_CO_OK);
+            if (block == DM_NV_BLOCK)
+                nfa_dm_nv_ci_write (NFA_NV_CO_OK);
+            else
+                nfa_nv_ci_write (NFA_NV_CO_OK);
         }
         else
         {
             ALOGE ("%s: fail to write", __FUNCTION__);
-            nfa_nv_ci_write (NFA_NV_CO_FAIL);
+            if (block == DM_NV_BLOCK)
+                nfa_dm_nv_ci_write (NFA_NV_CO_FAIL);
+            else
+                nfa_nv_ci_write (NFA_NV_CO_FAIL);
         }
         close (fileStream);
     }
     else
     {
         ALOGE ("%s: fail to open, error = %d", __FUNCTION__, errno);
-        nfa_nv_ci_write (NFA_NV_CO_FAIL);
+        if (block == DM_NV_BLOCK)
+            nfa_dm_nv_ci_write (NFA_NV_CO_FAIL);
+        else
+            nfa_nv_ci_write (NFA_NV_CO_FAIL);
     }
 }
 
@@ -416,6 +435,12 @@ void DispHciEvt (BT_HDR *p_buf)
 *******************************************************************************/
 void DispNciDump (UINT8 *data, UINT16 len, BOOLEAN is_recv)
 {
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    if (nfc_cap_active)
+        nfc_cap_write (NFC_CAP_PROTO_NCI, (UINT8) ((is_recv ? NFC_CAP_FLAG_RX : 0) | NFC_CAP_FLAG_REASSEMBLED),
+                       (UINT8) (data[0] & 0x0F), data, len);
+#endif
+
     if (!(ScrProtocolTraceFlag & SCR_PROTO_TRACE_NCI))
         return;
 
@@ -450,6 +475,12 @@ void DispLLCP (BT_HDR *p_buf, BOOLEAN is_recv)
     UINT8 * data = (UINT8*) p_buf;
     int data_len = BT_HDR_SIZE + p_buf->offset + p_buf->len;
 
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    if (nfc_cap_active)
+        nfc_cap_write (NFC_CAP_PROTO_LLCP, (UINT8) (is_recv ? NFC_CAP_FLAG_RX : 0), 0,
+                       (UINT8 *) (p_buf + 1) + p_buf->offset, p_buf->len);
+#endif
+
     if (appl_trace_level < BT_TRACE_LEVEL_DEBUG)
         return;
 
@@ -482,6 +513,11 @@ void DispHcp (UINT8 *data, UINT16 len, BOOLEAN is_recv)
     int nBytes = (len*2)+1;
     char line_buf[400];
 
+#if (NFC_CAPTURE_INCLUDED == TRUE)
+    if ((nfc_cap_active) && (len > 0))
+        nfc_cap_write (NFC_CAP_PROTO_HCP, (UINT8) (is_recv ? NFC_CAP_FLAG_RX : 0), (UINT8) (data[0] & 0x7F), data, len);
+#endif
+
     if (appl_trace_level < BT_TRACE_LEVEL_DEBUG)
         return;
 
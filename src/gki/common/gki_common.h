@@ -25,6 +25,47 @@
 #define GKI_DEBUG	FALSE
 #endif
 
+/* TRUE to take and return free buffers with compare-and-swap instead of GKI_disable() */
+#ifndef GKI_USE_LOCKFREE_BUF_POOLS
+#define GKI_USE_LOCKFREE_BUF_POOLS      TRUE
+#endif
+
+/* Number of free buffers per pool each task keeps for itself (lock-free pools only, 0 to disable) */
+#ifndef GKI_BUF_TASK_CACHE_SIZE
+#define GKI_BUF_TASK_CACHE_SIZE         0
+#endif
+
+/* TRUE if the OS timer thread sleeps until the next timer expiration instead of
+** waking up every tick. The OS layer then provides gki_timer_catch_up(),
+** gki_timer_get_ticks() and gki_timer_rearm(). */
+#ifndef GKI_USE_TICKLESS_TIMER
+#define GKI_USE_TICKLESS_TIMER          TRUE
+#endif
+
+/* TRUE to let GKI_read_mbox() take the whole mailbox list in one critical
+** section and hand it out from a task private batch afterwards */
+#ifndef GKI_BATCH_MBOX_READ
+#define GKI_BATCH_MBOX_READ             TRUE
+#endif
+
+/* TRUE to give each buffer a time slot for GKI_set_buf_time()/GKI_get_buf_time() */
+#ifndef GKI_BUF_TIME_INCLUDED
+#define GKI_BUF_TIME_INCLUDED           TRUE
+#endif
+
+/* GKI_getbuf() size classes are (1 << GKI_BUF_SIZE_CLASS_SHIFT) bytes wide */
+#ifndef GKI_BUF_SIZE_CLASS_SHIFT
+#define GKI_BUF_SIZE_CLASS_SHIFT        5
+#endif
+#define GKI_NUM_BUF_SIZE_CLASSES        ((0xFFFF >> GKI_BUF_SIZE_CLASS_SHIFT) + 1)
+
+/* TRUE if the mailbox of task t still holds messages for GKI_read_mbox() */
+#if (GKI_BATCH_MBOX_READ == TRUE)
+#define GKI_MBOX_NOT_EMPTY(t, m)        ((gki_cb.com.OSTaskQFirst[t][m] != NULL) || (gki_cb.com.OSTaskQBatch[t][m] != NULL))
+#else
+#define GKI_MBOX_NOT_EMPTY(t, m)        (gki_cb.com.OSTaskQFirst[t][m] != NULL)
+#endif
+
 /* Task States: (For OSRdyTbl) */
 #define TASK_DEAD       0   /* b0000 */
 #define TASK_READY      1   /* b0001 */
@@ -67,6 +108,9 @@ typedef struct _buffer_hdr
     UINT8   task_id;              /* task which allocated the buffer*/
     UINT8   status;               /* FREE, UNLINKED or QUEUED */
     UINT8   Type;
+#if (GKI_BUF_TIME_INCLUDED == TRUE)
+    UINT32  time;                 /* set by GKI_set_buf_time(), 0 when freed */
+#endif
 
 #if GKI_BUFFER_DEBUG
     /* for tracking who allocated the buffer */
@@ -83,8 +127,11 @@ typedef struct _free_queue
     BUFFER_HDR_T *p_last;       /* last buffer in the queue */
     UINT16          size;          /* size of the buffers in the pool */
     UINT16          total;         /* toatal number of buffers */
-    UINT16          cur_cnt;       /* number of  buffers currently allocated */
-    UINT16          max_cnt;       /* maximum number of buffers allocated at any time */
+    volatile UINT16 cur_cnt;       /* number of  buffers currently allocated */
+    volatile UINT16 max_cnt;       /* maximum number of buffers allocated at any time */
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE)
+    volatile UINT32 lf_head;       /* lock-free free list: index of first buffer | ABA tag << 16 */
+#endif
 } FREE_QUEUE_T;
 
 
@@ -114,6 +161,14 @@ typedef struct
 #endif
 
 
+/* Size class table used by GKI_getbuf() to find the public pools for a size */
+typedef struct
+{
+    UINT8       pools[GKI_NUM_TOTAL_BUF_POOLS];     /* public pools arranged in the order of size */
+    UINT8       num_pools;                          /* number of entries in pools */
+    UINT8       first[GKI_NUM_BUF_SIZE_CLASSES];    /* first entry in pools for each size class */
+} tGKI_SIZE_CLASS_TBL;
+
 /* Put all GKI variables into one control block
 */
 typedef struct
@@ -309,6 +364,9 @@ typedef struct
     */
     BUFFER_HDR_T    *OSTaskQFirst[GKI_MAX_TASKS][NUM_TASK_MBOX]; /* array of pointers to the first event in the task mailbox */
     BUFFER_HDR_T    *OSTaskQLast [GKI_MAX_TASKS][NUM_TASK_MBOX]; /* array of pointers to the last event in the task mailbox */
+#if (GKI_BATCH_MBOX_READ == TRUE)
+    BUFFER_HDR_T    *OSTaskQBatch[GKI_MAX_TASKS][NUM_TASK_MBOX]; /* messages already taken from the mailbox by its owner task */
+#endif
 
     /* Define the buffer pool management variables
     */
@@ -330,6 +388,17 @@ typedef struct
     UINT8       pool_list[GKI_NUM_TOTAL_BUF_POOLS]; /* buffer pools arranged in the order of size */
     UINT8       curr_total_no_of_pools;             /* number of fixed buf pools + current number of dynamic pools */
 
+    /* Size class tables for GKI_getbuf(), rebuilt whenever the pool list or permissions change.
+    ** A new table is built in the one not in use and then swapped in. */
+    tGKI_SIZE_CLASS_TBL  size_class_tbl[2];
+    tGKI_SIZE_CLASS_TBL *volatile p_size_class; /* table in use by GKI_getbuf() */
+
+#if (GKI_USE_LOCKFREE_BUF_POOLS == TRUE) && (GKI_BUF_TASK_CACHE_SIZE > 0)
+    /* free buffers kept by each task; only accessed by the owning task */
+    BUFFER_HDR_T *task_buf_cache[GKI_MAX_TASKS][GKI_NUM_TOTAL_BUF_POOLS][GKI_BUF_TASK_CACHE_SIZE];
+    UINT8         task_buf_cache_cnt[GKI_MAX_TASKS][GKI_NUM_TOTAL_BUF_POOLS];
+#endif
+
     BOOLEAN     timer_nesting;                      /* flag to prevent timer interrupt nesting */
 
     /* Time queue arrays */
@@ -357,6 +426,11 @@ extern BOOLEAN   gki_chk_buf_owner(void *);
 extern void      gki_buffer_init (void);
 extern void      gki_timers_init(void);
 extern void      gki_adjust_timer_count (INT32);
+#if (GKI_USE_TICKLESS_TIMER == TRUE)
+extern void      gki_timer_catch_up (void);
+extern UINT32    gki_timer_get_ticks (void);
+extern void      gki_timer_rearm (void);
+#endif
 
 extern void    OSStartRdy(void);
 extern void	   OSCtxSw(void);
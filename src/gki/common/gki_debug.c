@@ -19,6 +19,11 @@
 
 #if (GKI_DEBUG == TRUE)
 
+#include <time.h>
+
+/* Number of buffers held at once in the burst pass of GKI_BufferBenchmark() */
+#define GKI_BENCH_BURST_SIZE    16
+
 const INT8 * const OSTaskStates[] =
 {
     (INT8 *)"DEAD",  /* 0 */
@@ -350,4 +355,198 @@ void gki_dump4 (UINT32 *s, UINT16 len, FP_PRINT print)
 }
 
 
+/*******************************************************************************
+**
+** Function         gki_bench_now_us
+**
+** Description      Monotonic time for GKI_BufferBenchmark()
+**
+** Returns          time in microseconds
+**
+*******************************************************************************/
+static UINT32 gki_bench_now_us (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((UINT32) ts.tv_sec * 1000000 + (UINT32) (ts.tv_nsec / 1000));
+}
+
+/*******************************************************************************
+**
+** Function         GKI_BufferBenchmark
+**
+** Description      Measures GKI buffer throughput of every configured pool
+**                  and prints the average time of one allocate/free pair in
+**                  nanoseconds for:
+**                    - GKI_getpoolbuf()/GKI_freebuf() of a single buffer
+**                    - GKI_getpoolbuf() of up to GKI_BENCH_BURST_SIZE buffers
+**                      followed by GKI_freebuf() of all of them
+**                    - GKI_getbuf()/GKI_freebuf() of the pool buffer size
+**                      (public pools only, through the size class table)
+**
+**                  Should be called while the stack is idle, as it takes the
+**                  free buffers of each pool in turn.
+**
+** Parameters       loops - (input) number of allocate/free pairs per pass
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_BufferBenchmark (UINT32 loops)
+{
+    tGKI_COM_CB *p_cb = &gki_cb.com;
+    void        *p_bufs[GKI_BENCH_BURST_SIZE];
+    UINT32      start, single_ns, burst_ns, getbuf_ns;
+    UINT32      xx, yy, done, burst;
+    UINT8       pool_id;
+
+    if (loops == 0)
+        return;
+
+    GKI_TRACE_1("--- GKI Buffer Benchmark (%u loops, ns per get/free) ---", loops);
+    GKI_TRACE_0("POOL     SIZE  SINGLE  BURST  GETBUF");
+
+    for (pool_id = 0; pool_id < GKI_NUM_TOTAL_BUF_POOLS; pool_id++)
+    {
+        if ((p_cb->freeq[pool_id].total == 0) || (p_cb->freeq[pool_id].cur_cnt >= p_cb->freeq[pool_id].total))
+            continue;
+
+        /* Single buffer */
+        start = gki_bench_now_us ();
+        for (xx = 0; xx < loops; xx++)
+        {
+            if ((p_bufs[0] = GKI_getpoolbuf (pool_id)) == NULL)
+                break;
+            GKI_freebuf (p_bufs[0]);
+        }
+        single_ns = (xx) ? (UINT32) (((UINT64) (gki_bench_now_us () - start) * 1000) / xx) : 0;
+
+        /* Burst of buffers */
+        burst = p_cb->freeq[pool_id].total - p_cb->freeq[pool_id].cur_cnt;
+        if (burst > GKI_BENCH_BURST_SIZE)
+            burst = GKI_BENCH_BURST_SIZE;
+
+        start = gki_bench_now_us ();
+        for (xx = 0, done = 0; xx < loops; xx += burst)
+        {
+            for (yy = 0; yy < burst; yy++)
+            {
+                if ((p_bufs[yy] = GKI_getpoolbuf (pool_id)) == NULL)
+                    break;
+            }
+            done += yy;
+            while (yy > 0)
+                GKI_freebuf (p_bufs[--yy]);
+        }
+        burst_ns = (done) ? (UINT32) (((UINT64) (gki_bench_now_us () - start) * 1000) / done) : 0;
+
+        /* GKI_getbuf() of the pool size */
+        getbuf_ns = 0;
+        if (!(((UINT16)1 << pool_id) & p_cb->pool_access_mask))
+        {
+            start = gki_bench_now_us ();
+            for (xx = 0; xx < loops; xx++)
+            {
+                if ((p_bufs[0] = GKI_getbuf (p_cb->freeq[pool_id].size)) == NULL)
+                    break;
+                GKI_freebuf (p_bufs[0]);
+            }
+            getbuf_ns = (xx) ? (UINT32) (((UINT64) (gki_bench_now_us () - start) * 1000) / xx) : 0;
+        }
+
+        GKI_TRACE_6("%02d: (%c), %4d, %6u, %5u, %6u", pool_id,
+                    (((UINT16)1 << pool_id) & p_cb->pool_access_mask) ? 'R' : 'P',
+                    p_cb->freeq[pool_id].size, single_ns, burst_ns, getbuf_ns);
+    }
+}
+
+/*******************************************************************************
+**
+** Function         GKI_TimerListBenchmark
+**
+** Description      Stress test of the timer list functions. Starts num_timers
+**                  timers of 1 to max_ticks units, restarts every other one,
+**                  then updates the list a unit at a time until all of them
+**                  have expired, the way the protocol timer tasks do. Prints
+**                  the average time per timer of each phase in nanoseconds and
+**                  the number of timers that did not expire on time.
+**
+** Parameters       num_timers - (input) number of concurrent timers
+**                  max_ticks  - (input) longest timer, in timer list units
+**
+** Returns          void
+**
+*******************************************************************************/
+void GKI_TimerListBenchmark (UINT16 num_timers, UINT32 max_ticks)
+{
+    TIMER_LIST_Q    timer_q;
+    TIMER_LIST_ENT  *p_tles, *p_tle;
+    UINT32          seed = 1;
+    UINT32          start, add_ns, restart_ns, expire_ns;
+    UINT32          xx, units = 0, expired = 0, errors = 0;
+
+    if ((num_timers == 0) || (max_ticks == 0))
+        return;
+
+    if ((p_tles = (TIMER_LIST_ENT *) GKI_os_malloc (num_timers * sizeof (TIMER_LIST_ENT))) == NULL)
+        return;
+
+    GKI_init_timer_list (&timer_q);
+    for (xx = 0; xx < num_timers; xx++)
+        GKI_init_timer_list_entry (&p_tles[xx]);
+
+    /* Start all timers; param holds the unit each one should expire in */
+    start = gki_bench_now_us ();
+    for (xx = 0; xx < num_timers; xx++)
+    {
+        seed = seed * 1103515245 + 12345;
+        p_tles[xx].ticks = 1 + (INT32) ((seed >> 8) % max_ticks);
+        p_tles[xx].param = (TIMER_PARAM_TYPE) p_tles[xx].ticks;
+        GKI_add_to_timer_list (&timer_q, &p_tles[xx]);
+    }
+    add_ns = (UINT32) (((UINT64) (gki_bench_now_us () - start) * 1000) / num_timers);
+
+    /* Restart every other timer */
+    start = gki_bench_now_us ();
+    for (xx = 0; xx < num_timers; xx += 2)
+    {
+        GKI_remove_from_timer_list (&timer_q, &p_tles[xx]);
+
+        seed = seed * 1103515245 + 12345;
+        p_tles[xx].ticks = 1 + (INT32) ((seed >> 8) % max_ticks);
+        p_tles[xx].param = (TIMER_PARAM_TYPE) p_tles[xx].ticks;
+        GKI_add_to_timer_list (&timer_q, &p_tles[xx]);
+    }
+    restart_ns = (UINT32) (((UINT64) (gki_bench_now_us () - start) * 2000) / num_timers);
+
+    /* Run the list until empty */
+    start = gki_bench_now_us ();
+    while ((timer_q.p_first) && (units <= max_ticks))
+    {
+        GKI_update_timer_list (&timer_q, 1);
+        units++;
+
+        while ((timer_q.p_first) && (timer_q.p_first->ticks == 0))
+        {
+            p_tle = timer_q.p_first;
+            GKI_remove_from_timer_list (&timer_q, p_tle);
+
+            if ((UINT32) p_tle->param != units)
+                errors++;
+            expired++;
+        }
+    }
+    expire_ns = (UINT32) (((UINT64) (gki_bench_now_us () - start) * 1000) / num_timers);
+
+    /* Left-overs are errors too */
+    while (timer_q.p_first)
+        GKI_remove_from_timer_list (&timer_q, timer_q.p_first);
+
+    GKI_os_free (p_tles);
+
+    GKI_TRACE_6("--- GKI Timer List Benchmark (%u timers, max %u units): add %u ns, restart %u ns, expire %u ns, %u errors ---",
+                num_timers, max_ticks, add_ns, restart_ns, expire_ns, errors + (num_timers - expired));
+}
+
 #endif
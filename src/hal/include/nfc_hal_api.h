@@ -44,6 +44,11 @@ typedef void (tHAL_NFC_STATUS_CBACK) (tHAL_NFC_STATUS status);
 typedef void (tHAL_NFC_CBACK) (UINT8 event, tHAL_NFC_STATUS status);
 typedef void (tHAL_NFC_DATA_CBACK) (UINT16 data_len, UINT8   *p_data);
 
+/* Data callback passing the ownership of the GKI buffer holding the NCI
+** message (at p_msg->offset) to the callee. Only usable when the HAL and the
+** stack share the same GKI. */
+typedef void (tHAL_NFC_DATA_BUF_CBACK) (NFC_HDR *p_msg);
+
 /*******************************************************************************
 ** tHAL_NFC_ENTRY HAL entry-point lookup table
 *******************************************************************************/
@@ -57,6 +62,7 @@ typedef void (tHAL_API_WRITE) (UINT16 data_len, UINT8 *p_data);
 typedef BOOLEAN (tHAL_API_PREDISCOVER) (void);
 typedef void (tHAL_API_CONTROL_GRANTED) (void);
 typedef void (tHAL_API_POWER_CYCLE) (void);
+typedef void (tHAL_API_SET_DATA_BUF_CBACK) (tHAL_NFC_DATA_BUF_CBACK *p_data_buf_cback);
 
 
 typedef struct
@@ -70,6 +76,7 @@ typedef struct
     tHAL_API_PREDISCOVER *prediscover;
     tHAL_API_CONTROL_GRANTED *control_granted;
     tHAL_API_POWER_CYCLE *power_cycle;
+    tHAL_API_SET_DATA_BUF_CBACK *set_data_buf_cback;   /* optional, NULL if not supported */
 
 
 } tHAL_NFC_ENTRY;
@@ -68,6 +68,8 @@ int GetNumValue(const char* name, void* p_value, unsigned long len);
 #define NAME_XTAL_FREQUENCY             "XTAL_FREQUENCY"
 #define NAME_NFA_DM_DISC_DURATION_POLL  "NFA_DM_DISC_DURATION_POLL"
 #define NAME_AID_FOR_EMPTY_SELECT       "AID_FOR_EMPTY_SELECT"
+#define NAME_NFC_CAPTURE_FILE           "NFC_CAPTURE_FILE"
+#define NAME_NFC_CAPTURE_SIZE           "NFC_CAPTURE_SIZE"
 
 #define                     LPTD_PARAM_LEN (40)
 
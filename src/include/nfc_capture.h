@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Binary packet capture.
+ *
+ *  Raw NCI, LLCP and HCP packets are written with a timestamp into a
+ *  memory-mapped file used as a ring: once the file is full the oldest
+ *  records are overwritten. Captures are turned into readable traces offline
+ *  with tools/nfc_capture/nfc_capture_decode.
+ *
+ *  File layout (little endian, fixed size fields so 32 and 64 bit hosts agree):
+ *      tNFC_CAP_FILE_HDR
+ *      records between hdr_len and file_len, each one a tNFC_CAP_REC_HDR
+ *      followed by the packet and padded to NFC_CAP_REC_ALIGN bytes. A record
+ *      with proto NFC_CAP_PROTO_WRAP, or less than a record header left before
+ *      file_len, means the next record is at hdr_len.
+ *
+ ******************************************************************************/
+#ifndef NFC_CAPTURE_H
+#define NFC_CAPTURE_H
+
+#include <stdint.h>
+#include "data_types.h"
+
+/* Include binary packet capture */
+#ifndef NFC_CAPTURE_INCLUDED
+#define NFC_CAPTURE_INCLUDED        TRUE
+#endif
+
+/* Default size of a capture file */
+#ifndef NFC_CAPTURE_FILE_SIZE
+#define NFC_CAPTURE_FILE_SIZE       (1024 * 1024)
+#endif
+
+/* Max number of bytes of one packet kept in a capture */
+#ifndef NFC_CAPTURE_SNAP_LEN
+#define NFC_CAPTURE_SNAP_LEN        1024
+#endif
+
+#define NFC_CAP_MAGIC               0x5043464E  /* "NFCP" */
+#define NFC_CAP_VERSION             1
+#define NFC_CAP_REC_ALIGN           8
+
+/* Protocol of a captured packet */
+#define NFC_CAP_PROTO_NCI           1
+#define NFC_CAP_PROTO_LLCP          2
+#define NFC_CAP_PROTO_HCP           3
+#define NFC_CAP_PROTO_WRAP          0xFF    /* next record is at start of ring */
+
+/* Flags of a captured packet */
+#define NFC_CAP_FLAG_RX             0x01    /* received from the peer/NFCC */
+#define NFC_CAP_FLAG_TRUNCATED      0x02    /* longer than NFC_CAPTURE_SNAP_LEN */
+#define NFC_CAP_FLAG_REASSEMBLED    0x04    /* NCI data reassembled by the stack */
+
+/* File header */
+typedef struct
+{
+    uint32_t magic;          /* NFC_CAP_MAGIC */
+    uint16_t version;        /* NFC_CAP_VERSION */
+    uint16_t hdr_len;        /* offset of the first record */
+    uint32_t file_len;       /* size of the file */
+    uint32_t head;           /* offset where the next record goes */
+    uint32_t tail;           /* offset of the oldest record */
+    uint32_t count;          /* number of records in the file */
+    uint32_t wraps;          /* number of times the ring wrapped */
+    uint32_t reserved;
+} tNFC_CAP_FILE_HDR;
+
+/* Record header */
+typedef struct
+{
+    uint32_t time_sec;       /* CLOCK_REALTIME */
+    uint32_t time_nsec;
+    uint16_t len;            /* bytes of packet following this header */
+    uint16_t orig_len;       /* length of the packet before truncation */
+    uint8_t  proto;          /* NFC_CAP_PROTO_xxx */
+    uint8_t  flags;          /* NFC_CAP_FLAG_xxx */
+    uint8_t  conn_id;        /* NCI: connection id of data, HCP: pipe id */
+    uint8_t  reserved;
+} tNFC_CAP_REC_HDR;
+
+#define NFC_CAP_REC_LEN(len)        ((sizeof (tNFC_CAP_REC_HDR) + (len) + NFC_CAP_REC_ALIGN - 1) & ~(NFC_CAP_REC_ALIGN - 1))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* TRUE while a capture file is open; checked before calling nfc_cap_write */
+extern volatile BOOLEAN nfc_cap_active;
+
+/*******************************************************************************
+**
+** Function         nfc_cap_open
+**
+** Description      Start capturing into p_path, a file of file_len bytes. An
+**                  existing capture is kept as p_path.old.
+**
+** Returns          TRUE if capture started
+**
+*******************************************************************************/
+extern BOOLEAN nfc_cap_open (const char *p_path, UINT32 file_len);
+
+/*******************************************************************************
+**
+** Function         nfc_cap_open_config
+**
+** Description      Start capturing if NFC_CAPTURE_FILE is configured. The
+**                  capture goes to that file with p_suffix appended.
+**
+** Returns          TRUE if capture started
+**
+*******************************************************************************/
+extern BOOLEAN nfc_cap_open_config (const char *p_suffix);
+
+/*******************************************************************************
+**
+** Function         nfc_cap_close
+**
+** Description      Stop capturing.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_cap_close (void);
+
+/*******************************************************************************
+**
+** Function         nfc_cap_write
+**
+** Description      Capture one packet.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_cap_write (UINT8 proto, UINT8 flags, UINT8 conn_id, const UINT8 *p_data, UINT16 len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NFC_CAPTURE_H */
@@ -0,0 +1,167 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Transaction latency histograms.
+ *
+ *  Each stage keeps a histogram of latencies in microseconds with 8 buckets
+ *  per power of two, so a percentile read from it is within 12.5% of the
+ *  real value. Samples are added with atomic increments and can be recorded
+ *  from any thread.
+ *
+ *  The HAL and the stack are separate libraries and each one records its own
+ *  stages:
+ *      NFC_LAT_HAL_RX      HAL: transport read to NCI message reassembled
+ *      NFC_LAT_NCIF        stack: NCI message from the HAL to
+ *                          nfc_ncif_process_event
+ *      NFC_LAT_NFA         stack: NCI message from the HAL to the
+ *                          nfa_sys_event dispatch it caused
+ *      NFC_LAT_APP         stack: NCI message from the HAL to the connection
+ *                          callback of the application
+ *      NFC_LAT_CMD_RTT     stack: NCI command sent to its response received
+ *
+ ******************************************************************************/
+#ifndef NFC_LATENCY_H
+#define NFC_LATENCY_H
+
+#include <stdint.h>
+#include "data_types.h"
+
+/* Include transaction latency histograms */
+#ifndef NFC_LATENCY_INCLUDED
+#define NFC_LATENCY_INCLUDED        TRUE
+#endif
+
+/* Latency stages */
+#define NFC_LAT_HAL_RX              0
+#define NFC_LAT_NCIF                1
+#define NFC_LAT_NFA                 2
+#define NFC_LAT_APP                 3
+#define NFC_LAT_CMD_RTT             4
+#define NFC_LAT_MAX_STAGES          5
+
+#define NFC_LAT_SUB_BITS            3   /* 2^3 buckets per power of two */
+#define NFC_LAT_NUM_BUCKETS         ((32 - NFC_LAT_SUB_BITS + 1) << NFC_LAT_SUB_BITS)
+
+/* Histogram of one stage */
+typedef struct
+{
+    volatile UINT32     count;
+    volatile UINT32     min_inv;    /* ~min so that 0 means no sample */
+    volatile UINT32     max_us;
+    volatile uint64_t   sum_us;
+    volatile UINT32     bucket[NFC_LAT_NUM_BUCKETS];
+} tNFC_LAT_HIST;
+
+/* Summary of one stage returned by nfc_lat_get */
+typedef struct
+{
+    UINT32  count;
+    UINT32  min_us;
+    UINT32  max_us;
+    UINT32  mean_us;
+    UINT32  p50_us;
+    UINT32  p90_us;
+    UINT32  p99_us;
+} tNFC_LAT_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Time of the latest transport read; set by the HAL read thread */
+extern volatile UINT32 nfc_lat_rx_time;
+
+/* Time the NCI message which caused the event being processed by NFC_TASK
+** reached the stack, 0 if the event was not caused by the NFCC */
+extern UINT32 nfc_lat_origin;
+
+/*******************************************************************************
+**
+** Function         nfc_lat_now
+**
+** Description      Get the time used to stamp latencies. It wraps around
+**                  every 71 minutes and is never 0, so 0 can mean no time.
+**
+** Returns          monotonic time in microseconds
+**
+*******************************************************************************/
+extern UINT32 nfc_lat_now (void);
+
+/*******************************************************************************
+**
+** Function         nfc_lat_add
+**
+** Description      Add a latency of usec microseconds to stage.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_lat_add (UINT8 stage, UINT32 usec);
+
+/*******************************************************************************
+**
+** Function         nfc_lat_since
+**
+** Description      Add the time elapsed since start_us (from nfc_lat_now) to
+**                  stage. Nothing is added if start_us is 0.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_lat_since (UINT8 stage, UINT32 start_us);
+
+/*******************************************************************************
+**
+** Function         nfc_lat_get
+**
+** Description      Summarize the latencies recorded for stage.
+**
+** Returns          TRUE if the stage has samples
+**
+*******************************************************************************/
+extern BOOLEAN nfc_lat_get (UINT8 stage, tNFC_LAT_STATS *p_stats);
+
+/*******************************************************************************
+**
+** Function         nfc_lat_reset
+**
+** Description      Clear the histograms of all stages.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_lat_reset (void);
+
+/*******************************************************************************
+**
+** Function         nfc_lat_dump
+**
+** Description      Log the summary of every stage with samples.
+**
+** Returns          void
+**
+*******************************************************************************/
+extern void nfc_lat_dump (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NFC_LATENCY_H */
@@ -139,6 +139,26 @@
 #define NCI_MSG_OFFSET_SIZE             1
 #endif
 
+/* TRUE to send the fragments of a large NCI data packet straight from the original
+** buffer, building each NCI data header over bytes already sent, instead of copying
+** every fragment to a new buffer. Requires p_hal->write() to consume the data before
+** it returns, as HAL_NfcWrite() does. */
+#ifndef NFC_NCI_TX_FRAG_IN_PLACE
+#define NFC_NCI_TX_FRAG_IN_PLACE        TRUE
+#endif
+
+/* TRUE to keep the fragments of a segmented NCI data packet in a list and copy them
+** once, into a buffer of the reassembled size, when the last fragment is received */
+#ifndef NFC_NCI_RX_CHAIN_REASSEMBLY
+#define NFC_NCI_RX_CHAIN_REASSEMBLY     TRUE
+#endif
+
+/* Max number of fragments held in the list before they are copied into one buffer of
+** twice the size held so far, so a long packet does not use up the pool of NCI messages */
+#ifndef NFC_NCI_RX_CHAIN_MAX_FRAGS
+#define NFC_NCI_RX_CHAIN_MAX_FRAGS      4
+#endif
+
 /* Restore NFCC baud rate to default on shutdown if NFC_UpdateBaudRate was called */
 #ifndef NFC_RESTORE_BAUD_ON_SHUTDOWN
 #define NFC_RESTORE_BAUD_ON_SHUTDOWN    TRUE
@@ -218,6 +238,11 @@
 #define NCI_MAX_CMD_WINDOW      1
 #endif
 
+/* Merge the CORE_SET_CONFIG commands issued while NFC_TASK processes its events into one */
+#ifndef NFC_SET_CONFIG_COALESCE_INCLUDED
+#define NFC_SET_CONFIG_COALESCE_INCLUDED    TRUE
+#endif
+
 /* Define to TRUE to include the NFCEE related functionalities */
 #ifndef NFC_NFCEE_INCLUDED
 #define NFC_NFCEE_INCLUDED          TRUE
@@ -420,6 +445,23 @@
 #define LLCP_DELAY_RESP_TIME        20      /* in ms */
 #endif
 
+/*
+** Adapt delay of SYMM response to the time application layer takes to send data in its turn.
+** LLCP_DELAY_RESP_TIME (or symm_delay of LLCP_SetConfig) is the initial delay and 0 disables it.
+*/
+#ifndef LLCP_ADAPTIVE_SYMM_DELAY
+#define LLCP_ADAPTIVE_SYMM_DELAY    TRUE
+#endif
+
+/* Range of adaptive SYMM delay; it is also limited to half of LTO left after response time of peer */
+#ifndef LLCP_SYMM_DELAY_MIN
+#define LLCP_SYMM_DELAY_MIN         10      /* in ms */
+#endif
+
+#ifndef LLCP_SYMM_DELAY_MAX
+#define LLCP_SYMM_DELAY_MAX         100     /* in ms */
+#endif
+
 /* LLCP inactivity timeout for initiator */
 #ifndef LLCP_INIT_INACTIVITY_TIMEOUT
 #define LLCP_INIT_INACTIVITY_TIMEOUT            0    /* in ms */
@@ -470,16 +512,36 @@
 #define LLCP_MAX_CLIENT             20
 #endif
 
-/* Max number of data link connections */
+/* Max number of data link connections, up to 32 */
 #ifndef LLCP_MAX_DATA_LINK
 #define LLCP_MAX_DATA_LINK          16
 #endif
 
+/* Max number of PDUs sent in a row from low latency services while others wait */
+#ifndef LLCP_LOW_LATENCY_MAX_BURST
+#define LLCP_LOW_LATENCY_MAX_BURST  4
+#endif
+
 /* Max number of outstanding service discovery requests */
 #ifndef LLCP_MAX_SDP_TRANSAC
 #define LLCP_MAX_SDP_TRANSAC        16
 #endif
 
+/* Number of hash buckets of local service names, power of 2 */
+#ifndef LLCP_SDP_SN_HASH_SIZE
+#define LLCP_SDP_SN_HASH_SIZE       16
+#endif
+
+/* Number of SAPs of peer's services kept from SDRES while LLCP link is activated, 0 to disable */
+#ifndef LLCP_SDP_CACHE_SIZE
+#define LLCP_SDP_CACHE_SIZE         8
+#endif
+
+/* Max length of service name kept in cache of SDRES */
+#ifndef LLCP_SDP_CACHE_MAX_SN_LEN
+#define LLCP_SDP_CACHE_MAX_SN_LEN   32
+#endif
+
 /* Percentage of LLCP buffer pool for receiving data */
 #ifndef LLCP_RX_BUFF_RATIO
 #define LLCP_RX_BUFF_RATIO                  30
@@ -581,6 +643,11 @@
 #define NFA_DM_DISC_DELAY_DISCOVERY     1000
 #endif
 
+/* Keep the NCI config the NFCC holds after enable in NVM so only TLVs that differ are sent */
+#ifndef NFA_DM_CFG_SHADOW_INCLUDED
+#define NFA_DM_CFG_SHADOW_INCLUDED      TRUE
+#endif
+
 /* Max number of NDEF type handlers that can be registered (including the default handler) */
 #ifndef NFA_NDEF_MAX_HANDLERS
 #define NFA_NDEF_MAX_HANDLERS       8
@@ -34,6 +34,8 @@
 #include "nfa_p2p_int.h"
 #include "nfa_cho_int.h"
 #include "nci_hmsgs.h"
+#include "nfc_latency.h"
+#include "nfa_nv_co.h"
 
 #if (NFC_NFCEE_INCLUDED == TRUE)
 #include "nfa_ee_int.h"
@@ -56,6 +58,11 @@ static tNFA_STATUS nfa_dm_start_polling (void);
 static BOOLEAN nfa_dm_deactivate_polling (void);
 static void nfa_dm_excl_disc_cback (tNFA_DM_RF_DISC_EVT event, tNFC_DISCOVER *p_data);
 static void nfa_dm_poll_disc_cback (tNFA_DM_RF_DISC_EVT event, tNFC_DISCOVER *p_data);
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+static void nfa_dm_cfg_shadow_check (tNFC_ENABLE_REVT *p_enable);
+static void nfa_dm_cfg_shadow_learnt (tNFC_GET_CONFIG_REVT *p_get_config);
+static BOOLEAN nfa_dm_cfg_shadow_load (void);
+#endif
 
 
 /*******************************************************************************
@@ -137,33 +144,40 @@ static void nfa_dm_set_init_nci_params (void)
 {
     UINT8   xx;
 
-    /* set NCI default value if other than zero */
-
-    /* LF_T3T_IDENTIFIERS_1/2/.../16 */
-    for (xx = 0; xx < NFA_CE_LISTEN_INFO_MAX; xx++)
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+    /* NFCC config is already known from the shadow */
+    if (  (nfa_dm_cb.cfg_shadow_state != NFA_DM_CFG_SHADOW_ST_KNOWN)
+        ||(!nfa_dm_cb.cfg_shadow.valid)  )
+#endif
     {
-        nfa_dm_cb.params.lf_t3t_id[xx][0] = 0xFF;
-        nfa_dm_cb.params.lf_t3t_id[xx][1] = 0xFF;
-        nfa_dm_cb.params.lf_t3t_id[xx][2] = 0x02;
-        nfa_dm_cb.params.lf_t3t_id[xx][2] = 0xFE;
-    }
+        /* set NCI default value if other than zero */
 
-    /* LF_T3T_PMM */
-    for (xx = 0; xx < NCI_PARAM_LEN_LF_T3T_PMM; xx++)
-    {
-        nfa_dm_cb.params.lf_t3t_pmm[xx] = 0xFF;
-    }
+        /* LF_T3T_IDENTIFIERS_1/2/.../16 */
+        for (xx = 0; xx < NFA_CE_LISTEN_INFO_MAX; xx++)
+        {
+            nfa_dm_cb.params.lf_t3t_id[xx][0] = 0xFF;
+            nfa_dm_cb.params.lf_t3t_id[xx][1] = 0xFF;
+            nfa_dm_cb.params.lf_t3t_id[xx][2] = 0x02;
+            nfa_dm_cb.params.lf_t3t_id[xx][2] = 0xFE;
+        }
 
-    /* LF_T3T_FLAGS:
-    ** DH needs to set this configuration, even if default value (not listening) is used,
-    ** to let NFCC know of intention (not listening) of DH.
-    */
+        /* LF_T3T_PMM */
+        for (xx = 0; xx < NCI_PARAM_LEN_LF_T3T_PMM; xx++)
+        {
+            nfa_dm_cb.params.lf_t3t_pmm[xx] = 0xFF;
+        }
 
-    /* FWI */
-    nfa_dm_cb.params.fwi[0] = 0x04;
+        /* LF_T3T_FLAGS:
+        ** DH needs to set this configuration, even if default value (not listening) is used,
+        ** to let NFCC know of intention (not listening) of DH.
+        */
+
+        /* FWI */
+        nfa_dm_cb.params.fwi[0] = 0x04;
 
-    /* WT */
-    nfa_dm_cb.params.wt[0] = 14;
+        /* WT */
+        nfa_dm_cb.params.wt[0] = 14;
+    }
 
     /* Set CE default configuration */
     if (p_nfa_dm_ce_cfg[0])
@@ -200,7 +214,12 @@ void nfa_dm_proc_nfcc_power_mode (UINT8 nfcc_power_mode)
     /* if NFCC power mode is change to full power */
     if (nfcc_power_mode == NFA_DM_PWR_MODE_FULL)
     {
-        memset (&nfa_dm_cb.params, 0x00, sizeof (tNFA_DM_PARAMS));
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+        if (!nfa_dm_cfg_shadow_load ())
+#endif
+        {
+            memset (&nfa_dm_cb.params, 0x00, sizeof (tNFA_DM_PARAMS));
+        }
 
         nfa_dm_cb.setcfg_pending_mask = 0;
         nfa_dm_cb.setcfg_pending_num  = 0;
@@ -260,6 +279,9 @@ static void nfa_dm_nfc_response_cback (tNFC_RESPONSE_EVT event, tNFC_RESPONSE *p
         /* NFC stack enabled. Enable nfa sub-systems */
         if (p_data->enable.status == NFC_STATUS_OK)
         {
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+            nfa_dm_cfg_shadow_check (&p_data->enable);
+#endif
             nfa_dm_set_init_nci_params ();
 
             /* Initialize NFA subsystems */
@@ -302,6 +324,14 @@ static void nfa_dm_nfc_response_cback (tNFC_RESPONSE_EVT event, tNFC_RESPONSE *p
         break;
 
     case NFC_GET_CONFIG_REVT:                    /* 3  Get Config Response */
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+        /* response to the GET_CONFIG sent to learn the config shadow */
+        if (nfa_dm_cb.cfg_shadow_state == NFA_DM_CFG_SHADOW_ST_LEARNING)
+        {
+            nfa_dm_cfg_shadow_learnt (&p_data->get_config);
+            break;
+        }
+#endif
         if (p_data->get_config.status == NFC_STATUS_OK)
         {
             if ((p_nfa_get_confg = (tNFA_GET_CONFIG *) GKI_getbuf ((UINT16) (sizeof (tNFA_GET_CONFIG) + p_data->get_config.tlv_size))) != NULL)
@@ -423,6 +453,12 @@ BOOLEAN nfa_dm_enable (tNFA_DM_MSG *p_data)
         nfa_dm_cb.p_dm_cback    = p_data->enable.p_dm_cback;
         nfa_dm_cb.p_conn_cback  = p_data->enable.p_conn_cback;
 
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+        /* Read the NFCC config shadow; it is checked when NFC is enabled */
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_READING;
+        nfa_nv_co_read ((UINT8 *) &nfa_dm_cb.cfg_shadow, sizeof (tNFA_DM_CFG_SHADOW), DM_NV_BLOCK);
+#endif
+
         /* Enable NFC stack */
         NFC_Enable (nfa_dm_nfc_response_cback);
     }
@@ -436,6 +472,236 @@ BOOLEAN nfa_dm_enable (tNFA_DM_MSG *p_data)
     return (TRUE);
 }
 
+/*******************************************************************************
+**
+** Function         nfa_dm_act_nv_read
+**
+** Description      Process the NFCC config shadow read from NVM
+**
+** Returns          TRUE (message buffer to be freed by caller)
+**
+*******************************************************************************/
+BOOLEAN nfa_dm_act_nv_read (tNFA_DM_MSG *p_data)
+{
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+    NFA_TRACE_DEBUG2 ("nfa_dm_act_nv_read (): status:%d, size:%d",
+                       p_data->nv_read.status, p_data->nv_read.size);
+
+    if (nfa_dm_cb.cfg_shadow_state != NFA_DM_CFG_SHADOW_ST_READING)
+        return (TRUE);
+
+    if (  (p_data->nv_read.status == NFA_STATUS_OK)
+        &&(p_data->nv_read.size == sizeof (tNFA_DM_CFG_SHADOW))
+        &&(nfa_dm_cb.cfg_shadow.magic == NFA_DM_CFG_SHADOW_MAGIC)
+        &&(nfa_dm_cb.cfg_shadow.size == sizeof (tNFA_DM_CFG_SHADOW))  )
+    {
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_READ;
+    }
+    else
+    {
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_NONE;
+    }
+#endif
+    return (TRUE);
+}
+
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+/* config parameters kept in the shadow, besides LF_T3T_IDENTIFIERS */
+static const tNFC_PMID nfa_dm_cfg_shadow_pmids[] =
+{
+    NFC_PMID_TOTAL_DURATION,
+    NFC_PMID_LA_BIT_FRAME_SDD,
+    NFC_PMID_LA_PLATFORM_CONFIG,
+    NFC_PMID_LA_SEL_INFO,
+    NFC_PMID_LA_NFCID1,
+    NFC_PMID_LA_HIST_BY,
+    NFC_PMID_LB_SENSB_INFO,
+    NFC_PMID_LB_NFCID0,
+    NFC_PMID_LB_APPDATA,
+    NFC_PMID_LB_ADC_FO,
+    NFC_PMID_LB_H_INFO,
+    NFC_PMID_LF_PROTOCOL,
+    NFC_PMID_LF_T3T_FLAGS2,
+    NFC_PMID_LF_T3T_PMM,
+    NFC_PMID_FWI,
+    NFC_PMID_WT,
+    NFC_PMID_ATR_REQ_GEN_BYTES,
+    NFC_PMID_ATR_RES_GEN_BYTES
+};
+
+/*******************************************************************************
+**
+** Function         nfa_dm_cfg_shadow_check
+**
+** Description      Check the config shadow read from NVM against the enabled
+**                  NFCC. If it does not match, ask NFCC for its config before
+**                  NFA sets any.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_cfg_shadow_check (tNFC_ENABLE_REVT *p_enable)
+{
+    tNFA_DM_CFG_SHADOW *p_shadow = &nfa_dm_cb.cfg_shadow;
+    tNFC_PMID pmids[sizeof (nfa_dm_cfg_shadow_pmids) + NFA_CE_LISTEN_INFO_MAX];
+    UINT8 num_ids, first, xx, max_len, *p_cur_len;
+    UINT16 rsp_len;
+
+    if (  (nfa_dm_cb.cfg_shadow_state == NFA_DM_CFG_SHADOW_ST_READ)
+        &&(p_shadow->manufacture_id == p_enable->manufacture_id)
+        &&(!memcmp (p_shadow->nfcc_info, p_enable->nfcc_info, NFC_NFCC_INFO_LEN))
+        &&(p_shadow->startup_cfg_id == nfa_dm_startup_cfg_id)  )
+    {
+        NFA_TRACE_DEBUG1 ("nfa_dm_cfg_shadow_check (): shadow matches NFCC, valid:%d", p_shadow->valid);
+
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_KNOWN;
+        nfa_dm_cfg_shadow_load ();
+        return;
+    }
+
+    NFA_TRACE_DEBUG0 ("nfa_dm_cfg_shadow_check (): reading config of NFCC");
+
+    memset (p_shadow, 0, sizeof (tNFA_DM_CFG_SHADOW));
+    p_shadow->magic          = NFA_DM_CFG_SHADOW_MAGIC;
+    p_shadow->size           = sizeof (tNFA_DM_CFG_SHADOW);
+    p_shadow->manufacture_id = p_enable->manufacture_id;
+    memcpy (p_shadow->nfcc_info, p_enable->nfcc_info, NFC_NFCC_INFO_LEN);
+    p_shadow->startup_cfg_id = nfa_dm_startup_cfg_id;
+
+    memcpy (pmids, nfa_dm_cfg_shadow_pmids, sizeof (nfa_dm_cfg_shadow_pmids));
+    num_ids = sizeof (nfa_dm_cfg_shadow_pmids);
+    for (xx = 0; xx < NFA_CE_LISTEN_INFO_MAX; xx++)
+        pmids[num_ids++] = NFC_PMID_LF_T3T_ID1 + xx;
+
+    /* cleared if any GET_CONFIG fails */
+    p_shadow->valid = TRUE;
+    nfa_dm_cb.cfg_shadow_num_get = 0;
+
+    /* GET_CONFIGs are queued before the SET_CONFIGs of nfa_dm_set_init_nci_params ().
+    ** Each response has to fit in a control packet of NFCC, so the parameters are
+    ** asked for in as many GET_CONFIGs as needed. */
+    first   = 0;
+    rsp_len = 2;    /* status and number of parameters */
+    for (xx = 0; xx <= num_ids; xx++)
+    {
+        max_len = 0;
+        if (xx < num_ids)
+            nfa_dm_get_stored_param (&p_shadow->params, pmids[xx], &max_len, &p_cur_len);
+
+        if (  (xx > first)
+            &&((xx == num_ids) || (rsp_len + 2 + max_len > p_enable->max_ctrl_size))  )
+        {
+            if (NFC_GetConfig ((UINT8) (xx - first), &pmids[first]) == NFC_STATUS_OK)
+                nfa_dm_cb.cfg_shadow_num_get++;
+            else
+                p_shadow->valid = FALSE;
+
+            first   = xx;
+            rsp_len = 2;
+        }
+        rsp_len += 2 + max_len;
+    }
+
+    if (nfa_dm_cb.cfg_shadow_num_get)
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_LEARNING;
+    else
+        nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_NONE;
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_cfg_shadow_learnt
+**
+** Description      Store the config reported by NFCC in the shadow and save
+**                  it in NVM once all GET_CONFIGs are answered. If NFCC could
+**                  not report it, the shadow is saved as invalid so it is not
+**                  asked again for the same NFCC.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfa_dm_cfg_shadow_learnt (tNFC_GET_CONFIG_REVT *p_get_config)
+{
+    tNFA_DM_CFG_SHADOW *p_shadow = &nfa_dm_cb.cfg_shadow;
+    UINT8 *p, *p_end, *p_stored, *p_cur_len;
+    UINT8 type, len, max_len;
+
+    NFA_TRACE_DEBUG1 ("nfa_dm_cfg_shadow_learnt (): status:%d", p_get_config->status);
+
+    /* tlv_size includes status and number of parameters */
+    if (  (p_get_config->status == NFC_STATUS_OK)
+        &&(p_get_config->tlv_size >= 2)  )
+    {
+        p     = p_get_config->p_param_tlvs + 1;
+        p_end = p_get_config->p_param_tlvs + p_get_config->tlv_size - 1;
+
+        while (p_end - p >= 2)
+        {
+            type = *p++;
+            len  = *p++;
+
+            if (p_end - p < len)
+                break;
+
+            p_stored = nfa_dm_get_stored_param (&p_shadow->params, type, &max_len, &p_cur_len);
+
+            if ((p_stored) && (len <= max_len))
+            {
+                if (p_cur_len)
+                {
+                    *p_cur_len = len;
+                    memcpy (p_stored, p, len);
+                }
+                else if (len == max_len)  /* fixed length */
+                {
+                    memcpy (p_stored, p, len);
+                }
+            }
+            p += len;
+        }
+    }
+    else
+    {
+        p_shadow->valid = FALSE;
+    }
+
+    if ((nfa_dm_cb.cfg_shadow_num_get) && (--nfa_dm_cb.cfg_shadow_num_get))
+    {
+        /* wait for the other GET_CONFIG responses */
+        return;
+    }
+
+    nfa_dm_cb.cfg_shadow_state = NFA_DM_CFG_SHADOW_ST_KNOWN;
+    nfa_nv_co_write ((UINT8 *) p_shadow, sizeof (tNFA_DM_CFG_SHADOW), DM_NV_BLOCK);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_cfg_shadow_load
+**
+** Description      Use the config shadow as the config NFCC holds, so only
+**                  parameters which differ from it are set.
+**
+** Returns          TRUE if the config shadow was loaded
+**
+*******************************************************************************/
+static BOOLEAN nfa_dm_cfg_shadow_load (void)
+{
+    if (  (nfa_dm_cb.cfg_shadow_state != NFA_DM_CFG_SHADOW_ST_KNOWN)
+        ||(!nfa_dm_cb.cfg_shadow.valid)  )
+    {
+        return (FALSE);
+    }
+
+    memcpy (&nfa_dm_cb.params, &nfa_dm_cb.cfg_shadow.params, sizeof (tNFA_DM_PARAMS));
+
+    /* DH always sets LF_T3T_FLAGS2, even to its default value, to let NFCC
+    ** know of its listen intention */
+    nfa_dm_cb.params.lf_t3t_flags2_len = 0;
+    return (TRUE);
+}
+#endif /* NFA_DM_CFG_SHADOW_INCLUDED */
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_disable
@@ -586,6 +852,10 @@ BOOLEAN nfa_dm_get_config (tNFA_DM_MSG *p_data)
 *******************************************************************************/
 void nfa_dm_conn_cback_event_notify (UINT8 event, tNFA_CONN_EVT_DATA *p_data)
 {
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    nfc_lat_since (NFC_LAT_APP, nfc_lat_origin);
+#endif
+
     if (nfa_dm_cb.flags & NFA_DM_FLAGS_EXCL_RF_ACTIVE)
     {
         /* Use exclusive RF mode callback */
@@ -86,6 +86,9 @@ const tNFA_DM_CFG nfa_dm_cfg =
 
 tNFA_DM_CFG *p_nfa_dm_cfg = (tNFA_DM_CFG *) &nfa_dm_cfg;
 
+/* identifies the start-up config the HAL sends to NFCC; set by the platform */
+UINT32 nfa_dm_startup_cfg_id = 0;
+
 
 
 
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2010-2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  This file contains the call-in functions for NFA DM
+ *
+ ******************************************************************************/
+#include <string.h>
+#include "nfa_sys.h"
+#include "nfa_dm_int.h"
+#include "nfa_sys_int.h"
+#include "nfa_nv_co.h"
+#include "nfa_nv_ci.h"
+
+/*******************************************************************************
+**
+** Function         nfa_dm_nv_ci_read
+**
+** Description      call-in function for non volatile memory read access of
+**                  DM_NV_BLOCK (the NFCC config shadow)
+**
+** Returns          none
+**
+*******************************************************************************/
+void nfa_dm_nv_ci_read (UINT16 num_bytes_read, tNFA_NV_CO_STATUS status)
+{
+    tNFA_DM_NV_READ *p_msg;
+
+    if ((p_msg = (tNFA_DM_NV_READ *) GKI_getbuf (sizeof (tNFA_DM_NV_READ))) != NULL)
+    {
+        p_msg->hdr.event = NFA_DM_NV_READ_EVT;
+        p_msg->status    = (status == NFA_NV_CO_OK) ? NFA_STATUS_OK : NFA_STATUS_FAILED;
+        p_msg->size      = num_bytes_read;
+        nfa_sys_sendmsg (p_msg);
+    }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_dm_nv_ci_write
+**
+** Description      call-in function for non volatile memory write access of
+**                  DM_NV_BLOCK. Nothing waits for the write; if it failed the
+**                  config of NFCC is read again on next enable.
+**
+** Returns          none
+**
+*******************************************************************************/
+void nfa_dm_nv_ci_write (tNFA_NV_CO_STATUS status)
+{
+    if (status != NFA_NV_CO_OK)
+    {
+        NFA_TRACE_WARNING1 ("nfa_dm_nv_ci_write (): status:%d", status);
+    }
+}
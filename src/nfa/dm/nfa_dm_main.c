@@ -74,7 +74,8 @@ const tNFA_DM_ACTION nfa_dm_action[] =
     nfa_dm_ndef_dereg_hdlr,             /* NFA_DM_API_DEREG_NDEF_HDLR_EVT       */
     nfa_dm_act_reg_vsc,                 /* NFA_DM_API_REG_VSC_EVT               */
     nfa_dm_act_send_vsc,                /* NFA_DM_API_SEND_VSC_EVT              */
-    nfa_dm_act_disable_timeout          /* NFA_DM_TIMEOUT_DISABLE_EVT           */
+    nfa_dm_act_disable_timeout,         /* NFA_DM_TIMEOUT_DISABLE_EVT           */
+    nfa_dm_act_nv_read                  /* NFA_DM_NV_READ_EVT                   */
 };
 
 /*****************************************************************************
@@ -207,6 +208,147 @@ BOOLEAN nfa_dm_is_active (void)
     else
         return FALSE;
 }
+
+/*******************************************************************************
+**
+** Function         nfa_dm_get_stored_param
+**
+** Description      Find where a config parameter is stored in p_params.
+**                  *pp_cur_len is set if the parameter has a variable length.
+**
+** Returns          the stored value, or NULL if this parameter is not stored
+**
+*******************************************************************************/
+UINT8 *nfa_dm_get_stored_param (tNFA_DM_PARAMS *p_params, UINT8 type, UINT8 *p_max_len, UINT8 **pp_cur_len)
+{
+    UINT8 *p_stored;
+
+    *pp_cur_len = NULL;
+
+    switch (type)
+    {
+    case NFC_PMID_TOTAL_DURATION:
+        p_stored    = p_params->total_duration;
+        *p_max_len  = NCI_PARAM_LEN_TOTAL_DURATION;
+        break;
+
+    /*
+    **  Listen A Configuration
+    */
+    case NFC_PMID_LA_BIT_FRAME_SDD:
+        p_stored    = p_params->la_bit_frame_sdd;
+        *p_max_len  = NCI_PARAM_LEN_LA_BIT_FRAME_SDD;
+        *pp_cur_len = &p_params->la_bit_frame_sdd_len;
+        break;
+    case NFC_PMID_LA_PLATFORM_CONFIG:
+        p_stored    = p_params->la_platform_config;
+        *p_max_len  = NCI_PARAM_LEN_LA_PLATFORM_CONFIG;
+        *pp_cur_len = &p_params->la_platform_config_len;
+        break;
+    case NFC_PMID_LA_SEL_INFO:
+        p_stored    = p_params->la_sel_info;
+        *p_max_len  = NCI_PARAM_LEN_LA_SEL_INFO;
+        *pp_cur_len = &p_params->la_sel_info_len;
+        break;
+    case NFC_PMID_LA_NFCID1:
+        p_stored    = p_params->la_nfcid1;
+        *p_max_len  = NCI_NFCID1_MAX_LEN;
+        *pp_cur_len = &p_params->la_nfcid1_len;
+        break;
+    case NFC_PMID_LA_HIST_BY:
+        p_stored    = p_params->la_hist_by;
+        *p_max_len  = NCI_MAX_HIS_BYTES_LEN;
+        *pp_cur_len = &p_params->la_hist_by_len;
+        break;
+
+    /*
+    **  Listen B Configuration
+    */
+    case NFC_PMID_LB_SENSB_INFO:
+        p_stored    = p_params->lb_sensb_info;
+        *p_max_len  = NCI_PARAM_LEN_LB_SENSB_INFO;
+        *pp_cur_len = &p_params->lb_sensb_info_len;
+        break;
+    case NFC_PMID_LB_NFCID0:
+        p_stored    = p_params->lb_nfcid0;
+        *p_max_len  = NCI_PARAM_LEN_LB_NFCID0;
+        *pp_cur_len = &p_params->lb_nfcid0_len;
+        break;
+    case NFC_PMID_LB_APPDATA:
+        p_stored    = p_params->lb_appdata;
+        *p_max_len  = NCI_PARAM_LEN_LB_APPDATA;
+        *pp_cur_len = &p_params->lb_appdata_len;
+        break;
+    case NFC_PMID_LB_ADC_FO:
+        p_stored    = p_params->lb_adc_fo;
+        *p_max_len  = NCI_PARAM_LEN_LB_ADC_FO;
+        *pp_cur_len = &p_params->lb_adc_fo_len;
+        break;
+    case NFC_PMID_LB_H_INFO:
+        p_stored    = p_params->lb_h_info;
+        *p_max_len  = NCI_MAX_ATTRIB_LEN;
+        *pp_cur_len = &p_params->lb_h_info_len;
+        break;
+
+    /*
+    **  Listen F Configuration
+    */
+    case NFC_PMID_LF_PROTOCOL:
+        p_stored    = p_params->lf_protocol;
+        *p_max_len  = NCI_PARAM_LEN_LF_PROTOCOL;
+        *pp_cur_len = &p_params->lf_protocol_len;
+        break;
+    case NFC_PMID_LF_T3T_FLAGS2:
+        p_stored    = p_params->lf_t3t_flags2;
+        *p_max_len  = NCI_PARAM_LEN_LF_T3T_FLAGS2;
+        *pp_cur_len = &p_params->lf_t3t_flags2_len;
+        break;
+    case NFC_PMID_LF_T3T_PMM:
+        p_stored    = p_params->lf_t3t_pmm;
+        *p_max_len  = NCI_PARAM_LEN_LF_T3T_PMM;
+        break;
+
+    /*
+    **  ISO-DEP and NFC-DEP Configuration
+    */
+    case NFC_PMID_FWI:
+        p_stored    = p_params->fwi;
+        *p_max_len  = NCI_PARAM_LEN_FWI;
+        break;
+    case NFC_PMID_WT:
+        p_stored    = p_params->wt;
+        *p_max_len  = NCI_PARAM_LEN_WT;
+        break;
+    case NFC_PMID_ATR_REQ_GEN_BYTES:
+        p_stored    = p_params->atr_req_gen_bytes;
+        *p_max_len  = NCI_MAX_GEN_BYTES_LEN;
+        *pp_cur_len = &p_params->atr_req_gen_bytes_len;
+        break;
+    case NFC_PMID_ATR_RES_GEN_BYTES:
+        p_stored    = p_params->atr_res_gen_bytes;
+        *p_max_len  = NCI_MAX_GEN_BYTES_LEN;
+        *pp_cur_len = &p_params->atr_res_gen_bytes_len;
+        break;
+    default:
+        /*
+        **  Listen F Configuration
+        */
+        if ((type >= NFC_PMID_LF_T3T_ID1) && (type < NFC_PMID_LF_T3T_ID1 + NFA_CE_LISTEN_INFO_MAX))
+        {
+            p_stored    = p_params->lf_t3t_id[type - NFC_PMID_LF_T3T_ID1];
+            *p_max_len  = NCI_PARAM_LEN_LF_T3T_ID;
+        }
+        else
+        {
+            /* we don't stored this config items */
+            p_stored    = NULL;
+        }
+        break;
+    }
+
+    return (p_stored);
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_dm_check_set_config
@@ -240,129 +382,12 @@ tNFA_STATUS nfa_dm_check_set_config (UINT8 tlv_list_len, UINT8 *p_tlv_list, BOOL
         type    = *(p_tlv_list + xx);
         len     = *(p_tlv_list + xx + 1);
         p_value = p_tlv_list + xx + 2;
-        p_cur_len = NULL;
-
-        switch (type)
-        {
-        case NFC_PMID_TOTAL_DURATION:
-            p_stored = nfa_dm_cb.params.total_duration;
-            max_len  = NCI_PARAM_LEN_TOTAL_DURATION;
-            break;
 
-        /*
-        **  Listen A Configuration
-        */
-        case NFC_PMID_LA_BIT_FRAME_SDD:
-            p_stored  = nfa_dm_cb.params.la_bit_frame_sdd;
-            max_len   = NCI_PARAM_LEN_LA_BIT_FRAME_SDD;
-            p_cur_len = &nfa_dm_cb.params.la_bit_frame_sdd_len;
-            break;
-        case NFC_PMID_LA_PLATFORM_CONFIG:
-            p_stored  = nfa_dm_cb.params.la_platform_config;
-            max_len   = NCI_PARAM_LEN_LA_PLATFORM_CONFIG;
-            p_cur_len = &nfa_dm_cb.params.la_platform_config_len;
-            break;
-        case NFC_PMID_LA_SEL_INFO:
-            p_stored  = nfa_dm_cb.params.la_sel_info;
-            max_len   = NCI_PARAM_LEN_LA_SEL_INFO;
-            p_cur_len = &nfa_dm_cb.params.la_sel_info_len;
-            break;
-        case NFC_PMID_LA_NFCID1:
-            p_stored  = nfa_dm_cb.params.la_nfcid1;
-            max_len   = NCI_NFCID1_MAX_LEN;
-            p_cur_len = &nfa_dm_cb.params.la_nfcid1_len;
-            break;
-        case NFC_PMID_LA_HIST_BY:
-            p_stored  = nfa_dm_cb.params.la_hist_by;
-            max_len   = NCI_MAX_HIS_BYTES_LEN;
-            p_cur_len = &nfa_dm_cb.params.la_hist_by_len;
-            break;
+        p_stored = nfa_dm_get_stored_param (&nfa_dm_cb.params, type, &max_len, &p_cur_len);
 
-        /*
-        **  Listen B Configuration
-        */
-        case NFC_PMID_LB_SENSB_INFO:
-            p_stored  = nfa_dm_cb.params.lb_sensb_info;
-            max_len   = NCI_PARAM_LEN_LB_SENSB_INFO;
-            p_cur_len = &nfa_dm_cb.params.lb_sensb_info_len;
-            break;
-        case NFC_PMID_LB_NFCID0:
-            p_stored  = nfa_dm_cb.params.lb_nfcid0;
-            max_len   = NCI_PARAM_LEN_LB_NFCID0;
-            p_cur_len = &nfa_dm_cb.params.lb_nfcid0_len;
-            break;
-        case NFC_PMID_LB_APPDATA:
-            p_stored  = nfa_dm_cb.params.lb_appdata;
-            max_len   = NCI_PARAM_LEN_LB_APPDATA;
-            p_cur_len = &nfa_dm_cb.params.lb_appdata_len;
-            break;
-        case NFC_PMID_LB_ADC_FO:
-            p_stored  = nfa_dm_cb.params.lb_adc_fo;
-            max_len   = NCI_PARAM_LEN_LB_ADC_FO;
-            p_cur_len = &nfa_dm_cb.params.lb_adc_fo_len;
-            break;
-        case NFC_PMID_LB_H_INFO:
-            p_stored  = nfa_dm_cb.params.lb_h_info;
-            max_len   = NCI_MAX_ATTRIB_LEN;
-            p_cur_len = &nfa_dm_cb.params.lb_h_info_len;
-            break;
-
-        /*
-        **  Listen F Configuration
-        */
-        case NFC_PMID_LF_PROTOCOL:
-            p_stored  = nfa_dm_cb.params.lf_protocol;
-            max_len   = NCI_PARAM_LEN_LF_PROTOCOL;
-            p_cur_len = &nfa_dm_cb.params.lf_protocol_len;
-            break;
-        case NFC_PMID_LF_T3T_FLAGS2:
-            p_stored  = nfa_dm_cb.params.lf_t3t_flags2;
-            max_len   = NCI_PARAM_LEN_LF_T3T_FLAGS2;
-            p_cur_len = &nfa_dm_cb.params.lf_t3t_flags2_len;
-            break;
-        case NFC_PMID_LF_T3T_PMM:
-            p_stored = nfa_dm_cb.params.lf_t3t_pmm;
-            max_len  = NCI_PARAM_LEN_LF_T3T_PMM;
-            break;
-
-        /*
-        **  ISO-DEP and NFC-DEP Configuration
-        */
-        case NFC_PMID_FWI:
-            p_stored = nfa_dm_cb.params.fwi;
-            max_len  = NCI_PARAM_LEN_FWI;
-            break;
-        case NFC_PMID_WT:
-            p_stored = nfa_dm_cb.params.wt;
-            max_len  = NCI_PARAM_LEN_WT;
-            break;
-        case NFC_PMID_ATR_REQ_GEN_BYTES:
-            p_stored  = nfa_dm_cb.params.atr_req_gen_bytes;
-            max_len   = NCI_MAX_GEN_BYTES_LEN;
-            p_cur_len = &nfa_dm_cb.params.atr_req_gen_bytes_len;
-            break;
-        case NFC_PMID_ATR_RES_GEN_BYTES:
-            p_stored  = nfa_dm_cb.params.atr_res_gen_bytes;
-            max_len   = NCI_MAX_GEN_BYTES_LEN;
-            p_cur_len = &nfa_dm_cb.params.atr_res_gen_bytes_len;
-            break;
-        default:
-            /*
-            **  Listen F Configuration
-            */
-            if ((type >= NFC_PMID_LF_T3T_ID1) && (type < NFC_PMID_LF_T3T_ID1 + NFA_CE_LISTEN_INFO_MAX))
-            {
-                p_stored = nfa_dm_cb.params.lf_t3t_id[type - NFC_PMID_LF_T3T_ID1];
-                max_len  = NCI_PARAM_LEN_LF_T3T_ID;
-            }
-            else
-            {
-                /* we don't stored this config items */
-                update   = TRUE;
-                p_stored = NULL;
-            }
-            break;
-        }
+        /* we don't store this type */
+        if (p_stored == NULL)
+            update = TRUE;
 
         if ((p_stored)&&(len <= max_len))
         {
@@ -510,6 +535,9 @@ static char *nfa_dm_evt_2_str (UINT16 event)
     case NFA_DM_TIMEOUT_DISABLE_EVT:
         return "NFA_DM_TIMEOUT_DISABLE_EVT";
 
+    case NFA_DM_NV_READ_EVT:
+        return "NFA_DM_NV_READ_EVT";
+
     }
 
     return "Unknown or Vendor Specific";
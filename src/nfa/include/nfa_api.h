@@ -250,6 +250,7 @@ typedef struct
 #define NFA_UPDATE_RF_PARAM_RESULT_EVT          32  /* status of updating RF communication paramters*/
 #define NFA_SET_P2P_LISTEN_TECH_EVT             33  /* status of setting P2P listen technologies    */
 #define NFA_RW_INTF_ERROR_EVT                   34  /* RF Interface error event                     */
+#define NFA_NDEF_READ_SEG_EVT                   35  /* Segment of NDEF message (NFA_RwReadNDefStream)*/
 
 /* NFC deactivation type */
 #define NFA_DEACTIVATE_TYPE_IDLE        NFC_DEACTIVATE_TYPE_IDLE
@@ -433,6 +434,21 @@ typedef struct
 } tNFA_CE_DATA;
 
 
+/* Data for NFA_NDEF_READ_SEG_EVT */
+#define NFA_NDEF_SEG_NO_REC     0xFFFF  /* No NDEF record header starts in the segment */
+
+typedef struct
+{
+    UINT32              offset;         /* Offset of the segment in the NDEF message        */
+    UINT32              msg_len;        /* Length of the whole NDEF message                 */
+    UINT8               *p_data;        /* Segment data (valid during the callback only)    */
+    UINT16              len;            /* Length of the segment                            */
+    UINT16              rec_start;      /* Offset in p_data of the first record header
+                                        ** starting in the segment, or NFA_NDEF_SEG_NO_REC  */
+    UINT16              rec_end;        /* Offset in p_data just past the last record
+                                        ** ending in the segment, 0 if none ends in it      */
+} tNFA_NDEF_READ_SEG;
+
 /* Union of all connection callback structures */
 typedef union
 {
@@ -467,6 +483,7 @@ typedef union
     tNFA_CE_ACTIVATED        ce_activated;      /* NFA_CE_ACTIVATED_EVT                 */
     tNFA_CE_DEACTIVATED      ce_deactivated;    /* NFA_CE_DEACTIVATED_EVT               */
     tNFA_CE_DATA             ce_data;           /* NFA_CE_DATA_EVT                      */
+    tNFA_NDEF_READ_SEG       ndef_read_seg;     /* NFA_NDEF_READ_SEG_EVT                */
 
 } tNFA_CONN_EVT_DATA;
 
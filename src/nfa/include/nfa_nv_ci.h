@@ -99,6 +99,38 @@ NFC_API extern void nfa_nv_ci_read (UINT16            num_bytes_read,
                                     tNFA_NV_CO_STATUS status,
                                     UINT8             block);
 
+/*******************************************************************************
+**
+** Function         nfa_dm_nv_ci_read
+**
+** Description      This function sends an event to NFA DM indicating the phone
+**                  has read DM_NV_BLOCK as requested by nfa_nv_co_read ().
+**
+** Parameters       num_bytes_read - number of bytes read into the buffer
+**                      specified in the read callout-function.
+**                  status - NFA_NV_CO_OK if full buffer of data,
+**                           NFA_NV_CO_EOF if the end of file has been reached,
+**                           NFA_NV_CO_FAIL if an error has occurred.
+**
+** Returns          void
+**
+*******************************************************************************/
+NFC_API extern void nfa_dm_nv_ci_read (UINT16 num_bytes_read, tNFA_NV_CO_STATUS status);
+
+/*******************************************************************************
+**
+** Function         nfa_dm_nv_ci_write
+**
+** Description      This function indicates to NFA DM the phone has written
+**                  DM_NV_BLOCK as requested by nfa_nv_co_write ().
+**
+** Parameters       status - NFA_NV_CO_OK, NFA_NV_CO_NOSPACE, or NFA_NV_CO_FAIL
+**
+** Returns          void
+**
+*******************************************************************************/
+NFC_API extern void nfa_dm_nv_ci_write (tNFA_NV_CO_STATUS status);
+
 
 #ifdef __cplusplus
 }
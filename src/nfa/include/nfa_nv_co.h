@@ -57,6 +57,7 @@ typedef UINT8 tNFA_NV_CO_STATUS;
 #define  HC_F3_NV_BLOCK         0x02
 #define  HC_F4_NV_BLOCK         0x03
 #define  HC_DH_NV_BLOCK         0x04
+#define  DM_NV_BLOCK            0x05
 
 /*****************************************************************************
 **  Function Declarations
@@ -82,7 +83,8 @@ typedef UINT8 tNFA_NV_CO_STATUS;
 **                        of bytes read into the buffer, and a status.  The
 **                        call-in function should only be called when ALL requested
 **                        bytes have been read, the end of file has been detected,
-**                        or an error has occurred.
+**                        or an error has occurred. nfa_dm_nv_ci_read () is called
+**                        instead for DM_NV_BLOCK.
 **
 *******************************************************************************/
 NFC_API extern void nfa_nv_co_read (UINT8 *p_buf, UINT16 nbytes, UINT8 block);
@@ -103,6 +105,7 @@ NFC_API extern void nfa_nv_co_read (UINT8 *p_buf, UINT16 nbytes, UINT8 block);
 **                        called with the file descriptor and the status.  The
 **                        call-in function should only be called when ALL requested
 **                        bytes have been written, or an error has been detected,
+**                        nfa_dm_nv_ci_write () is called instead for DM_NV_BLOCK.
 **
 *******************************************************************************/
 NFC_API extern void nfa_nv_co_write (const UINT8 *p_buf, UINT16 nbytes, UINT8 block);
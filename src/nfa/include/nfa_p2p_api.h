@@ -555,6 +555,42 @@ NFC_API extern void NFA_P2pGetLLCPConfig (UINT16 *p_link_miu,
                                           UINT16 *p_data_link_timeout,
                                           UINT16 *p_delay_first_pdu_timeout);
 
+/*******************************************************************************
+**
+** Function         NFA_P2pSetTxPriority
+**
+** Description      This function is called to set how data of a registered
+**                  server or client is scheduled on LLCP link.
+**
+**                  weight: number of PDUs sent in a row in its turn (0 is
+**                          taken as 1), e.g. higher for bulk transfer
+**                  low_latency: TRUE to send its data before data of other
+**                          services, e.g. for connection handover
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+NFC_API extern tNFA_STATUS NFA_P2pSetTxPriority (tNFA_HANDLE handle,
+                                                 UINT8       weight,
+                                                 BOOLEAN     low_latency);
+
+/*******************************************************************************
+**
+** Function         NFA_P2pGetTxStats
+**
+** Description      This function is called to get the number of PDUs sent
+**                  from a registered server or client and the time they
+**                  waited in tx queue.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**
+*******************************************************************************/
+NFC_API extern tNFA_STATUS NFA_P2pGetTxStats (tNFA_HANDLE     handle,
+                                              tLLCP_TX_STATS *p_stats);
+
 /*******************************************************************************
 **
 ** Function         NFA_P2pSetTraceLevel
@@ -42,6 +42,18 @@ typedef struct
     UINT16  block_number;       /* Block number.                */
 } tNFA_T3T_BLOCK_DESC;
 
+/* Presence check counters, since NFA was initialized */
+typedef struct
+{
+    UINT32  probes;             /* presence checks sent by RW module              */
+    UINT32  sleep_wakes;        /* presence checks putting the tag to sleep and
+                                ** waking it up (protocols not handled by RW)     */
+    UINT32  skipped;            /* presence checks answered by recent tag traffic */
+    UINT32  failed;             /* presence checks which found the tag gone       */
+    UINT32  probe_ms;           /* time taken by probes of RW module (in ms)      */
+    UINT32  sleep_wake_ms;      /* time taken by sleep/wake (in ms)               */
+} tNFA_RW_PRESENCE_CHECK_STATS;
+
 
 
 /*****************************************************************************
@@ -105,6 +117,30 @@ NFC_API extern tNFA_STATUS NFA_RwDetectNDef (void);
 *******************************************************************************/
 NFC_API extern tNFA_STATUS NFA_RwReadNDef (void);
 
+/*******************************************************************************
+**
+** Function         NFA_RwReadNDefStream
+**
+** Description      Read NDEF message from tag like NFA_RwReadNDef, but pass it
+**                  to the application in segments as it is read from the tag,
+**                  instead of collecting the whole message first.
+**
+**                  Each segment is sent with a NFA_NDEF_READ_SEG_EVT, which
+**                  also tells where NDEF records start and end in the segment.
+**                  The message is not sent to the handlers registered with
+**                  NFA_RegisterNDefTypeHandler. NFA_READ_CPLT_EVT is sent when
+**                  the read is done.
+**
+**                  Type 1 tags are small and are read whole before being sent
+**                  as a single segment.
+**
+** Returns:
+**                  NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+NFC_API extern tNFA_STATUS NFA_RwReadNDefStream (void);
+
 /*******************************************************************************
 **
 ** Function         NFA_RwWriteNDef
@@ -145,6 +181,18 @@ NFC_API extern tNFA_STATUS NFA_RwWriteNDef (UINT8 *p_data, UINT32 len);
 *****************************************************************************/
 NFC_API extern tNFA_STATUS NFA_RwPresenceCheck (void);
 
+/*****************************************************************************
+**
+** Function         NFA_RwGetPresenceCheckStats
+**
+** Description      Get the presence check counters. They are updated by
+**                  NFA task, so the values may be from different checks.
+**
+** Returns          void
+**
+*****************************************************************************/
+NFC_API extern void NFA_RwGetPresenceCheckStats (tNFA_RW_PRESENCE_CHECK_STATS *p_stats);
+
 /*****************************************************************************
 **
 ** Function         NFA_RwFormatTag
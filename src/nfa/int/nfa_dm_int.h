@@ -58,6 +58,7 @@ enum
     NFA_DM_API_REG_VSC_EVT,
     NFA_DM_API_SEND_VSC_EVT,
     NFA_DM_TIMEOUT_DISABLE_EVT,
+    NFA_DM_NV_READ_EVT,
     NFA_DM_MAX_EVT
 };
 
@@ -94,6 +95,14 @@ typedef struct
     tNFA_PMID          *p_pmids;
 } tNFA_DM_API_GET_CONFIG;
 
+/* data type for NFA_DM_NV_READ_EVT */
+typedef struct
+{
+    BT_HDR              hdr;
+    tNFA_STATUS         status;
+    UINT16              size;
+} tNFA_DM_NV_READ;
+
 /* data type for NFA_DM_API_REQ_EXCL_RF_CTRL_EVT */
 typedef struct
 {
@@ -218,6 +227,7 @@ typedef union
     tNFA_DM_API_DEACTIVATE          deactivate;         /* NFA_DM_API_DEACTIVATE_EVT            */
     tNFA_DM_API_SEND_VSC            send_vsc;           /* NFA_DM_API_SEND_VSC_EVT              */
     tNFA_DM_API_REG_VSC             reg_vsc;            /* NFA_DM_API_REG_VSC_EVT               */
+    tNFA_DM_NV_READ                 nv_read;            /* NFA_DM_NV_READ_EVT                   */
 } tNFA_DM_MSG;
 
 /* DM RF discovery state */
@@ -442,6 +452,29 @@ typedef struct
     UINT8 atr_res_gen_bytes_len;
 } tNFA_DM_PARAMS;
 
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+#define NFA_DM_CFG_SHADOW_MAGIC     0x4853464E  /* "NFSH" */
+
+/* NCI config the NFCC holds once enabled, before NFA sets any; kept in DM_NV_BLOCK */
+typedef struct
+{
+    UINT32          magic;                          /* NFA_DM_CFG_SHADOW_MAGIC                  */
+    UINT16          size;                           /* sizeof (tNFA_DM_CFG_SHADOW)              */
+    UINT8           manufacture_id;                 /* NFCC the shadow was read from            */
+    UINT8           nfcc_info[NFC_NFCC_INFO_LEN];
+    UINT32          startup_cfg_id;                 /* nfa_dm_startup_cfg_id when it was read   */
+    BOOLEAN         valid;                          /* FALSE if NFCC could not report its config*/
+    tNFA_DM_PARAMS  params;
+} tNFA_DM_CFG_SHADOW;
+
+/* state of the config shadow */
+#define NFA_DM_CFG_SHADOW_ST_NONE       0   /* no shadow for this NFCC              */
+#define NFA_DM_CFG_SHADOW_ST_READING    1   /* waiting for nfa_nv_ci_read ()        */
+#define NFA_DM_CFG_SHADOW_ST_READ       2   /* read from NVM, not checked yet       */
+#define NFA_DM_CFG_SHADOW_ST_LEARNING   3   /* waiting for GET_CONFIG responses     */
+#define NFA_DM_CFG_SHADOW_ST_KNOWN      4   /* shadow is for this NFCC              */
+#endif
+
 /* DM control block */
 typedef struct
 {
@@ -482,6 +515,13 @@ typedef struct
 
     /* NFCC power mode */
     UINT8                       nfcc_pwr_mode;          /* NFA_DM_PWR_MODE_FULL or NFA_DM_PWR_MODE_OFF_SLEEP */
+
+#if (NFA_DM_CFG_SHADOW_INCLUDED == TRUE)
+    /* NFCC config after enable */
+    tNFA_DM_CFG_SHADOW          cfg_shadow;
+    UINT8                       cfg_shadow_state;       /* NFA_DM_CFG_SHADOW_ST_xxx */
+    UINT8                       cfg_shadow_num_get;     /* GET_CONFIGs pending while learning */
+#endif
 } tNFA_DM_CB;
 
 /* Internal function prototypes */
@@ -506,6 +546,7 @@ extern UINT8 *p_nfa_dm_gen_cfg;
 extern UINT8 nfa_ee_max_ee_cfg;
 extern tNCI_DISCOVER_MAPS *p_nfa_dm_interface_mapping;
 extern UINT8 nfa_dm_num_dm_interface_mapping;
+extern UINT32 nfa_dm_startup_cfg_id;
 
 /* NFA device manager control block */
 #if NFA_DYNAMIC_MEMORY == FALSE
@@ -553,6 +594,7 @@ BOOLEAN nfa_dm_act_reg_vsc (tNFA_DM_MSG *p_data);
 BOOLEAN nfa_dm_act_send_vsc (tNFA_DM_MSG *p_data);
 BOOLEAN nfa_dm_act_disable_timeout (tNFA_DM_MSG *p_data);
 BOOLEAN nfa_dm_act_nfc_cback_data (tNFA_DM_MSG *p_data);
+BOOLEAN nfa_dm_act_nv_read (tNFA_DM_MSG *p_data);
 
 void nfa_dm_proc_nfcc_power_mode (UINT8 nfcc_power_mode);
 
@@ -561,6 +603,7 @@ BOOLEAN nfa_dm_evt_hdlr (BT_HDR *p_msg);
 void nfa_dm_sys_enable (void);
 void nfa_dm_sys_disable (void);
 tNFA_STATUS nfa_dm_check_set_config (UINT8 tlv_list_len, UINT8 *p_tlv_list, BOOLEAN app_init);
+UINT8 *nfa_dm_get_stored_param (tNFA_DM_PARAMS *p_params, UINT8 type, UINT8 *p_max_len, UINT8 **pp_cur_len);
 
 void nfa_dm_conn_cback_event_notify (UINT8 event, tNFA_CONN_EVT_DATA *p_data);
 
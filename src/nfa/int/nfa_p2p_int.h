@@ -61,6 +61,7 @@ enum
     NFA_P2P_API_GET_LINK_INFO_EVT,
     NFA_P2P_API_GET_REMOTE_SAP_EVT,
     NFA_P2P_API_SET_LLCP_CFG_EVT,
+    NFA_P2P_API_SET_TX_PRIORITY_EVT,
 
     NFA_P2P_LAST_EVT
 };
@@ -180,6 +181,15 @@ typedef struct
     UINT16              delay_first_pdu_timeout;
 } tNFA_P2P_API_SET_LLCP_CFG;
 
+/* data type for NFA_P2P_API_SET_TX_PRIORITY_EVT */
+typedef struct
+{
+    BT_HDR              hdr;
+    tNFA_HANDLE         handle;
+    UINT8               weight;
+    BOOLEAN             low_latency;
+} tNFA_P2P_API_SET_TX_PRIORITY;
+
 /* union of all event data types */
 typedef union
 {
@@ -197,6 +207,7 @@ typedef union
     tNFA_P2P_API_GET_LINK_INFO  api_link_info;
     tNFA_P2P_API_GET_REMOTE_SAP api_remote_sap;
     tNFA_P2P_API_SET_LLCP_CFG   api_set_llcp_cfg;
+    tNFA_P2P_API_SET_TX_PRIORITY api_set_tx_priority;
 } tNFA_P2P_MSG;
 
 /*****************************************************************************
@@ -316,6 +327,7 @@ BOOLEAN nfa_p2p_set_local_busy (tNFA_P2P_MSG *p_msg);
 BOOLEAN nfa_p2p_get_link_info (tNFA_P2P_MSG *p_msg);
 BOOLEAN nfa_p2p_get_remote_sap (tNFA_P2P_MSG *p_msg);
 BOOLEAN nfa_p2p_set_llcp_cfg (tNFA_P2P_MSG *p_msg);
+BOOLEAN nfa_p2p_set_tx_priority (tNFA_P2P_MSG *p_msg);
 
 #if (BT_TRACE_VERBOSE == TRUE)
 char *nfa_p2p_evt_code (UINT16 evt_code);
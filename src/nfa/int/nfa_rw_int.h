@@ -39,6 +39,24 @@
 #define NFA_RW_PRESENCE_CHECK_INTERVAL  750
 #endif
 
+/* Longest interval for presence check, reached while the tag stays idle (in ms) */
+#ifndef NFA_RW_PRESENCE_CHECK_MAX_INTERVAL
+#define NFA_RW_PRESENCE_CHECK_MAX_INTERVAL  3000
+#endif
+
+/* A tag response within this time answers NFA_RwPresenceCheck without a probe (in ms) */
+#ifndef NFA_RW_PRESENCE_CHECK_PROOF_TIME
+#define NFA_RW_PRESENCE_CHECK_PROOF_TIME    100
+#endif
+
+/* Longest NDEF record header before type: flags, type length, payload length, ID length */
+#define NFA_RW_NDEF_REC_HDR_MAX_LEN     7
+
+/* Presence check methods */
+#define NFA_RW_PC_METHOD_NONE           0   /* No presence check in progress                */
+#define NFA_RW_PC_METHOD_RW             1   /* Presence check command of RW module          */
+#define NFA_RW_PC_METHOD_SLEEP_WAKE     2   /* DM puts the tag to sleep and wakes it up     */
+
 /* TLV detection status */
 #define NFA_RW_TLV_DETECT_ST_OP_NOT_STARTED         0x00 /* No Tlv detected */
 #define NFA_RW_TLV_DETECT_ST_LOCK_TLV_OP_COMPLETE   0x01 /* Lock control tlv detected */
@@ -124,6 +142,12 @@ typedef struct
     UINT8           *p_data;
 } tNFA_RW_OP_PARAMS_WRITE_NDEF;
 
+/* NFA_RW_OP_READ_NDEF params */
+typedef struct
+{
+    BOOLEAN         b_stream;       /* TRUE to send NDEF message in segments */
+} tNFA_RW_OP_PARAMS_READ_NDEF;
+
 /* NFA_RW_OP_SEND_RAW_FRAME params */
 typedef struct
 {
@@ -203,6 +227,9 @@ typedef struct
 /* Union of params for all reader/writer operations */
 typedef union
 {
+    /* params for NFA_RW_OP_READ_NDEF */
+    tNFA_RW_OP_PARAMS_READ_NDEF         read_ndef;
+
     /* params for NFA_RW_OP_WRITE_NDEF */
     tNFA_RW_OP_PARAMS_WRITE_NDEF        write_ndef;
 
@@ -271,12 +298,21 @@ typedef UINT8 tNFA_RW_NDEF_ST;
 #define NFA_RW_FL_ACTIVATION_NTF_PENDING        0x08    /* Busy retrieving additional tag information                               */
 #define NFA_RW_FL_API_BUSY                      0x10    /* Tag operation is in progress                                             */
 #define NFA_RW_FL_ACTIVATED                     0x20    /* Tag is been activated                                                    */
+#define NFA_RW_FL_NDEF_STREAM                   0x40    /* NDEF message is read in segments (NFA_RwReadNDefStream)                  */
 
 /* NFA RW control block */
 typedef struct
 {
     tNFA_RW_OP      cur_op;         /* Current operation */
 
+    /* Presence check */
+    UINT32          pc_interval;    /* current interval of auto presence check (in ms) */
+    UINT32          pc_rsp_ticks;   /* GKI ticks of the latest response from tag, other than to presence check */
+    UINT32          pc_timer_ticks; /* GKI ticks when the auto presence check timer started */
+    UINT32          pc_start_ticks; /* GKI ticks when the presence check started */
+    UINT8           pc_method;      /* NFA_RW_PC_METHOD_xxx in progress */
+    tNFA_RW_PRESENCE_CHECK_STATS pc_stats;
+
     TIMER_LIST_ENT  tle;            /* list entry for nfa_rw timer */
     tNFA_RW_MSG     *p_pending_msg; /* Pending API (if busy performing presence check) */
 
@@ -296,6 +332,9 @@ typedef struct
     UINT32          ndef_cur_size;  /* current size of stored NDEF data (in bytes) */
     UINT8           *p_ndef_buf;
     UINT32          ndef_rd_offset; /* current read-offset of incoming NDEF data */
+    UINT32          ndef_rec_remain;/* streamed read: bytes left in current record */
+    UINT8           ndef_rec_hdr_len;/* streamed read: bytes of record header received */
+    UINT8           ndef_rec_hdr[NFA_RW_NDEF_REC_HDR_MAX_LEN];
 
     /* Current NDEF Write info */
     UINT8           *p_ndef_wr_buf; /* Pointer to NDEF data being written */
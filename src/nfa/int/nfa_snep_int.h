@@ -202,6 +202,7 @@ typedef struct
 typedef struct
 {
     tNFA_SNEP_CONN      conn[NFA_SNEP_MAX_CONN];
+    UINT8               conn_by_dlink[LLCP_MAX_DATA_LINK]; /* conn index found by data link index of LLCP */
     BOOLEAN             listen_enabled;
     BOOLEAN             is_dta_mode;
     UINT8               trace_level;
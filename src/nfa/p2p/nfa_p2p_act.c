@@ -48,27 +48,37 @@
 **
 ** Function         nfa_p2p_allocate_conn_cb
 **
-** Description      Allocate data link connection control block
+** Description      Allocate data link connection control block at the same
+**                  index as data link connection of LLCP if it's free
 **
 **
 ** Returns          UINT8
 **
 *******************************************************************************/
-static UINT8 nfa_p2p_allocate_conn_cb (UINT8 local_sap)
+static UINT8 nfa_p2p_allocate_conn_cb (UINT8 local_sap, UINT8 remote_sap)
 {
     UINT8 xx;
 
-    for (xx = 0; xx < LLCP_MAX_DATA_LINK; xx++)
+    xx = LLCP_GetDataLinkIndex (local_sap, remote_sap);
+
+    if ((xx >= LLCP_MAX_DATA_LINK) || (nfa_p2p_cb.conn_cb[xx].flags != 0))
     {
-        if (nfa_p2p_cb.conn_cb[xx].flags == 0)
+        for (xx = 0; xx < LLCP_MAX_DATA_LINK; xx++)
         {
-            nfa_p2p_cb.conn_cb[xx].flags |= NFA_P2P_CONN_FLAG_IN_USE;
-            nfa_p2p_cb.conn_cb[xx].local_sap = local_sap;
-
-            return (xx);
+            if (nfa_p2p_cb.conn_cb[xx].flags == 0)
+                break;
         }
     }
 
+    if (xx < LLCP_MAX_DATA_LINK)
+    {
+        nfa_p2p_cb.conn_cb[xx].flags     |= NFA_P2P_CONN_FLAG_IN_USE;
+        nfa_p2p_cb.conn_cb[xx].local_sap  = local_sap;
+        nfa_p2p_cb.conn_cb[xx].remote_sap = remote_sap;
+
+        return (xx);
+    }
+
     P2P_TRACE_ERROR0 ("nfa_p2p_allocate_conn_cb (): No resource");
 
     return LLCP_MAX_DATA_LINK;
@@ -110,6 +120,17 @@ static UINT8 nfa_p2p_find_conn_cb (UINT8 local_sap, UINT8 remote_sap)
 {
     UINT8 xx;
 
+    /* it's mostly at the same index as data link connection of LLCP */
+    xx = LLCP_GetDataLinkIndex (local_sap, remote_sap);
+
+    if (  (xx < LLCP_MAX_DATA_LINK)
+        &&(nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_IN_USE)
+        &&(nfa_p2p_cb.conn_cb[xx].local_sap == local_sap)
+        &&(nfa_p2p_cb.conn_cb[xx].remote_sap == remote_sap)  )
+    {
+        return (xx);
+    }
+
     for (xx = 0; xx < LLCP_MAX_DATA_LINK; xx++)
     {
         if (  (nfa_p2p_cb.conn_cb[xx].flags & NFA_P2P_CONN_FLAG_IN_USE)
@@ -230,16 +251,19 @@ BOOLEAN nfa_p2p_start_sdp (char *p_service_name, UINT8 local_sap)
     {
         if (nfa_p2p_cb.sdp_cb[xx].local_sap == LLCP_INVALID_SAP)
         {
+            /* set before calling LLCP, which may call back with cached SAP */
+            nfa_p2p_cb.sdp_cb[xx].local_sap = local_sap;
+
             if (LLCP_DiscoverService (p_service_name,
                                       nfa_p2p_sdp_cback,
                                       &(nfa_p2p_cb.sdp_cb[xx].tid)) == LLCP_STATUS_SUCCESS)
             {
-                nfa_p2p_cb.sdp_cb[xx].local_sap    = local_sap;
                 return TRUE;
             }
             else
             {
                 /* failure of SDP */
+                nfa_p2p_cb.sdp_cb[xx].local_sap = LLCP_INVALID_SAP;
                 return FALSE;
             }
         }
@@ -317,11 +341,10 @@ void nfa_p2p_proc_llcp_connect_ind (tLLCP_SAP_CBACK_DATA  *p_data)
 
     if (nfa_p2p_cb.sap_cb[server_sap].p_cback)
     {
-        xx = nfa_p2p_allocate_conn_cb (server_sap);
+        xx = nfa_p2p_allocate_conn_cb (server_sap, p_data->connect_ind.remote_sap);
 
         if (xx != LLCP_MAX_DATA_LINK)
         {
-            nfa_p2p_cb.conn_cb[xx].remote_sap = p_data->connect_ind.remote_sap;
             nfa_p2p_cb.conn_cb[xx].remote_miu = p_data->connect_ind.miu;
 
             /* peer will not receive any data */
@@ -364,11 +387,10 @@ void nfa_p2p_proc_llcp_connect_resp (tLLCP_SAP_CBACK_DATA  *p_data)
 
     if (nfa_p2p_cb.sap_cb[local_sap].p_cback)
     {
-        xx = nfa_p2p_allocate_conn_cb (local_sap);
+        xx = nfa_p2p_allocate_conn_cb (local_sap, p_data->connect_resp.remote_sap);
 
         if (xx != LLCP_MAX_DATA_LINK)
         {
-            nfa_p2p_cb.conn_cb[xx].remote_sap = p_data->connect_resp.remote_sap;
             nfa_p2p_cb.conn_cb[xx].remote_miu = p_data->connect_resp.miu;
 
             /* peer will not receive any data */
@@ -1215,3 +1237,31 @@ BOOLEAN nfa_p2p_set_llcp_cfg (tNFA_P2P_MSG *p_msg)
 
     return TRUE;
 }
+
+/*******************************************************************************
+**
+** Function         nfa_p2p_set_tx_priority
+**
+** Description      Set scheduling weight and class of a server or client
+**
+**
+** Returns          TRUE to deallocate buffer
+**
+*******************************************************************************/
+BOOLEAN nfa_p2p_set_tx_priority (tNFA_P2P_MSG *p_msg)
+{
+    UINT8 local_sap;
+
+    P2P_TRACE_DEBUG0 ("nfa_p2p_set_tx_priority ()");
+
+    local_sap = (UINT8) (p_msg->api_set_tx_priority.handle & NFA_HANDLE_MASK);
+
+    if (nfa_p2p_cb.sap_cb[local_sap].p_cback)
+    {
+        LLCP_SetTxPriority (local_sap,
+                            p_msg->api_set_tx_priority.weight,
+                            p_msg->api_set_tx_priority.low_latency);
+    }
+
+    return TRUE;
+}
@@ -1135,6 +1135,99 @@ void NFA_P2pGetLLCPConfig (UINT16 *p_link_miu,
 
 }
 
+/*******************************************************************************
+**
+** Function         NFA_P2pSetTxPriority
+**
+** Description      This function is called to set how data of a registered
+**                  server or client is scheduled on LLCP link.
+**
+**                  weight: number of PDUs sent in a row in its turn (0 is
+**                          taken as 1), e.g. higher for bulk transfer
+**                  low_latency: TRUE to send its data before data of other
+**                          services, e.g. for connection handover
+**
+** Returns          NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS NFA_P2pSetTxPriority (tNFA_HANDLE handle,
+                                  UINT8       weight,
+                                  BOOLEAN     low_latency)
+{
+    tNFA_P2P_API_SET_TX_PRIORITY *p_msg;
+    tNFA_HANDLE                   xx;
+
+    P2P_TRACE_API3 ("NFA_P2pSetTxPriority (): handle:0x%02X, weight:%d, low_latency:%d",
+                    handle, weight, low_latency);
+
+    xx = handle & NFA_HANDLE_MASK;
+
+    if (  (xx >= NFA_P2P_NUM_SAP)
+        ||(nfa_p2p_cb.sap_cb[xx].p_cback == NULL)  )
+    {
+        P2P_TRACE_ERROR0 ("NFA_P2pSetTxPriority (): Handle is invalid or not registered");
+        return (NFA_STATUS_BAD_HANDLE);
+    }
+
+    if ((p_msg = (tNFA_P2P_API_SET_TX_PRIORITY *) GKI_getbuf (sizeof (tNFA_P2P_API_SET_TX_PRIORITY))) != NULL)
+    {
+        p_msg->hdr.event = NFA_P2P_API_SET_TX_PRIORITY_EVT;
+
+        p_msg->handle      = handle;
+        p_msg->weight      = weight;
+        p_msg->low_latency = low_latency;
+
+        nfa_sys_sendmsg (p_msg);
+
+        return (NFA_STATUS_OK);
+    }
+
+    return (NFA_STATUS_FAILED);
+}
+
+/*******************************************************************************
+**
+** Function         NFA_P2pGetTxStats
+**
+** Description      This function is called to get the number of PDUs sent
+**                  from a registered server or client and the time they
+**                  waited in tx queue.
+**
+** Returns          NFA_STATUS_OK if successful
+**                  NFA_STATUS_BAD_HANDLE if handle is not valid
+**
+*******************************************************************************/
+tNFA_STATUS NFA_P2pGetTxStats (tNFA_HANDLE     handle,
+                               tLLCP_TX_STATS *p_stats)
+{
+    tNFA_STATUS ret_status;
+    tNFA_HANDLE xx;
+
+    P2P_TRACE_API1 ("NFA_P2pGetTxStats (): handle:0x%X", handle);
+
+    GKI_sched_lock ();
+
+    xx = handle & NFA_HANDLE_MASK;
+
+    if (  (xx >= NFA_P2P_NUM_SAP)
+        ||(nfa_p2p_cb.sap_cb[xx].p_cback == NULL)
+        ||(LLCP_GetTxStats ((UINT8) xx, p_stats) != LLCP_STATUS_SUCCESS)  )
+    {
+        P2P_TRACE_ERROR1 ("NFA_P2pGetTxStats (): Handle(0x%X) is not valid", handle);
+        ret_status = NFA_STATUS_BAD_HANDLE;
+    }
+    else
+    {
+        ret_status = NFA_STATUS_OK;
+    }
+
+    GKI_sched_unlock ();
+
+    return (ret_status);
+}
+
 /*******************************************************************************
 **
 ** Function         NFA_P2pSetTraceLevel
@@ -86,7 +86,8 @@ const tNFA_P2P_ACTION nfa_p2p_action[] =
     nfa_p2p_set_local_busy,                 /* NFA_P2P_API_SET_LOCAL_BUSY_EVT   */
     nfa_p2p_get_link_info,                  /* NFA_P2P_API_GET_LINK_INFO_EVT    */
     nfa_p2p_get_remote_sap,                 /* NFA_P2P_API_GET_REMOTE_SAP_EVT   */
-    nfa_p2p_set_llcp_cfg                    /* NFA_P2P_API_SET_LLCP_CFG_EVT     */
+    nfa_p2p_set_llcp_cfg,                   /* NFA_P2P_API_SET_LLCP_CFG_EVT     */
+    nfa_p2p_set_tx_priority                 /* NFA_P2P_API_SET_TX_PRIORITY_EVT  */
 };
 
 /*******************************************************************************
@@ -623,6 +624,8 @@ char *nfa_p2p_evt_code (UINT16 evt_code)
         return "API_GET_REMOTE_SAP";
     case NFA_P2P_API_SET_LLCP_CFG_EVT:
         return "API_SET_LLCP_CFG_EVT";
+    case NFA_P2P_API_SET_TX_PRIORITY_EVT:
+        return "API_SET_TX_PRIORITY";
     default:
         return "Unknown event";
     }
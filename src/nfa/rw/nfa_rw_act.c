@@ -55,11 +55,115 @@ void nfa_rw_free_ndef_rx_buf(void)
     }
 }
 
+/*******************************************************************************
+**
+** Function         nfa_rw_send_ndef_seg
+**
+** Description      Send a segment of the NDEF message being read to the app.
+**                  The record headers in the segment are followed, also across
+**                  segments, to tell the app where records start and end.
+**
+** Returns          Nothing
+**
+*******************************************************************************/
+static void nfa_rw_send_ndef_seg (UINT8 *p_data, UINT16 len)
+{
+    tNFA_CONN_EVT_DATA conn_evt_data;
+    UINT8   *p_hdr = nfa_rw_cb.ndef_rec_hdr;
+    UINT8   *p;
+    UINT8   hdr_len;
+    UINT32  payload_len;
+    UINT16  idx = 0;
+    UINT16  n;
+
+    conn_evt_data.ndef_read_seg.rec_start = NFA_NDEF_SEG_NO_REC;
+    conn_evt_data.ndef_read_seg.rec_end   = 0;
+
+    while (idx < len)
+    {
+        if (nfa_rw_cb.ndef_rec_remain)
+        {
+            /* Skip type, ID and payload of the current record */
+            n = (nfa_rw_cb.ndef_rec_remain < (UINT32) (len - idx)) ? (UINT16) nfa_rw_cb.ndef_rec_remain : (len - idx);
+            idx += n;
+            nfa_rw_cb.ndef_rec_remain -= n;
+
+            if (nfa_rw_cb.ndef_rec_remain == 0)
+                conn_evt_data.ndef_read_seg.rec_end = idx;
+            continue;
+        }
+
+        if (  (nfa_rw_cb.ndef_rec_hdr_len == 0)
+            &&(conn_evt_data.ndef_read_seg.rec_start == NFA_NDEF_SEG_NO_REC)  )
+            conn_evt_data.ndef_read_seg.rec_start = idx;
+
+        p_hdr[nfa_rw_cb.ndef_rec_hdr_len++] = p_data[idx++];
+
+        hdr_len = 2 + ((p_hdr[0] & NDEF_SR_MASK) ? 1 : 4) + ((p_hdr[0] & NDEF_IL_MASK) ? 1 : 0);
+        if (nfa_rw_cb.ndef_rec_hdr_len < hdr_len)
+            continue;
+
+        /* Record header complete: get the length of the rest of the record */
+        p = &p_hdr[2];
+        if (p_hdr[0] & NDEF_SR_MASK)
+        {
+            STREAM_TO_UINT8 (payload_len, p);
+        }
+        else
+        {
+            BE_STREAM_TO_UINT32 (payload_len, p);
+        }
+
+        nfa_rw_cb.ndef_rec_remain  = p_hdr[1] + payload_len;
+        if (p_hdr[0] & NDEF_IL_MASK)
+            nfa_rw_cb.ndef_rec_remain += *p;
+        nfa_rw_cb.ndef_rec_hdr_len = 0;
+
+        if (nfa_rw_cb.ndef_rec_remain == 0)
+            conn_evt_data.ndef_read_seg.rec_end = idx;
+    }
+
+    conn_evt_data.ndef_read_seg.offset  = nfa_rw_cb.ndef_rd_offset;
+    conn_evt_data.ndef_read_seg.msg_len = nfa_rw_cb.ndef_cur_size;
+    conn_evt_data.ndef_read_seg.p_data  = p_data;
+    conn_evt_data.ndef_read_seg.len     = len;
+    nfa_rw_cb.ndef_rd_offset += len;
+
+    nfa_dm_act_conn_cback_notify (NFA_NDEF_READ_SEG_EVT, &conn_evt_data);
+}
+
+/*******************************************************************************
+**
+** Function         nfa_rw_ndef_handle_message
+**
+** Description      Pass the result of reading the NDEF message to the NDEF
+**                  handlers, or for a streamed read, send what is not sent yet
+**
+** Returns          Nothing
+**
+*******************************************************************************/
+static void nfa_rw_ndef_handle_message (tNFA_STATUS status)
+{
+    if (!(nfa_rw_cb.flags & NFA_RW_FL_NDEF_STREAM))
+    {
+        if (status == NFA_STATUS_OK)
+            nfa_dm_ndef_handle_message (NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+        else
+            nfa_dm_ndef_handle_message (NFA_STATUS_FAILED, NULL, 0);
+    }
+    else if ((status == NFA_STATUS_OK) && (nfa_rw_cb.p_ndef_buf))
+    {
+        /* Type 1 tag is read whole into the NDEF buffer */
+        nfa_rw_send_ndef_seg (nfa_rw_cb.p_ndef_buf, (UINT16) nfa_rw_cb.ndef_cur_size);
+    }
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_rw_store_ndef_rx_buf
 **
-** Description      Store data into NDEF buffer
+** Description      Store data into NDEF buffer, or send it to the app if the
+**                  NDEF message is streamed
 **
 ** Returns          Nothing
 **
@@ -70,9 +174,16 @@ static void nfa_rw_store_ndef_rx_buf (tRW_DATA *p_rw_data)
 
     p = (UINT8 *)(p_rw_data->data.p_data + 1) + p_rw_data->data.p_data->offset;
 
-    /* Save data into buffer */
-    memcpy(&nfa_rw_cb.p_ndef_buf[nfa_rw_cb.ndef_rd_offset], p, p_rw_data->data.p_data->len);
-    nfa_rw_cb.ndef_rd_offset += p_rw_data->data.p_data->len;
+    if (nfa_rw_cb.flags & NFA_RW_FL_NDEF_STREAM)
+    {
+        nfa_rw_send_ndef_seg (p, p_rw_data->data.p_data->len);
+    }
+    else
+    {
+        /* Save data into buffer */
+        memcpy(&nfa_rw_cb.p_ndef_buf[nfa_rw_cb.ndef_rd_offset], p, p_rw_data->data.p_data->len);
+        nfa_rw_cb.ndef_rd_offset += p_rw_data->data.p_data->len;
+    }
 
     GKI_freebuf(p_rw_data->data.p_data);
     p_rw_data->data.p_data = NULL;
@@ -140,7 +251,8 @@ static void nfa_rw_check_start_presence_check_timer (void)
     if (nfa_rw_cb.flags & NFA_RW_FL_NOT_EXCL_RF_MODE)
     {
         NFA_TRACE_DEBUG0("Starting presence check timer...");
-        nfa_sys_start_timer(&nfa_rw_cb.tle, NFA_RW_PRESENCE_CHECK_TICK_EVT, NFA_RW_PRESENCE_CHECK_INTERVAL);
+        nfa_rw_cb.pc_timer_ticks = GKI_get_tick_count ();
+        nfa_sys_start_timer(&nfa_rw_cb.tle, NFA_RW_PRESENCE_CHECK_TICK_EVT, nfa_rw_cb.pc_interval);
     }
 #endif   /* NFA_DM_AUTO_PRESENCE_CHECK  */
 }
@@ -160,6 +272,66 @@ void nfa_rw_stop_presence_check_timer(void)
     NFA_TRACE_DEBUG0("Stopped presence check timer (if started)");
 }
 
+/*******************************************************************************
+**
+** Function         nfa_rw_presence_check_done
+**
+** Description      Account for the time and result of the presence check in
+**                  progress. An auto presence check which found the tag
+**                  makes the next one come later, up to
+**                  NFA_RW_PRESENCE_CHECK_MAX_INTERVAL.
+**
+** Returns          Nothing
+**
+*******************************************************************************/
+static void nfa_rw_presence_check_done (tNFC_STATUS status)
+{
+    UINT32 elapsed_ms = GKI_TICKS_TO_MS (GKI_get_tick_count () - nfa_rw_cb.pc_start_ticks);
+
+    if (nfa_rw_cb.pc_method == NFA_RW_PC_METHOD_NONE)
+        return;
+
+    if (nfa_rw_cb.pc_method == NFA_RW_PC_METHOD_RW)
+        nfa_rw_cb.pc_stats.probe_ms += elapsed_ms;
+    else
+        nfa_rw_cb.pc_stats.sleep_wake_ms += elapsed_ms;
+    nfa_rw_cb.pc_method = NFA_RW_PC_METHOD_NONE;
+
+    if (status != NFC_STATUS_OK)
+    {
+        nfa_rw_cb.pc_stats.failed++;
+        return;
+    }
+
+    /* Tag is idle: check less often */
+    if (nfa_rw_cb.flags & NFA_RW_FL_AUTO_PRESENCE_CHECK_BUSY)
+    {
+        nfa_rw_cb.pc_interval += nfa_rw_cb.pc_interval / 2;
+        if (nfa_rw_cb.pc_interval > NFA_RW_PRESENCE_CHECK_MAX_INTERVAL)
+            nfa_rw_cb.pc_interval = NFA_RW_PRESENCE_CHECK_MAX_INTERVAL;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         nfa_rw_tag_responded
+**
+** Description      Note that the tag answered an operation other than presence
+**                  check, which proves it is present and in use. The answer
+**                  to a presence check itself proves nothing for the next one.
+**
+** Returns          Nothing
+**
+*******************************************************************************/
+static void nfa_rw_tag_responded (void)
+{
+    if (nfa_rw_cb.cur_op == NFA_RW_OP_PRESENCE_CHECK)
+        return;
+
+    nfa_rw_cb.pc_rsp_ticks = GKI_get_tick_count ();
+    nfa_rw_cb.pc_interval  = NFA_RW_PRESENCE_CHECK_INTERVAL;
+}
+
 /*******************************************************************************
 **
 ** Function         nfa_rw_handle_ndef_detect
@@ -239,7 +411,7 @@ static void nfa_rw_handle_ndef_detect(tRW_EVENT event, tRW_DATA *p_rw_data)
         if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
         {
             /* if ndef detection was done as part of ndef-read operation, then notify NDEF handlers of failure */
-            nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+            nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
 
             /* Notify app of read status */
             conn_evt_data.status = NFC_STATUS_FAILED;
@@ -381,6 +553,8 @@ void nfa_rw_handle_presence_check_rsp (tNFC_STATUS status)
 {
     BT_HDR *p_pending_msg;
 
+    nfa_rw_presence_check_done (status);
+
     if (status == NFA_STATUS_OK)
     {
         /* Clear the BUSY flag and restart the presence-check timer */
@@ -499,7 +673,7 @@ static void nfa_rw_handle_t1t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         if (p_rw_data->status == NFC_STATUS_OK)
         {
             /* Process the ndef record */
-            nfa_dm_ndef_handle_message(NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+            nfa_rw_ndef_handle_message(NFA_STATUS_OK);
         }
         else
         {
@@ -507,7 +681,7 @@ static void nfa_rw_handle_t1t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
             {
                 /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-                nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+                nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
             }
         }
 
@@ -615,11 +789,15 @@ static void nfa_rw_handle_t2t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         nfa_rw_handle_tlv_detect(event, p_rw_data);
         break;
 
+    case RW_T2T_NDEF_READ_SEG_EVT:          /* Segment of streamed NDEF read */
+        nfa_rw_store_ndef_rx_buf (p_rw_data);
+        break;
+
     case RW_T2T_NDEF_READ_EVT:              /* NDEF read completed     */
         if (p_rw_data->status == NFC_STATUS_OK)
         {
             /* Process the ndef record */
-            nfa_dm_ndef_handle_message(NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+            nfa_rw_ndef_handle_message(NFA_STATUS_OK);
         }
         else
         {
@@ -627,7 +805,7 @@ static void nfa_rw_handle_t2t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
             {
                 /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-                nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+                nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
             }
         }
 
@@ -732,7 +910,7 @@ static void nfa_rw_handle_t3t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         if (p_rw_data->status == NFC_STATUS_OK)
         {
             /* Process the ndef record */
-            nfa_dm_ndef_handle_message(NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+            nfa_rw_ndef_handle_message(NFA_STATUS_OK);
         }
         else
         {
@@ -740,7 +918,7 @@ static void nfa_rw_handle_t3t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
             {
                 /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-                nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+                nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
             }
         }
 
@@ -851,7 +1029,7 @@ static void nfa_rw_handle_t4t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             nfa_rw_store_ndef_rx_buf (p_rw_data);
 
             /* Process the ndef record */
-            nfa_dm_ndef_handle_message (NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+            nfa_rw_ndef_handle_message (NFA_STATUS_OK);
 
             /* Free ndef buffer */
             nfa_rw_free_ndef_rx_buf();
@@ -872,7 +1050,7 @@ static void nfa_rw_handle_t4t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
         {
             /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-            nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+            nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
 
             /* Free ndef buffer */
             nfa_rw_free_ndef_rx_buf();
@@ -919,7 +1097,7 @@ static void nfa_rw_handle_t4t_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
         {
             /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-            nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+            nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
 
             /* Free ndef buffer */
             nfa_rw_free_ndef_rx_buf();
@@ -1002,7 +1180,7 @@ static void nfa_rw_handle_i93_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             nfa_rw_store_ndef_rx_buf (p_rw_data);
 
             /* Process the ndef record */
-            nfa_dm_ndef_handle_message (NFA_STATUS_OK, nfa_rw_cb.p_ndef_buf, nfa_rw_cb.ndef_cur_size);
+            nfa_rw_ndef_handle_message (NFA_STATUS_OK);
 
             /* Free ndef buffer */
             nfa_rw_free_ndef_rx_buf();
@@ -1023,7 +1201,7 @@ static void nfa_rw_handle_i93_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
         if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
         {
             /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-            nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+            nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
 
             /* Free ndef buffer */
             nfa_rw_free_ndef_rx_buf();
@@ -1084,7 +1262,7 @@ static void nfa_rw_handle_i93_evt (tRW_EVENT event, tRW_DATA *p_rw_data)
             if (nfa_rw_cb.cur_op == NFA_RW_OP_READ_NDEF)
             {
                 /* If current operation is READ_NDEF, then notify ndef handlers of failure */
-                nfa_dm_ndef_handle_message(NFA_STATUS_FAILED, NULL, 0);
+                nfa_rw_ndef_handle_message(NFA_STATUS_FAILED);
 
                 /* Free ndef buffer */
                 nfa_rw_free_ndef_rx_buf();
@@ -1307,6 +1485,9 @@ static void nfa_rw_cback (tRW_EVENT event, tRW_DATA *p_rw_data)
 {
     NFA_TRACE_DEBUG1("nfa_rw_cback: event=0x%02x", event);
 
+    if (p_rw_data->status == NFC_STATUS_OK)
+        nfa_rw_tag_responded ();
+
     /* Call appropriate event handler for tag type */
     if (event < RW_T1T_MAX_EVT)
     {
@@ -1404,7 +1585,8 @@ static tNFC_STATUS nfa_rw_start_ndef_read(void)
         NFA_TRACE_DEBUG0("NDEF message is zero-length");
 
         /* Send zero-lengh NDEF message to ndef callback */
-        nfa_dm_ndef_handle_message(NFA_STATUS_OK, NULL, 0);
+        if (!(nfa_rw_cb.flags & NFA_RW_FL_NDEF_STREAM))
+            nfa_dm_ndef_handle_message(NFA_STATUS_OK, NULL, 0);
 
         /* Command complete - perform cleanup, notify app */
         nfa_rw_command_complete();
@@ -1413,9 +1595,19 @@ static tNFC_STATUS nfa_rw_start_ndef_read(void)
         return NFC_STATUS_OK;
     }
 
-    /* Allocate buffer for incoming NDEF message (free previous NDEF rx buffer, if needed) */
+    /* Allocate buffer for incoming NDEF message (free previous NDEF rx buffer, if needed).
+    ** A streamed NDEF message is sent to the app as it is read, except from Type 1 tag. */
     nfa_rw_free_ndef_rx_buf ();
-    if ((nfa_rw_cb.p_ndef_buf = (UINT8 *)nfa_mem_co_alloc(nfa_rw_cb.ndef_cur_size)) == NULL)
+    nfa_rw_cb.ndef_rd_offset   = 0;
+    nfa_rw_cb.ndef_rec_remain  = 0;
+    nfa_rw_cb.ndef_rec_hdr_len = 0;
+
+    if (  (nfa_rw_cb.flags & NFA_RW_FL_NDEF_STREAM)
+        &&(protocol != NFC_PROTOCOL_T1T)  )
+    {
+        NFA_TRACE_DEBUG1("Streaming NDEF message (size=%i)", nfa_rw_cb.ndef_cur_size);
+    }
+    else if ((nfa_rw_cb.p_ndef_buf = (UINT8 *)nfa_mem_co_alloc(nfa_rw_cb.ndef_cur_size)) == NULL)
     {
         NFA_TRACE_ERROR1("Unable to allocate a buffer for reading NDEF (size=%i)", nfa_rw_cb.ndef_cur_size);
 
@@ -1425,7 +1617,6 @@ static tNFC_STATUS nfa_rw_start_ndef_read(void)
         nfa_dm_act_conn_cback_notify(NFA_READ_CPLT_EVT, &conn_evt_data);
         return NFC_STATUS_FAILED;
     }
-    nfa_rw_cb.ndef_rd_offset = 0;
 
     switch (protocol)
     {
@@ -1435,7 +1626,7 @@ static tNFC_STATUS nfa_rw_start_ndef_read(void)
 
     case NFC_PROTOCOL_T2T:   /* Type2Tag    - NFC-A */
         if (nfa_rw_cb.pa_sel_res == NFC_SEL_RES_NFC_FORUM_T2T)
-            status = RW_T2tReadNDef(nfa_rw_cb.p_ndef_buf,(UINT16)nfa_rw_cb.ndef_cur_size);
+            status = RW_T2tReadNDef(nfa_rw_cb.p_ndef_buf,(UINT16)nfa_rw_cb.ndef_cur_size);   /* NULL buffer if streamed */
 
         break;
 
@@ -1560,6 +1751,11 @@ static BOOLEAN nfa_rw_read_ndef(tNFA_RW_MSG *p_data)
 
     NFA_TRACE_DEBUG0("nfa_rw_read_ndef");
 
+    if (p_data->op_req.params.read_ndef.b_stream)
+        nfa_rw_cb.flags |= NFA_RW_FL_NDEF_STREAM;
+    else
+        nfa_rw_cb.flags &= ~NFA_RW_FL_NDEF_STREAM;
+
     /* Check if ndef detection has been performed yet */
     if (nfa_rw_cb.ndef_st == NFA_RW_NDEF_ST_UNKNOWN)
     {
@@ -1665,6 +1861,27 @@ void nfa_rw_presence_check (tNFA_RW_MSG *p_data)
     tNFC_PROTOCOL       protocol = nfa_rw_cb.protocol;
     UINT8               sel_res  = nfa_rw_cb.pa_sel_res;
     tNFC_STATUS         status   = NFC_STATUS_FAILED;
+    BOOLEAN             proven;
+
+    /* A response from the tag since the auto presence check timer started,
+    ** or just before NFA_RwPresenceCheck, proves the tag is present. The
+    ** timer may expire early, so it is not measured against the interval. */
+    if (p_data)
+        proven = (GKI_TICKS_TO_MS (GKI_get_tick_count () - nfa_rw_cb.pc_rsp_ticks) < NFA_RW_PRESENCE_CHECK_PROOF_TIME);
+    else
+        proven = ((INT32) (nfa_rw_cb.pc_rsp_ticks - nfa_rw_cb.pc_timer_ticks) > 0);
+
+    if (proven)
+    {
+        NFA_TRACE_DEBUG0("Presence check skipped: tag responded recently");
+        nfa_rw_cb.pc_stats.skipped++;
+        nfa_rw_handle_presence_check_rsp(NFC_STATUS_OK);
+        return;
+    }
+
+    /* Use the presence check of RW module; it sends the lightest command of each tag type */
+    nfa_rw_cb.pc_method      = NFA_RW_PC_METHOD_RW;
+    nfa_rw_cb.pc_start_ticks = GKI_get_tick_count ();
 
     switch (protocol)
     {
@@ -1695,10 +1912,16 @@ void nfa_rw_presence_check (tNFA_RW_MSG *p_data)
     default:
         /* Protocol unsupported by RW module... */
         /* Let DM perform presence check (by putting tag to sleep and then waking it up) */
+        nfa_rw_cb.pc_method = NFA_RW_PC_METHOD_SLEEP_WAKE;
         status = nfa_dm_disc_presence_check();
         break;
     }
 
+    if (nfa_rw_cb.pc_method == NFA_RW_PC_METHOD_RW)
+        nfa_rw_cb.pc_stats.probes++;
+    else
+        nfa_rw_cb.pc_stats.sleep_wakes++;
+
     /* Handle presence check failure */
     if (status != NFC_STATUS_OK)
         nfa_rw_handle_presence_check_rsp(NFC_STATUS_FAILED);
@@ -2308,6 +2531,8 @@ static void nfa_rw_raw_mode_data_cback (UINT8 conn_id, tNFC_CONN_EVT event, tNFC
 
     if ((event == NFC_DATA_CEVT) && (p_data->data.status == NFC_STATUS_OK))
     {
+        nfa_rw_tag_responded ();
+
         if (p_msg)
         {
             evt_data.data.p_data = (UINT8 *)(p_msg + 1) + p_msg->offset;
@@ -2356,6 +2581,11 @@ BOOLEAN nfa_rw_activate_ntf(tNFA_RW_MSG *p_data)
     nfa_rw_cb.ndef_st    = NFA_RW_NDEF_ST_UNKNOWN;
     nfa_rw_cb.tlv_st     = NFA_RW_TLV_DETECT_ST_OP_NOT_STARTED;
 
+    /* Activation proves presence; start with the shortest presence check interval */
+    nfa_rw_cb.pc_interval  = NFA_RW_PRESENCE_CHECK_INTERVAL;
+    nfa_rw_cb.pc_rsp_ticks = GKI_get_tick_count ();
+    nfa_rw_cb.pc_method    = NFA_RW_PC_METHOD_NONE;
+
     memset (&tag_params, 0, sizeof(tNFA_TAG_PARAMS));
 
     /* Check if we are in exclusive RF mode */
@@ -113,6 +113,46 @@ tNFA_STATUS NFA_RwReadNDef (void)
     {
         p_msg->hdr.event = NFA_RW_OP_REQUEST_EVT;
         p_msg->op        = NFA_RW_OP_READ_NDEF;
+        p_msg->params.read_ndef.b_stream = FALSE;
+
+        nfa_sys_sendmsg (p_msg);
+
+        return (NFA_STATUS_OK);
+    }
+
+    return (NFA_STATUS_FAILED);
+}
+
+/*******************************************************************************
+**
+** Function         NFA_RwReadNDefStream
+**
+** Description      Read NDEF message from tag like NFA_RwReadNDef, but pass it
+**                  to the application in segments as it is read from the tag,
+**                  instead of collecting the whole message first.
+**
+**                  Each segment is sent with a NFA_NDEF_READ_SEG_EVT, which
+**                  also tells where NDEF records start and end in the segment.
+**                  The message is not sent to the handlers registered with
+**                  NFA_RegisterNDefTypeHandler. NFA_READ_CPLT_EVT is sent when
+**                  the read is done.
+**
+** Returns:
+**                  NFA_STATUS_OK if successfully initiated
+**                  NFA_STATUS_FAILED otherwise
+**
+*******************************************************************************/
+tNFA_STATUS NFA_RwReadNDefStream (void)
+{
+    tNFA_RW_OPERATION *p_msg;
+
+    NFA_TRACE_API0 ("NFA_RwReadNDefStream");
+
+    if ((p_msg = (tNFA_RW_OPERATION *) GKI_getbuf ((UINT16) (sizeof (tNFA_RW_OPERATION)))) != NULL)
+    {
+        p_msg->hdr.event = NFA_RW_OP_REQUEST_EVT;
+        p_msg->op        = NFA_RW_OP_READ_NDEF;
+        p_msg->params.read_ndef.b_stream = TRUE;
 
         nfa_sys_sendmsg (p_msg);
 
@@ -202,6 +242,21 @@ tNFA_STATUS NFA_RwPresenceCheck (void)
     return (NFA_STATUS_FAILED);
 }
 
+/*****************************************************************************
+**
+** Function         NFA_RwGetPresenceCheckStats
+**
+** Description      Get the presence check counters. They are updated by
+**                  NFA task, so the values may be from different checks.
+**
+** Returns          void
+**
+*****************************************************************************/
+void NFA_RwGetPresenceCheckStats (tNFA_RW_PRESENCE_CHECK_STATS *p_stats)
+{
+    memcpy (p_stats, &nfa_rw_cb.pc_stats, sizeof (tNFA_RW_PRESENCE_CHECK_STATS));
+}
+
 /*****************************************************************************
 **
 ** Function         NFA_RwFormatTag
@@ -54,6 +54,9 @@ static char *nfa_snep_opcode (UINT8 opcode);
 **
 ** Description      find a connection control block with SAP
 **
+**                  If remote SAP is given, the connection control block found
+**                  for the data link connection of LLCP last time is checked
+**                  first.
 **
 ** Returns          index of connection control block if success
 **                  NFA_SNEP_MAX_CONN, otherwise
@@ -61,7 +64,26 @@ static char *nfa_snep_opcode (UINT8 opcode);
 *******************************************************************************/
 UINT8 nfa_snep_sap_to_index (UINT8 local_sap, UINT8 remote_sap, UINT8 flags)
 {
-    UINT8 xx;
+    UINT8 xx, dlink = LLCP_MAX_DATA_LINK;
+
+    if (remote_sap != NFA_SNEP_ANY_SAP)
+    {
+        dlink = LLCP_GetDataLinkIndex (local_sap, remote_sap);
+
+        if (dlink < LLCP_MAX_DATA_LINK)
+        {
+            xx = nfa_snep_cb.conn_by_dlink[dlink];
+
+            if (  (xx < NFA_SNEP_MAX_CONN)
+                &&(nfa_snep_cb.conn[xx].p_cback)
+                &&(nfa_snep_cb.conn[xx].local_sap == local_sap)
+                &&(nfa_snep_cb.conn[xx].remote_sap == remote_sap)
+                &&((nfa_snep_cb.conn[xx].flags & flags) == flags)  )
+            {
+                return xx;
+            }
+        }
+    }
 
     for (xx = 0; xx < NFA_SNEP_MAX_CONN; xx++)
     {
@@ -70,6 +92,9 @@ UINT8 nfa_snep_sap_to_index (UINT8 local_sap, UINT8 remote_sap, UINT8 flags)
             &&((remote_sap == NFA_SNEP_ANY_SAP) || (nfa_snep_cb.conn[xx].remote_sap == remote_sap))
             &&((nfa_snep_cb.conn[xx].flags & flags) == flags)  )
         {
+            if (dlink < LLCP_MAX_DATA_LINK)
+                nfa_snep_cb.conn_by_dlink[dlink] = xx;
+
             return xx;
         }
     }
@@ -27,6 +27,7 @@
 #include "nfa_sys_int.h"
 #include "nfa_sys_ptim.h"
 #include "nfa_dm_int.h"
+#include "nfc_latency.h"
 
 /* protocol timer update period, in milliseconds */
 #ifndef NFA_SYS_TIMER_PERIOD
@@ -73,6 +74,13 @@ void nfa_sys_event (BT_HDR *p_msg)
 {
     UINT8       id;
     BOOLEAN     freebuf = TRUE;
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    UINT32      saved_origin = nfc_lat_origin;
+
+    /* events caused by an NCI message are timed from its arrival */
+    nfc_lat_origin = GKI_get_buf_time (p_msg);
+    nfc_lat_since (NFC_LAT_NFA, nfc_lat_origin);
+#endif
 
     NFA_TRACE_EVENT1 ("NFA got event 0x%04X", p_msg->event);
 
@@ -93,6 +101,10 @@ void nfa_sys_event (BT_HDR *p_msg)
     {
         GKI_freebuf (p_msg);
     }
+
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    nfc_lat_origin = saved_origin;
+#endif
 }
 
 /*******************************************************************************
@@ -356,6 +368,11 @@ void nfa_sys_notify_nfcc_power_mode (UINT8 nfcc_power_mode)
 *******************************************************************************/
 void nfa_sys_sendmsg (void *p_msg)
 {
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    /* a message sent while NFC_TASK handles an NCI message is caused by it */
+    if (nfc_lat_origin && (GKI_get_taskid () == NFC_TASK))
+        GKI_set_buf_time (p_msg, nfc_lat_origin);
+#endif
     GKI_send_msg (NFC_TASK, p_nfa_sys_cfg->mbox, p_msg);
 }
 
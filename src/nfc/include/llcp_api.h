@@ -193,6 +193,36 @@ typedef union
 
 typedef void (tLLCP_APP_CBACK) (tLLCP_SAP_CBACK_DATA *p_data);
 
+/* Transmit statistics of a SAP */
+typedef struct
+{
+    UINT32  num_tx_pdu;         /* number of UI and I PDUs sent             */
+    UINT32  total_delay;        /* sum of their time in tx queue (ms)       */
+    UINT32  max_delay;          /* longest time of one in tx queue (ms)     */
+} tLLCP_TX_STATS;
+
+/* Turnaround and aggregation statistics of LLCP link */
+typedef struct
+{
+    UINT16  symm_delay;         /* current delay of SYMM response (ms)                  */
+    UINT16  app_latency;        /* average time to get data from upper layer in turn (ms) */
+    UINT16  app_latency_max;    /* longest time to get data from upper layer (ms)       */
+    UINT16  peer_rsp_time;      /* average time from sending PDU to receiving one (ms)  */
+    UINT16  peer_rsp_time_max;  /* longest time from sending PDU to receiving one (ms)  */
+    UINT32  num_local_turn;     /* number of times local LLCP had to send PDU           */
+    UINT32  num_data_ready;     /* data was queued when turn started                    */
+    UINT32  num_data_in_delay;  /* data was queued while delaying SYMM                  */
+    UINT32  num_data_late;      /* data was queued after SYMM had been sent by delay    */
+    UINT32  num_symm_tx;        /* number of SYMM PDUs sent                             */
+    UINT32  num_agf_tx;         /* number of AGF PDUs sent                              */
+    UINT32  num_pdu_in_agf;     /* number of PDUs aggregated in AGF PDUs                */
+    UINT32  num_pdu_fitted;     /* PDUs taken out of scheduling order to fill AGF       */
+    UINT32  tx_info_length;     /* bytes of information field sent in turns with data   */
+    UINT32  tx_miu_length;      /* link MIU times number of turns with data             */
+    UINT8   miu_util_last;      /* link MIU used in last turn with data (%)             */
+    UINT8   miu_util_avg;       /* tx_info_length over tx_miu_length (%)                */
+} tLLCP_LINK_STATS;
+
 /* Service Discovery Callback */
 
 typedef void (tLLCP_SDP_CBACK) (UINT8 tid, UINT8 remote_sap);
@@ -590,6 +620,67 @@ LLCP_API extern tLLCP_STATUS LLCP_SetLocalBusyStatus (UINT8   local_sap,
                                                       UINT8   remote_sap,
                                                       BOOLEAN is_busy);
 
+/*******************************************************************************
+**
+** Function         LLCP_SetTxPriority
+**
+** Description      Set how the PDUs of a registered SAP are scheduled.
+**
+**                  weight: number of PDUs sent in a row when the SAP has its
+**                          turn (0 is taken as 1). Bulk transfers get more
+**                          of the link with a higher weight.
+**                  low_latency: TRUE to send PDUs of the SAP before those of
+**                          other SAPs, up to LLCP_LOW_LATENCY_MAX_BURST PDUs
+**                          in a row while others are waiting.
+**
+** Returns          LLCP_STATUS_SUCCESS if success
+**
+*******************************************************************************/
+LLCP_API extern tLLCP_STATUS LLCP_SetTxPriority (UINT8   local_sap,
+                                                 UINT8   weight,
+                                                 BOOLEAN low_latency);
+
+/*******************************************************************************
+**
+** Function         LLCP_GetTxStats
+**
+** Description      Get the number of PDUs sent from a registered SAP and the
+**                  time they waited in tx queue since it was registered
+**
+** Returns          LLCP_STATUS_SUCCESS if success
+**
+*******************************************************************************/
+LLCP_API extern tLLCP_STATUS LLCP_GetTxStats (UINT8           local_sap,
+                                              tLLCP_TX_STATS *p_stats);
+
+/*******************************************************************************
+**
+** Function         LLCP_GetLinkStats
+**
+** Description      Get turnaround and aggregation statistics of LLCP link
+**                  since it was activated, including current delay of SYMM
+**                  response and link MIU utilization
+**
+** Returns          void
+**
+*******************************************************************************/
+LLCP_API extern void LLCP_GetLinkStats (tLLCP_LINK_STATS *p_stats);
+
+/*******************************************************************************
+**
+** Function         LLCP_GetDataLinkIndex
+**
+** Description      Get index of data link connection between local_sap and
+**                  remote_sap. It doesn't change while the data link
+**                  connection exists, so upper layers can use it to index
+**                  their own control blocks of data link connections.
+**
+** Returns          index between 0 and LLCP_MAX_DATA_LINK - 1 if found
+**                  LLCP_MAX_DATA_LINK, otherwise
+**
+*******************************************************************************/
+LLCP_API extern UINT8 LLCP_GetDataLinkIndex (UINT8 local_sap, UINT8 remote_sap);
+
 /*******************************************************************************
 **
 ** Function         LLCP_GetRemoteWKS
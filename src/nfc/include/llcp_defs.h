@@ -175,6 +175,7 @@
 #define LLCP_SEQ_MODULO             16
 
 #define LLCP_NUM_SAPS               64
+#define LLCP_SAP_MASK               0x3F
 #define LLCP_LOWER_BOUND_WK_SAP     0x00
 #define LLCP_UPPER_BOUND_WK_SAP     0x0F
 #define LLCP_LOWER_BOUND_SDP_SAP    0x10
@@ -209,6 +209,7 @@ typedef struct
     UINT16                  nci_interfaces; /* the NCI interfaces of NFCC       */
     UINT16                  max_ce_table;   /* the max routing table size       */
     UINT16                  max_param_size; /* Max Size for Large Parameters    */
+    UINT8                   max_ctrl_size;  /* Max Control Packet Payload Size  */
     UINT8                   manufacture_id; /* the Manufacture ID for NFCC      */
     UINT8                   nfcc_info[NFC_NFCC_INFO_LEN];/* the Manufacture Info for NFCC      */
     UINT8                   vs_interface[NFC_NFCC_MAX_NUM_VS_INTERFACE];  /* the NCI VS interfaces of NFCC    */
@@ -73,6 +73,7 @@ enum
     RW_T2T_PRESENCE_CHECK_EVT,                  /* Response to RW_T2tPresenceCheck       */
     RW_T2T_FORMAT_CPLT_EVT,                     /* Tag Formated                          */
     RW_T2T_INTF_ERROR_EVT,                      /* RF Interface error event              */
+    RW_T2T_NDEF_READ_SEG_EVT,                   /* Segment of NDEF data (streamed read)  */
     RW_T2T_MAX_EVT,
 
     /* Type 3 tag events for tRW_CBACK */
@@ -525,6 +526,8 @@ NFC_API extern tNFC_STATUS RW_T2tDetectNDef (void);
 ** Function         RW_T2tReadNDef
 **
 ** Description      This function can be called to read the NDEF message on the tag.
+**                  With p_buffer NULL, the message is sent in segments with
+**                  RW_T2T_NDEF_READ_SEG_EVT instead.
 **
 ** Parameters:      p_buffer:   The buffer into which to read the NDEF message
 **                  buf_len:    The length of the buffer
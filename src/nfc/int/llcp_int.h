@@ -71,6 +71,24 @@ typedef struct
     BOOLEAN             ll_served;              /* TRUE if last transmisstion was for UI        */
     UINT8               ll_idx;                 /* for scheduler of logical link connection     */
     UINT8               dl_idx;                 /* for scheduler of data link connection        */
+    UINT8               sched_credit;           /* PDUs left to send for ll_idx or dl_idx, 0 if turn not started */
+    UINT8               low_latency_burst;      /* PDUs sent in a row from low latency services */
+    UINT8               low_latency_ll_idx;     /* next logical link of low latency services    */
+    UINT8               low_latency_dl_idx;     /* next data link connection of low latency services */
+    UINT64              ll_active;              /* bit-map of SAPs with UI PDU in ui_xmit_q     */
+    UINT64              ll_low_latency;         /* bit-map of SAPs of low latency services      */
+    UINT32              dl_ready;               /* bit-map of data link connections with I PDU to send within remote RW */
+    UINT32              dl_low_latency;         /* bit-map of data link connections of low latency services */
+
+    UINT16              symm_delay_cur;         /* adaptive delay of SYMM response in ms        */
+    BOOLEAN             is_symm_delayed;        /* TRUE while delaying SYMM for upper layer     */
+    BOOLEAN             is_symm_timeout;        /* TRUE if SYMM was sent by delay and no data since */
+    UINT32              turn_ticks;             /* tick count when local turn started           */
+    UINT32              xmit_ticks;             /* tick count when PDU was sent to peer         */
+    UINT16              app_lat_avg8;           /* average app latency in ms, scaled by 8       */
+    UINT16              app_lat_dev4;           /* mean deviation of app latency, scaled by 4   */
+    UINT16              peer_rsp_avg8;          /* average response time of peer, scaled by 8   */
+    tLLCP_LINK_STATS    stats;                  /* turnaround statistics                        */
 
     TIMER_LIST_ENT      inact_timer;            /* inactivity timer                             */
     UINT16              inact_timeout;          /* inactivity timeout in ms                     */
@@ -92,6 +110,10 @@ typedef struct
 
 } tLLCP_LCB;
 
+#if (LLCP_MAX_DATA_LINK > 32)
+#error "LLCP_MAX_DATA_LINK must be up to 32 to fit in dl_ready of tLLCP_LCB"
+#endif
+
 /*
 ** LLCP Application's registration control block on service access point (SAP)
 */
@@ -106,6 +128,14 @@ typedef struct
     BUFFER_Q            ui_rx_q;                /* UI PDU queue for receiving                   */
     BOOLEAN             is_ui_tx_congested;     /* TRUE if transmitting UI PDU is congested     */
 
+    UINT32              sn_hash;                /* hash of service name                         */
+    UINT8               sn_len;                 /* length of service name                       */
+    UINT8               sn_next_sap;            /* next SAP in hash bucket of service name, 0 if none */
+
+    UINT8               tx_weight;              /* PDUs sent in a row in its turn, 0 for 1      */
+    BOOLEAN             tx_low_latency;         /* TRUE if served before other services         */
+    tLLCP_TX_STATS      tx_stats;               /* PDUs sent and time they waited in tx queue   */
+
 } tLLCP_APP_CB;
 
 /*
@@ -196,13 +226,30 @@ typedef struct
 {
     UINT8           tid;        /* transaction ID                           */
     tLLCP_SDP_CBACK *p_cback;   /* callback function for service discovery  */
+    UINT32          sn_hash;    /* hash of requested service name           */
+    UINT8           cache_idx;  /* cache entry to keep SAP, LLCP_SDP_CACHE_SIZE if none */
 } tLLCP_SDP_TRANSAC;
 
+typedef struct
+{
+    UINT32          sn_hash;    /* hash of service name                     */
+    UINT8           sn_len;     /* length of service name, 0 if not used    */
+    UINT8           sap;        /* SAP of service in peer, 0 if waiting SDRES */
+    char            sn[LLCP_SDP_CACHE_MAX_SN_LEN];
+} tLLCP_SDP_CACHE;
+
 typedef struct
 {
     UINT8               next_tid;                       /* next TID to use         */
     tLLCP_SDP_TRANSAC   transac[LLCP_MAX_SDP_TRANSAC];  /* active SDP transactions */
     BT_HDR              *p_snl;                         /* buffer for SNL PDU      */
+
+    UINT8               sn_bucket[LLCP_SDP_SN_HASH_SIZE];/* first SAP of local service names by hash, 0 if none */
+
+#if (LLCP_SDP_CACHE_SIZE > 0)
+    tLLCP_SDP_CACHE     cache[LLCP_SDP_CACHE_SIZE];     /* SAPs of peer's services */
+    UINT8               cache_next;                     /* next entry to replace   */
+#endif
 } tLLCP_SDP_CB;
 
 
@@ -220,6 +267,8 @@ typedef struct
     tLLCP_APP_CB    server_cb[LLCP_MAX_SERVER];     /* Application's registration for SDP services  */
     tLLCP_APP_CB    client_cb[LLCP_MAX_CLIENT];     /* Application's registration for client        */
     tLLCP_DLCB      dlcb[LLCP_MAX_DATA_LINK];       /* Data link connection control block           */
+    UINT8           dlcb_by_sap[LLCP_NUM_SAPS][LLCP_NUM_SAPS]; /* 1 + index of dlcb by local and remote SAP, 0 if none */
+    UINT32          dlcb_by_local_sap[LLCP_NUM_SAPS];/* bit-map of index of dlcb by local SAP       */
 
     UINT8           max_num_ll_tx_buff;             /* max number of tx UI PDU in queue             */
     UINT8           max_num_tx_buff;                /* max number of tx UI/I PDU in queue           */
@@ -315,6 +364,7 @@ tLLCP_STATUS llcp_util_send_ui (UINT8 ssap, UINT8 dsap, tLLCP_APP_CB *p_app_cb,
 void         llcp_util_send_disc (UINT8 dsap, UINT8 ssap);
 tLLCP_DLCB  *llcp_util_allocate_data_link (UINT8 reg_sap, UINT8 remote_sap);
 void         llcp_util_deallocate_data_link (tLLCP_DLCB *p_dlcb);
+void         llcp_util_set_remote_sap (tLLCP_DLCB *p_dlcb, UINT8 remote_sap);
 tLLCP_STATUS llcp_util_send_connect (tLLCP_DLCB *p_dlcb, tLLCP_CONNECTION_PARAMS *p_params);
 tLLCP_STATUS llcp_util_parse_connect (UINT8 *p_bytes, UINT16 length, tLLCP_CONNECTION_PARAMS *p_params);
 tLLCP_STATUS llcp_util_send_cc (tLLCP_DLCB *p_dlcb, tLLCP_CONNECTION_PARAMS *p_params);
@@ -324,6 +374,7 @@ void         llcp_util_build_info_pdu (tLLCP_DLCB *p_dlcb, BT_HDR *p_msg);
 tLLCP_STATUS llcp_util_send_frmr (tLLCP_DLCB *p_dlcb, UINT8 flags, UINT8 ptype, UINT8 sequence);
 void         llcp_util_send_rr_rnr (tLLCP_DLCB *p_dlcb);
 tLLCP_APP_CB *llcp_util_get_app_cb (UINT8 sap);
+void         llcp_util_update_tx_stats (tLLCP_APP_CB *p_app_cb, BT_HDR *p_msg);
 /*
 ** Functions provided by llcp_dlc.c
 */
@@ -336,6 +387,7 @@ void         llcp_dlc_check_to_send_rr_rnr (void);
 BOOLEAN      llcp_dlc_is_rw_open (tLLCP_DLCB *p_dlcb);
 BT_HDR      *llcp_dlc_get_next_pdu (tLLCP_DLCB *p_dlcb);
 UINT16       llcp_dlc_get_next_pdu_length (tLLCP_DLCB *p_dlcb);
+void         llcp_dlc_update_ready (tLLCP_DLCB *p_dlcb);
 
 /*
 ** Functions provided by llcp_sdp.c
@@ -343,6 +395,10 @@ UINT16       llcp_dlc_get_next_pdu_length (tLLCP_DLCB *p_dlcb);
 void         llcp_sdp_proc_data (tLLCP_SAP_CBACK_DATA *p_data);
 tLLCP_STATUS llcp_sdp_send_sdreq (UINT8 tid, char *p_name);
 UINT8        llcp_sdp_get_sap_by_name (char *p_name, UINT8 length);
+void         llcp_sdp_add_service_name (UINT8 sap, tLLCP_APP_CB *p_app_cb);
+void         llcp_sdp_remove_service_name (UINT8 sap, tLLCP_APP_CB *p_app_cb);
+UINT8        llcp_sdp_get_cached_sap (char *p_name);
+void         llcp_sdp_reserve_cache (tLLCP_SDP_TRANSAC *p_transac, char *p_name);
 tLLCP_STATUS llcp_sdp_proc_snl (UINT16 sdu_length, UINT8 *p);
 void         llcp_sdp_check_send_snl (void);
 void         llcp_sdp_proc_deactivation (void);
@@ -31,6 +31,7 @@
 #include "nci_defs.h"
 #include "nfc_api.h"
 #include "btu_api.h"
+#include "nfc_latency.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -107,6 +108,10 @@ typedef struct
     tNFC_CONN_CBACK *p_cback;   /* the callback function to receive the data        */
     BUFFER_Q    tx_q;           /* transmit queue                                   */
     BUFFER_Q    rx_q;           /* receive queue                                    */
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == TRUE)
+    BUFFER_Q    rx_frag_q;      /* fragments of the data packet being reassembled   */
+    UINT16      rx_frag_len;    /* payload length of the fragments in rx_frag_q     */
+#endif
     UINT8       id;             /* NFCEE ID or RF Discovery ID or NFC_TEST_ID       */
     UINT8       act_protocol;   /* the active protocol on this logical connection   */
     UINT8       conn_id;        /* the connection id assigned by NFCC for this conn */
@@ -141,6 +146,9 @@ typedef void (tNFC_PWR_ST_CBACK) (void);
 
 /* NCI command buffer contains a VSC (in BT_HDR.layer_specific) */
 #define NFC_WAIT_RSP_VSC            0x01
+/* NCI command buffer contains a coalesced CORE_SET_CONFIG (in BT_HDR.layer_specific,
+** number of NFC_SetConfig () merged in the upper byte) */
+#define NFC_WAIT_RSP_SET_CONFIG     0x02
 
 /* NFC control blocks */
 typedef struct
@@ -184,6 +192,14 @@ typedef struct
     UINT8               nci_wait_rsp;       /* layer_specific for last NCI message */
 
     UINT8               nci_cmd_window;     /* Number of commands the controller can accecpt without waiting for response */
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    BT_HDR              *p_setcfg_pend;     /* CORE_SET_CONFIG collecting TLVs until NFC_TASK is done with its events */
+    UINT8               setcfg_pend_reqs;   /* number of NFC_SetConfig () merged in p_setcfg_pend */
+    UINT8               setcfg_rsp_reqs;    /* number of NFC_SetConfig () merged in the command waiting for response */
+#endif
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    UINT32              nci_cmd_time;       /* nfc_lat_now() when the last NCI command was sent */
+#endif
 
     BT_HDR              *p_nci_init_rsp;    /* holding INIT_RSP until receiving HAL_NFC_POST_INIT_CPLT_EVT */
     tHAL_NFC_ENTRY      *p_hal;
@@ -226,6 +242,7 @@ NFC_API extern void nfc_wait_2_deactivate_timeout (void);
 NFC_API extern BOOLEAN nfc_ncif_process_event (BT_HDR *p_msg);
 NFC_API extern void nfc_ncif_check_cmd_queue (BT_HDR *p_buf);
 NFC_API extern void nfc_ncif_send_cmd (BT_HDR *p_buf);
+NFC_API extern void nfc_ncif_flush_set_config (void);
 NFC_API extern void nfc_ncif_proc_discover_ntf (UINT8 *p, UINT16 plen);
 NFC_API extern void nfc_ncif_rf_management_status (tNFC_DISCOVER_EVT event, UINT8 status);
 NFC_API extern void nfc_ncif_set_config_status (UINT8 *p, UINT8 len);
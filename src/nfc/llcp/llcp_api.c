@@ -473,6 +473,8 @@ UINT8 LLCP_RegisterServer (UINT8           reg_sap,
 
         BCM_STRNCPY_S ((char *) p_app_cb->p_service_name, length + 1, (char *) p_service_name, length + 1);
         p_app_cb->p_service_name[length] = 0;
+
+        llcp_sdp_add_service_name (reg_sap, p_app_cb);
     }
     else
         p_app_cb->p_service_name = NULL;
@@ -589,7 +591,11 @@ tLLCP_STATUS LLCP_Deregister (UINT8 local_sap)
     }
 
     if (p_app_cb->p_service_name)
+    {
+        llcp_sdp_remove_service_name (local_sap, p_app_cb);
         GKI_freebuf (p_app_cb->p_service_name);
+        p_app_cb->p_service_name = NULL;
+    }
 
     /* update WKS bit map */
     if (local_sap <= LLCP_UPPER_BOUND_WK_SAP)
@@ -619,6 +625,8 @@ tLLCP_STATUS LLCP_Deregister (UINT8 local_sap)
         GKI_freebuf (GKI_dequeue (&p_app_cb->ui_xmit_q));
         llcp_cb.total_tx_ui_pdu--;
     }
+    llcp_cb.lcb.ll_active      &= ~((UINT64) 1 << local_sap);
+    llcp_cb.lcb.ll_low_latency &= ~((UINT64) 1 << local_sap);
 
     if (p_app_cb->link_type & LLCP_LINK_TYPE_LOGICAL_DATA_LINK)
     {
@@ -1426,6 +1434,7 @@ tLLCP_STATUS LLCP_SetTxCompleteNtf (UINT8   local_sap,
     {
         /* set flag to notify upper later when tx complete */
         p_dlcb->flags |= LLCP_DATA_LINK_FLAG_NOTIFY_TX_DONE;
+        llcp_dlc_update_ready (p_dlcb);
         status = LLCP_STATUS_SUCCESS;
     }
     else
@@ -1487,6 +1496,142 @@ tLLCP_STATUS LLCP_SetLocalBusyStatus (UINT8   local_sap,
     return status;
 }
 
+/*******************************************************************************
+**
+** Function         LLCP_SetTxPriority
+**
+** Description      Set how the PDUs of a registered SAP are scheduled.
+**
+**                  weight: number of PDUs sent in a row when the SAP has its
+**                          turn (0 is taken as 1). Bulk transfers get more
+**                          of the link with a higher weight.
+**                  low_latency: TRUE to send PDUs of the SAP before those of
+**                          other SAPs, up to LLCP_LOW_LATENCY_MAX_BURST PDUs
+**                          in a row while others are waiting.
+**
+** Returns          LLCP_STATUS_SUCCESS if success
+**
+*******************************************************************************/
+tLLCP_STATUS LLCP_SetTxPriority (UINT8   local_sap,
+                                 UINT8   weight,
+                                 BOOLEAN low_latency)
+{
+    tLLCP_APP_CB *p_app_cb;
+    UINT8         idx;
+
+    LLCP_TRACE_API3 ("LLCP_SetTxPriority () Local SAP:0x%x, weight=%d, low_latency=%d",
+                      local_sap, weight, low_latency);
+
+    p_app_cb = llcp_util_get_app_cb (local_sap);
+
+    if ((p_app_cb == NULL) || (p_app_cb->p_app_cback == NULL))
+    {
+        LLCP_TRACE_ERROR1 ("LLCP_SetTxPriority (): SAP (0x%x) is not registered", local_sap);
+        return LLCP_STATUS_FAIL;
+    }
+
+    p_app_cb->tx_weight      = weight;
+    p_app_cb->tx_low_latency = low_latency;
+
+    if (low_latency)
+        llcp_cb.lcb.ll_low_latency |= ((UINT64) 1 << local_sap);
+    else
+        llcp_cb.lcb.ll_low_latency &= ~((UINT64) 1 << local_sap);
+
+    /* data link connections of the SAP move to the same class */
+    for (idx = 0; idx < LLCP_MAX_DATA_LINK; idx++)
+    {
+        if (  (llcp_cb.dlcb[idx].state != LLCP_DLC_STATE_IDLE)
+            &&(llcp_cb.dlcb[idx].local_sap == local_sap)  )
+        {
+            if (low_latency)
+                llcp_cb.lcb.dl_low_latency |= ((UINT32) 1 << idx);
+            else
+                llcp_cb.lcb.dl_low_latency &= ~((UINT32) 1 << idx);
+        }
+    }
+
+    return LLCP_STATUS_SUCCESS;
+}
+
+/*******************************************************************************
+**
+** Function         LLCP_GetTxStats
+**
+** Description      Get the number of PDUs sent from a registered SAP and the
+**                  time they waited in tx queue since it was registered
+**
+** Returns          LLCP_STATUS_SUCCESS if success
+**
+*******************************************************************************/
+tLLCP_STATUS LLCP_GetTxStats (UINT8           local_sap,
+                              tLLCP_TX_STATS *p_stats)
+{
+    tLLCP_APP_CB *p_app_cb;
+
+    LLCP_TRACE_API1 ("LLCP_GetTxStats () Local SAP:0x%x", local_sap);
+
+    p_app_cb = llcp_util_get_app_cb (local_sap);
+
+    if ((p_app_cb == NULL) || (p_app_cb->p_app_cback == NULL))
+    {
+        LLCP_TRACE_ERROR1 ("LLCP_GetTxStats (): SAP (0x%x) is not registered", local_sap);
+        return LLCP_STATUS_FAIL;
+    }
+
+    memcpy (p_stats, &p_app_cb->tx_stats, sizeof (tLLCP_TX_STATS));
+
+    return LLCP_STATUS_SUCCESS;
+}
+
+/*******************************************************************************
+**
+** Function         LLCP_GetLinkStats
+**
+** Description      Get turnaround and aggregation statistics of LLCP link
+**                  since it was activated, including current delay of SYMM
+**                  response and link MIU utilization
+**
+** Returns          void
+**
+*******************************************************************************/
+void LLCP_GetLinkStats (tLLCP_LINK_STATS *p_stats)
+{
+    LLCP_TRACE_API0 ("LLCP_GetLinkStats ()");
+
+    memcpy (p_stats, &llcp_cb.lcb.stats, sizeof (tLLCP_LINK_STATS));
+    p_stats->symm_delay = llcp_cb.lcb.symm_delay_cur;
+
+    if (p_stats->tx_miu_length)
+        p_stats->miu_util_avg = (UINT8) (((UINT64) p_stats->tx_info_length * 100) / p_stats->tx_miu_length);
+}
+
+/*******************************************************************************
+**
+** Function         LLCP_GetDataLinkIndex
+**
+** Description      Get index of data link connection between local_sap and
+**                  remote_sap. It doesn't change while the data link
+**                  connection exists, so upper layers can use it to index
+**                  their own control blocks of data link connections.
+**
+** Returns          index between 0 and LLCP_MAX_DATA_LINK - 1 if found
+**                  LLCP_MAX_DATA_LINK, otherwise
+**
+*******************************************************************************/
+UINT8 LLCP_GetDataLinkIndex (UINT8 local_sap, UINT8 remote_sap)
+{
+    tLLCP_DLCB *p_dlcb;
+
+    if (  (remote_sap != LLCP_INVALID_SAP)
+        &&((p_dlcb = llcp_dlc_find_dlcb_by_sap (local_sap, remote_sap)) != NULL)  )
+    {
+        return ((UINT8) (p_dlcb - llcp_cb.dlcb));
+    }
+
+    return (LLCP_MAX_DATA_LINK);
+}
+
 /*******************************************************************************
 **
 ** Function         LLCP_GetRemoteWKS
@@ -1566,6 +1711,9 @@ LLCP_API void LLCP_GetLinkMIU (UINT16 *p_local_link_miu,
 **
 ** Description      Return SAP of service name in connected device through callback
 **
+**                  If the service has been discovered while the link is
+**                  activated, the callback is called with the cached SAP before
+**                  this function returns and no SDREQ is sent.
 **
 ** Returns          LLCP_STATUS_SUCCESS if success
 **
@@ -1575,7 +1723,7 @@ tLLCP_STATUS LLCP_DiscoverService (char            *p_name,
                                    UINT8           *p_tid)
 {
     tLLCP_STATUS  status;
-    UINT8         i;
+    UINT8         i, sap;
 
     LLCP_TRACE_API1 ("LLCP_DiscoverService () Service Name:%s",
                       p_name);
@@ -1599,6 +1747,16 @@ tLLCP_STATUS LLCP_DiscoverService (char            *p_name,
         return LLCP_STATUS_FAIL;
     }
 
+    /* if SAP was found by previous SDREQ in this link */
+    if ((sap = llcp_sdp_get_cached_sap (p_name)) != 0)
+    {
+        *p_tid = llcp_cb.sdp_cb.next_tid;
+        llcp_cb.sdp_cb.next_tid++;
+
+        (*p_cback) (*p_tid, sap);
+        return LLCP_STATUS_SUCCESS;
+    }
+
     for (i = 0; i < LLCP_MAX_SDP_TRANSAC; i++)
     {
         if (!llcp_cb.sdp_cb.transac[i].p_cback)
@@ -1613,6 +1771,10 @@ tLLCP_STATUS LLCP_DiscoverService (char            *p_name,
             {
                 llcp_cb.sdp_cb.transac[i].p_cback = NULL;
             }
+            else
+            {
+                llcp_sdp_reserve_cache (&llcp_cb.sdp_cb.transac[i], p_name);
+            }
 
             *p_tid = llcp_cb.sdp_cb.transac[i].tid;
             return (status);
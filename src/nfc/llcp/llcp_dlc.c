@@ -397,6 +397,7 @@ static tLLCP_STATUS llcp_dlsm_connected (tLLCP_DLCB *p_dlcb, tLLCP_DLC_EVENT eve
         {
             /* set flag to send DISC when tx queue is empty */
             p_dlcb->flags |= LLCP_DATA_LINK_FLAG_PENDING_DISC;
+            llcp_dlc_update_ready (p_dlcb);
         }
         break;
 
@@ -423,9 +424,11 @@ static tLLCP_STATUS llcp_dlsm_connected (tLLCP_DLCB *p_dlcb, tLLCP_DLC_EVENT eve
         /* if peer device can receive data */
         if (p_dlcb->remote_rw)
         {
-            /* enqueue data and check if data can be sent */
+            /* enqueue data with time stamp for queueing delay and check if data can be sent */
+            ((BT_HDR *) p_data)->layer_specific = (UINT16) GKI_get_tick_count ();
             GKI_enqueue (&p_dlcb->i_xmit_q, p_data);
             llcp_cb.total_tx_i_pdu++;
+            llcp_dlc_update_ready (p_dlcb);
 
             llcp_link_check_send_data ();
 
@@ -556,24 +559,33 @@ static tLLCP_STATUS llcp_dlsm_w4_remote_dm (tLLCP_DLCB *p_dlcb, tLLCP_DLC_EVENT
 *******************************************************************************/
 tLLCP_DLCB *llcp_dlc_find_dlcb_by_sap (UINT8 local_sap, UINT8 remote_sap)
 {
-    int i;
+    tLLCP_DLCB *p_dlcb;
+    UINT32      dl_set;
+    UINT8       idx;
+
+    if (local_sap >= LLCP_NUM_SAPS)
+        return NULL;
 
-    for (i = 0; i < LLCP_MAX_DATA_LINK; i++)
+    if (remote_sap == LLCP_INVALID_SAP)
     {
-        if (  (llcp_cb.dlcb[i].state != LLCP_DLC_STATE_IDLE)
-            &&(llcp_cb.dlcb[i].local_sap == local_sap)  )
+        /* Remote SAP has not been finalized because we are watiing for CC */
+        for (dl_set = llcp_cb.dlcb_by_local_sap[local_sap]; dl_set; dl_set &= dl_set - 1)
         {
-            if ((remote_sap == LLCP_INVALID_SAP) && (llcp_cb.dlcb[i].state == LLCP_DLC_STATE_W4_REMOTE_RESP))
-            {
-                /* Remote SAP has not been finalized because we are watiing for CC */
-                return (&llcp_cb.dlcb[i]);
-            }
-            else if (llcp_cb.dlcb[i].remote_sap == remote_sap)
-            {
-                return (&llcp_cb.dlcb[i]);
-            }
+            p_dlcb = &llcp_cb.dlcb[__builtin_ctz (dl_set)];
+
+            if (p_dlcb->state == LLCP_DLC_STATE_W4_REMOTE_RESP)
+                return (p_dlcb);
         }
     }
+    else if (  (remote_sap < LLCP_NUM_SAPS)
+             &&((idx = llcp_cb.dlcb_by_sap[local_sap][remote_sap]) != 0)  )
+    {
+        p_dlcb = &llcp_cb.dlcb[idx - 1];
+
+        if (p_dlcb->state != LLCP_DLC_STATE_IDLE)
+            return (p_dlcb);
+    }
+
     return NULL;
 }
 
@@ -598,6 +610,7 @@ void llcp_dlc_flush_q (tLLCP_DLCB *p_dlcb)
             GKI_freebuf (GKI_dequeue (&p_dlcb->i_xmit_q));
             llcp_cb.total_tx_i_pdu--;
         }
+        llcp_dlc_update_ready (p_dlcb);
 
         /* discard any received I PDU on data link  including in AGF */
         LLCP_FlushDataLinkRxData (p_dlcb->local_sap, p_dlcb->remote_sap);
@@ -760,7 +773,7 @@ static void llcp_dlc_proc_cc_pdu (UINT8 dsap, UINT8 ssap, UINT16 length, UINT8 *
     if (p_dlcb)
     {
         /* The CC may contain a SSAP that is different from the DSAP in the CONNECT */
-        p_dlcb->remote_sap = ssap;
+        llcp_util_set_remote_sap (p_dlcb, ssap);
 
         if (llcp_util_parse_cc (p_data, length, &(params.miu), &(params.rw)) == LLCP_STATUS_SUCCESS)
         {
@@ -922,6 +935,9 @@ void llcp_dlc_proc_i_pdu (UINT8 dsap, UINT8 ssap, UINT16 i_pdu_length, UINT8 *p_
             p_dlcb->next_rx_seq  = (p_dlcb->next_rx_seq + 1) % LLCP_SEQ_MODULO;
             p_dlcb->rcvd_ack_seq = rcv_seq;
 
+            /* remote RW may have opened */
+            llcp_dlc_update_ready (p_dlcb);
+
             appended = FALSE;
 
             /* get last buffer in rx queue */
@@ -1135,6 +1151,9 @@ static void llcp_dlc_proc_rr_rnr_pdu (UINT8 dsap, UINT8 ptype, UINT8 ssap, UINT1
                 p_dlcb->remote_busy = FALSE;
             }
 
+            /* remote RW or busy state may have changed */
+            llcp_dlc_update_ready (p_dlcb);
+
             /* check flag to send DISC when tx queue is empty */
             if (p_dlcb->flags & LLCP_DATA_LINK_FLAG_PENDING_DISC)
             {
@@ -1316,6 +1335,7 @@ BT_HDR* llcp_dlc_get_next_pdu (tLLCP_DLCB *p_dlcb)
     {
         p_msg = (BT_HDR *) GKI_dequeue (&p_dlcb->i_xmit_q);
         llcp_cb.total_tx_i_pdu--;
+        llcp_util_update_tx_stats (p_dlcb->p_app_cb, p_msg);
 
         if (p_msg->offset >= LLCP_MIN_OFFSET)
         {
@@ -1365,6 +1385,8 @@ BT_HDR* llcp_dlc_get_next_pdu (tLLCP_DLCB *p_dlcb)
         }
     }
 
+    llcp_dlc_update_ready (p_dlcb);
+
     return p_msg;
 }
 
@@ -1393,6 +1415,38 @@ UINT16 llcp_dlc_get_next_pdu_length (tLLCP_DLCB *p_dlcb)
     return 0;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_dlc_update_ready
+**
+** Description      Keep the data link connection in dl_ready of tx scheduler
+**                  while it has an I PDU to send within remote RW, or while
+**                  llcp_dlc_get_next_pdu () has to send DISC or notify tx
+**                  complete once all PDUs are acknowledged.
+**
+**                  Must be called whenever i_xmit_q, remote RW, remote busy
+**                  or these flags change.
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_dlc_update_ready (tLLCP_DLCB *p_dlcb)
+{
+    UINT32 mask = (UINT32) 1 << (p_dlcb - llcp_cb.dlcb);
+
+    if (  (  (p_dlcb->i_xmit_q.count)
+           &&(!p_dlcb->remote_busy)
+           &&((UINT8) (p_dlcb->next_tx_seq - p_dlcb->rcvd_ack_seq) % LLCP_SEQ_MODULO < p_dlcb->remote_rw)  )
+        ||(p_dlcb->flags & (LLCP_DATA_LINK_FLAG_PENDING_DISC | LLCP_DATA_LINK_FLAG_NOTIFY_TX_DONE))  )
+    {
+        llcp_cb.lcb.dl_ready |= mask;
+    }
+    else
+    {
+        llcp_cb.lcb.dl_ready &= ~mask;
+    }
+}
+
 #if (BT_TRACE_VERBOSE == TRUE)
 /*******************************************************************************
 **
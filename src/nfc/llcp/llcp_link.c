@@ -63,8 +63,12 @@ static void    llcp_link_proc_rx_pdu (UINT8 dsap, UINT8 ptype, UINT8 ssap, BT_HD
 static void    llcp_link_proc_rx_data (BT_HDR *p_msg);
 
 static BT_HDR *llcp_link_get_next_pdu (BOOLEAN length_only, UINT16 *p_next_pdu_length);
+static BT_HDR *llcp_link_get_fitting_pdu (BOOLEAN length_only, UINT16 max_length, UINT16 *p_pdu_length);
 static BT_HDR *llcp_link_build_next_pdu (BT_HDR *p_agf);
+static void    llcp_link_update_tx_util (BT_HDR *p_pdu);
 static void    llcp_link_send_to_lower (BT_HDR *p_msg);
+static void    llcp_link_start_local_turn (void);
+static void    llcp_link_add_app_latency (UINT32 latency);
 
 #if (LLCP_TEST_INCLUDED == TRUE) /* this is for LLCP testing */
 extern tLLCP_TEST_PARAMS llcp_test_params;
@@ -130,7 +134,7 @@ static void llcp_link_start_link_timer (void)
     {
         /* wait for application layer sending data */
         nfc_start_quick_timer (&llcp_cb.lcb.timer, NFC_TTYPE_LLCP_LINK_MANAGER,
-                               (((UINT32) llcp_cb.lcb.symm_delay) * QUICK_TIMER_TICKS_PER_SEC) / 1000);
+                               (((UINT32) llcp_cb.lcb.symm_delay_cur) * QUICK_TIMER_TICKS_PER_SEC) / 1000);
     }
     else
     {
@@ -154,6 +158,172 @@ static void llcp_link_stop_link_timer (void)
     nfc_stop_quick_timer (&llcp_cb.lcb.timer);
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_ms_since
+**
+** Description      Get time elapsed since tick count
+**
+** Returns          time in ms, up to 0xFFFF
+**
+*******************************************************************************/
+static UINT16 llcp_link_ms_since (UINT32 ticks)
+{
+    UINT32 elapsed_ms = GKI_TICKS_TO_MS (GKI_get_tick_count () - ticks);
+
+    return ((elapsed_ms < 0xFFFF) ? (UINT16) elapsed_ms : 0xFFFF);
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_adapt_symm_delay
+**
+** Description      Set delay of SYMM response to average time upper layer
+**                  takes to send data in its turn plus twice of its mean
+**                  deviation.
+**
+**                  Local turn must be within LTO of peer. Response time of
+**                  peer includes transmission of both ways, so the delay is
+**                  kept to half of LTO left after it.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_adapt_symm_delay (void)
+{
+#if (LLCP_ADAPTIVE_SYMM_DELAY == TRUE)
+    UINT32 delay, lto, rsp;
+
+    /* SYMM is sent without delay if it's not configured */
+    if (llcp_cb.lcb.symm_delay == 0)
+        return;
+
+    if (llcp_cb.lcb.app_lat_avg8 == 0)
+    {
+        /* no data from upper layer yet */
+        delay = llcp_cb.lcb.symm_delay;
+    }
+    else
+    {
+        /* add a timer tick as delay is rounded down to timer resolution */
+        delay = (llcp_cb.lcb.app_lat_avg8 >> 3) + (llcp_cb.lcb.app_lat_dev4 >> 1)
+               + 1000 / QUICK_TIMER_TICKS_PER_SEC;
+    }
+
+    if (delay < LLCP_SYMM_DELAY_MIN)
+        delay = LLCP_SYMM_DELAY_MIN;
+    if (delay > LLCP_SYMM_DELAY_MAX)
+        delay = LLCP_SYMM_DELAY_MAX;
+
+    /* peer_lto has been extended by internal delays at activation */
+    lto = llcp_cb.lcb.peer_lto - (LLCP_INTERNAL_TX_DELAY + LLCP_INTERNAL_RX_DELAY);
+    rsp = llcp_cb.lcb.peer_rsp_avg8 >> 3;
+    lto = (lto > rsp) ? (lto - rsp) / 2 : 0;
+
+    if (delay > lto)
+        delay = lto;
+
+    if (delay != llcp_cb.lcb.symm_delay_cur)
+    {
+        LLCP_TRACE_DEBUG2 ("llcp_link_adapt_symm_delay (): SYMM delay %d -> %d ms",
+                           llcp_cb.lcb.symm_delay_cur, delay);
+        llcp_cb.lcb.symm_delay_cur = (UINT16) delay;
+    }
+#endif
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_add_app_latency
+**
+** Description      Add time upper layer took to send data since local turn
+**                  started and adapt delay of SYMM response
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_add_app_latency (UINT32 latency)
+{
+    tLLCP_LCB *p_lcb = &llcp_cb.lcb;
+    INT32      err;
+
+    /* keep scaled average and deviation in UINT16 */
+    if (latency > 0x0FFF)
+        latency = 0x0FFF;
+
+    if (latency > p_lcb->stats.app_latency_max)
+        p_lcb->stats.app_latency_max = (UINT16) latency;
+
+    if (p_lcb->app_lat_avg8 == 0)
+    {
+        p_lcb->app_lat_avg8 = (UINT16) ((latency << 3) | 1);
+        p_lcb->app_lat_dev4 = (UINT16) (latency << 1);
+    }
+    else
+    {
+        err = (INT32) latency - (p_lcb->app_lat_avg8 >> 3);
+        p_lcb->app_lat_avg8 = (UINT16) (p_lcb->app_lat_avg8 + err);
+        if (p_lcb->app_lat_avg8 == 0)
+            p_lcb->app_lat_avg8 = 1;
+
+        if (err < 0)
+            err = -err;
+        err -= (p_lcb->app_lat_dev4 >> 2);
+        p_lcb->app_lat_dev4 = (UINT16) (p_lcb->app_lat_dev4 + err);
+    }
+
+    p_lcb->stats.app_latency = p_lcb->app_lat_avg8 >> 3;
+
+    llcp_link_adapt_symm_delay ();
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_start_local_turn
+**
+** Description      Account for a PDU received from peer, which gives a turn
+**                  to local LLCP
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_start_local_turn (void)
+{
+    tLLCP_LCB *p_lcb = &llcp_cb.lcb;
+    UINT16     rsp;
+
+    if (p_lcb->xmit_ticks)
+    {
+        rsp = llcp_link_ms_since (p_lcb->xmit_ticks);
+        if (rsp > 0x0FFF)
+            rsp = 0x0FFF;
+
+        if (rsp > p_lcb->stats.peer_rsp_time_max)
+            p_lcb->stats.peer_rsp_time_max = rsp;
+
+        if (p_lcb->peer_rsp_avg8 == 0)
+            p_lcb->peer_rsp_avg8 = (rsp << 3) | 1;
+        else
+            p_lcb->peer_rsp_avg8 = (UINT16) (p_lcb->peer_rsp_avg8 + rsp - (p_lcb->peer_rsp_avg8 >> 3));
+
+        p_lcb->stats.peer_rsp_time = p_lcb->peer_rsp_avg8 >> 3;
+    }
+
+    if (p_lcb->is_symm_timeout)
+    {
+        /* upper layer had nothing to send for a round trip, so shorten delay */
+        p_lcb->is_symm_timeout = FALSE;
+        p_lcb->app_lat_avg8 -= p_lcb->app_lat_avg8 >> 2;
+        p_lcb->app_lat_dev4 -= p_lcb->app_lat_dev4 >> 2;
+        p_lcb->stats.app_latency = p_lcb->app_lat_avg8 >> 3;
+    }
+
+    llcp_link_adapt_symm_delay ();
+
+    p_lcb->turn_ticks = GKI_get_tick_count ();
+    p_lcb->stats.num_local_turn++;
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_activate
@@ -200,6 +370,18 @@ tLLCP_STATUS llcp_link_activate (tLLCP_ACTIVATE_CONFIG *p_config)
     /* extend LTO as much as internally required processing time and propagation delays */
     llcp_cb.lcb.peer_lto += LLCP_INTERNAL_TX_DELAY + LLCP_INTERNAL_RX_DELAY;
 
+    /* start turnaround measurement with configured SYMM delay */
+    memset (&llcp_cb.lcb.stats, 0x00, sizeof (tLLCP_LINK_STATS));
+    llcp_cb.lcb.symm_delay_cur  = llcp_cb.lcb.symm_delay;
+    llcp_cb.lcb.is_symm_delayed = FALSE;
+    llcp_cb.lcb.is_symm_timeout = FALSE;
+    llcp_cb.lcb.turn_ticks      = GKI_get_tick_count ();
+    llcp_cb.lcb.xmit_ticks      = 0;
+    llcp_cb.lcb.app_lat_avg8    = 0;
+    llcp_cb.lcb.app_lat_dev4    = 0;
+    llcp_cb.lcb.peer_rsp_avg8   = 0;
+    llcp_link_adapt_symm_delay ();
+
     /* LLCP version number agreement */
     if (llcp_link_version_agreement () == FALSE)
     {
@@ -313,6 +495,11 @@ void llcp_link_process_link_timeout (void)
         {
             /* upper layer doesn't have anything to send */
             LLCP_TRACE_DEBUG0 ("llcp_link_process_link_timeout (): LEVT_TIMEOUT in state of LLCP_LINK_SYMM_LOCAL_XMIT_NEXT");
+
+            /* measure how late upper layer is if it sends data before next turn */
+            llcp_cb.lcb.is_symm_delayed = FALSE;
+            llcp_cb.lcb.is_symm_timeout = TRUE;
+
             llcp_link_send_SYMM ();
 
             /* wait for data to receive from remote */
@@ -378,6 +565,7 @@ void llcp_link_deactivate (UINT8 reason)
     }
 
     llcp_cb.total_tx_ui_pdu = 0;
+    llcp_cb.lcb.ll_active   = 0;
     llcp_cb.total_rx_ui_pdu = 0;
 
     /* Notify all of data link */
@@ -805,6 +993,8 @@ static void llcp_link_send_SYMM (void)
         p = (UINT8 *) (p_msg + 1) + p_msg->offset;
         UINT16_TO_BE_STREAM (p, LLCP_GET_PDU_HEADER (LLCP_SAP_LM, LLCP_PDU_SYMM_TYPE, LLCP_SAP_LM ));
 
+        llcp_cb.lcb.stats.num_symm_tx++;
+
         llcp_link_send_to_lower (p_msg);
     }
 }
@@ -821,6 +1011,7 @@ static void llcp_link_send_SYMM (void)
 void llcp_link_check_send_data (void)
 {
     BT_HDR *p_pdu;
+    UINT16  next_pdu_length;
 
     /* don't re-enter while processing to prevent out of sequence */
     if (llcp_cb.lcb.is_sending_data)
@@ -856,6 +1047,20 @@ void llcp_link_check_send_data (void)
 
         if (p_pdu != NULL)
         {
+            if (llcp_cb.lcb.is_symm_delayed)
+            {
+                /* upper layer sent data while delaying SYMM */
+                llcp_cb.lcb.is_symm_delayed = FALSE;
+                llcp_cb.lcb.stats.num_data_in_delay++;
+                llcp_link_add_app_latency (llcp_link_ms_since (llcp_cb.lcb.turn_ticks));
+            }
+            else
+            {
+                llcp_cb.lcb.stats.num_data_ready++;
+            }
+
+            llcp_link_update_tx_util (p_pdu);
+
             llcp_link_send_to_lower (p_pdu);
 
             /* stop inactivity timer */
@@ -869,10 +1074,14 @@ void llcp_link_check_send_data (void)
             /* There is no data to send, so send SYMM */
             if (llcp_cb.lcb.link_state == LLCP_LINK_STATE_ACTIVATED)
             {
-                if (llcp_cb.lcb.symm_delay > 0)
+                if (llcp_cb.lcb.symm_delay_cur > 0)
                 {
-                    /* wait for application layer sending data */
-                    llcp_link_start_link_timer ();
+                    /* wait for application layer sending data, up to SYMM delay since turn started */
+                    if (!llcp_cb.lcb.is_symm_delayed)
+                    {
+                        llcp_cb.lcb.is_symm_delayed = TRUE;
+                        llcp_link_start_link_timer ();
+                    }
                     llcp_cb.lcb.is_sending_data = FALSE;
                     return;
                 }
@@ -906,6 +1115,18 @@ void llcp_link_check_send_data (void)
             llcp_link_start_link_timer ();
         }
     }
+    else if (llcp_cb.lcb.is_symm_timeout)
+    {
+        /* SYMM has been sent by delay, check if upper layer sent data later */
+        llcp_link_get_next_pdu (TRUE, &next_pdu_length);
+
+        if (next_pdu_length > 0)
+        {
+            llcp_cb.lcb.is_symm_timeout = FALSE;
+            llcp_cb.lcb.stats.num_data_late++;
+            llcp_link_add_app_latency (llcp_link_ms_since (llcp_cb.lcb.turn_ticks));
+        }
+    }
 
     llcp_cb.lcb.is_sending_data = FALSE;
 }
@@ -1347,6 +1568,8 @@ static void llcp_link_proc_rx_data (BT_HDR *p_msg)
 
             llcp_cb.lcb.symm_state = LLCP_LINK_SYMM_LOCAL_XMIT_NEXT;
 
+            llcp_link_start_local_turn ();
+
             /* check if any pending packet */
             llcp_link_check_send_data ();
         }
@@ -1360,12 +1583,245 @@ static void llcp_link_proc_rx_data (BT_HDR *p_msg)
         GKI_freebuf (p_msg);
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_next_in_set
+**
+** Description      Find the first member of a bit-map at or after start,
+**                  wrapping around
+**
+** Returns          index of the member, or size if bit-map is empty
+**
+*******************************************************************************/
+static UINT8 llcp_link_next_in_set (UINT64 set, UINT8 start, UINT8 size)
+{
+    UINT64 from_start;
+
+    if (set == 0)
+        return size;
+
+    from_start = set & ~(((UINT64) 1 << start) - 1);
+    if (from_start)
+        return ((UINT8) __builtin_ctzll (from_start));
+    else
+        return ((UINT8) __builtin_ctzll (set));
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_sched_start
+**
+** Description      Give a logical link or data link connection its share of
+**                  PDUs if its turn is starting
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_sched_start (UINT8 *p_cur_idx, UINT8 idx, tLLCP_APP_CB *p_app_cb)
+{
+    if ((*p_cur_idx != idx) || (llcp_cb.lcb.sched_credit == 0))
+    {
+        *p_cur_idx = idx;
+        llcp_cb.lcb.sched_credit = ((p_app_cb) && (p_app_cb->tx_weight)) ? p_app_cb->tx_weight : 1;
+    }
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_dequeue_ui_pdu
+**
+** Description      Dequeue UI PDU of a logical link
+**
+** Returns          pointer of the PDU
+**
+*******************************************************************************/
+static BT_HDR *llcp_link_dequeue_ui_pdu (UINT8 idx, tLLCP_APP_CB *p_app_cb)
+{
+    BT_HDR *p_msg;
+
+    p_msg = (BT_HDR *) GKI_dequeue (&p_app_cb->ui_xmit_q);
+    llcp_cb.total_tx_ui_pdu--;
+    llcp_util_update_tx_stats (p_app_cb, p_msg);
+
+    if (p_app_cb->ui_xmit_q.count == 0)
+        llcp_cb.lcb.ll_active &= ~((UINT64) 1 << idx);
+
+    return p_msg;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_get_low_latency_pdu
+**
+** Description      Get next PDU from logical links or data link connections
+**                  of low latency services w/wo dequeue. Each set is served
+**                  round robin from the one after the last served.
+**
+** Returns          pointer of a PDU to send if length_only is FALSE
+**                  NULL otherwise
+**
+*******************************************************************************/
+static BT_HDR *llcp_link_get_low_latency_pdu (BOOLEAN length_only, UINT16 *p_next_pdu_length)
+{
+    BT_HDR       *p_msg;
+    tLLCP_APP_CB *p_app_cb;
+    UINT64        ll_set = llcp_cb.lcb.ll_active & llcp_cb.lcb.ll_low_latency;
+    UINT32        dl_set = llcp_cb.lcb.dl_ready & llcp_cb.lcb.dl_low_latency;
+    UINT8         idx;
+
+    *p_next_pdu_length = 0;
+
+    if (ll_set)
+    {
+        idx      = llcp_link_next_in_set (ll_set, llcp_cb.lcb.low_latency_ll_idx, LLCP_NUM_SAPS);
+        p_app_cb = llcp_util_get_app_cb (idx);
+
+        if (length_only)
+        {
+            p_msg = (BT_HDR *) p_app_cb->ui_xmit_q.p_first;
+            *p_next_pdu_length = p_msg->len;
+            return NULL;
+        }
+
+        llcp_cb.lcb.low_latency_ll_idx = (idx + 1) % LLCP_NUM_SAPS;
+        return (llcp_link_dequeue_ui_pdu (idx, p_app_cb));
+    }
+
+    while (dl_set)
+    {
+        idx     = llcp_link_next_in_set (dl_set, llcp_cb.lcb.low_latency_dl_idx, LLCP_MAX_DATA_LINK);
+        dl_set &= ~((UINT32) 1 << idx);
+
+        if (length_only)
+        {
+            if ((*p_next_pdu_length = llcp_dlc_get_next_pdu_length (&llcp_cb.dlcb[idx])) > 0)
+                return NULL;
+        }
+        else if ((p_msg = llcp_dlc_get_next_pdu (&llcp_cb.dlcb[idx])) != NULL)
+        {
+            llcp_cb.lcb.low_latency_dl_idx = (idx + 1) % LLCP_MAX_DATA_LINK;
+            return p_msg;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_link_get_weighted_pdu
+**
+** Description      Get next PDU from logical links in ll_set or data link
+**                  connections in dl_set w/wo dequeue.
+**
+**                  Logical links and data link connections take turns. In its
+**                  turn, each one sends up to the weight of its service.
+**
+** Returns          pointer of a PDU to send if length_only is FALSE
+**                  NULL otherwise
+**
+*******************************************************************************/
+static BT_HDR *llcp_link_get_weighted_pdu (UINT64 ll_set, UINT32 dl_set,
+                                           BOOLEAN length_only, UINT16 *p_next_pdu_length)
+{
+    tLLCP_LCB    *p_lcb = &llcp_cb.lcb;
+    tLLCP_APP_CB *p_app_cb;
+    tLLCP_DLCB   *p_dlcb;
+    BT_HDR       *p_msg;
+    UINT8         idx, xx;
+
+    *p_next_pdu_length = 0;
+
+    for (xx = 0; xx < 2; xx++)
+    {
+        if (!p_lcb->ll_served)
+        {
+            /* Get one from logical link connection with UI PDU queued */
+            idx = llcp_link_next_in_set (ll_set, p_lcb->ll_idx, LLCP_NUM_SAPS);
+
+            if (idx < LLCP_NUM_SAPS)
+            {
+                p_app_cb = llcp_util_get_app_cb (idx);
+                llcp_link_sched_start (&p_lcb->ll_idx, idx, p_app_cb);
+
+                if (length_only)
+                {
+                    /* don't alternate next data link to return the same length of PDU */
+                    p_msg = (BT_HDR *) p_app_cb->ui_xmit_q.p_first;
+                    *p_next_pdu_length = p_msg->len;
+                    return NULL;
+                }
+
+                p_msg = llcp_link_dequeue_ui_pdu (idx, p_app_cb);
+
+                /* if its share is sent, start from next logical link and check data link connection next time */
+                if ((--p_lcb->sched_credit == 0) || (p_app_cb->ui_xmit_q.count == 0))
+                {
+                    p_lcb->ll_idx       = (idx + 1) % LLCP_NUM_SAPS;
+                    p_lcb->sched_credit = 0;
+                    p_lcb->ll_served    = TRUE;
+                }
+                return p_msg;
+            }
+
+            /* no data, so check data link connection if not checked yet */
+            p_lcb->ll_served    = TRUE;
+            p_lcb->sched_credit = 0;
+        }
+        else
+        {
+            /* Get one from data link connection, visiting each one once */
+            while ((idx = llcp_link_next_in_set (dl_set, p_lcb->dl_idx, LLCP_MAX_DATA_LINK)) < LLCP_MAX_DATA_LINK)
+            {
+                p_dlcb  = &llcp_cb.dlcb[idx];
+                dl_set &= ~((UINT32) 1 << idx);
+                llcp_link_sched_start (&p_lcb->dl_idx, idx, p_dlcb->p_app_cb);
+
+                if (length_only)
+                {
+                    /* don't change data link connection to return the same length of PDU */
+                    if ((*p_next_pdu_length = llcp_dlc_get_next_pdu_length (p_dlcb)) > 0)
+                        return NULL;
+                }
+                else if ((p_msg = llcp_dlc_get_next_pdu (p_dlcb)) != NULL)
+                {
+                    /* if its share is sent, start from next data link and serve logical data link next time */
+                    if (  (--p_lcb->sched_credit == 0)
+                        ||(llcp_dlc_get_next_pdu_length (p_dlcb) == 0)  )
+                    {
+                        p_lcb->dl_idx       = (idx + 1) % LLCP_MAX_DATA_LINK;
+                        p_lcb->sched_credit = 0;
+                        p_lcb->ll_served    = FALSE;
+                    }
+                    return p_msg;
+                }
+
+                /* no data, so check next data link connection */
+                p_lcb->dl_idx       = (idx + 1) % LLCP_MAX_DATA_LINK;
+                p_lcb->sched_credit = 0;
+            }
+
+            /* if all of data link connection doesn't have data to send */
+            p_lcb->ll_served    = FALSE;
+            p_lcb->sched_credit = 0;
+        }
+    }
+
+    return NULL;
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_get_next_pdu
 **
 ** Description      Get next PDU from link manager or data links w/wo dequeue
 **
+**                  Signalling PDUs go first, then PDUs of low latency services
+**                  (up to LLCP_LOW_LATENCY_MAX_BURST in a row if others are
+**                  waiting), then the other services by weighted round robin.
+**                  Only SAPs with UI PDU queued and data link connections
+**                  with I PDU to send within remote RW are visited.
+**
 ** Returns          pointer of a PDU to send if length_only is FALSE
 **                  NULL otherwise
 **
@@ -1373,8 +1829,6 @@ static void llcp_link_proc_rx_data (BT_HDR *p_msg)
 static BT_HDR *llcp_link_get_next_pdu (BOOLEAN length_only, UINT16 *p_next_pdu_length)
 {
     BT_HDR *p_msg;
-    int     count, xx;
-    tLLCP_APP_CB *p_app_cb;
 
     /* processing signalling PDU first */
     if (llcp_cb.lcb.sig_xmit_q.p_first)
@@ -1390,111 +1844,125 @@ static BT_HDR *llcp_link_get_next_pdu (BOOLEAN length_only, UINT16 *p_next_pdu_l
 
         return p_msg;
     }
-    else
+
+    if (llcp_cb.lcb.low_latency_burst < LLCP_LOW_LATENCY_MAX_BURST)
     {
-        /* transmitting logical data link and data link connection equaly */
-        for (xx = 0; xx < 2; xx++)
+        p_msg = llcp_link_get_low_latency_pdu (length_only, p_next_pdu_length);
+        if ((p_msg) || (*p_next_pdu_length))
         {
-            if (!llcp_cb.lcb.ll_served)
-            {
-                /* Get one from logical link connection */
-                for (count = 0; count < LLCP_NUM_SAPS; count++)
-                {
-                    /* round robin schedule without priority  */
-                    p_app_cb = llcp_util_get_app_cb (llcp_cb.lcb.ll_idx);
+            if (p_msg)
+                llcp_cb.lcb.low_latency_burst++;
+            return p_msg;
+        }
+    }
 
-                    if (  (p_app_cb)
-                        &&(p_app_cb->p_app_cback)
-                        &&(p_app_cb->ui_xmit_q.count)  )
-                    {
-                        if (length_only)
-                        {
-                            /* don't alternate next data link to return the same length of PDU */
-                            p_msg = (BT_HDR *) p_app_cb->ui_xmit_q.p_first;
-                            *p_next_pdu_length = p_msg->len;
-                            return NULL;
-                        }
-                        else
-                        {
-                            /* check data link connection first in next time */
-                            llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
+    p_msg = llcp_link_get_weighted_pdu (llcp_cb.lcb.ll_active & ~llcp_cb.lcb.ll_low_latency,
+                                        llcp_cb.lcb.dl_ready & ~llcp_cb.lcb.dl_low_latency,
+                                        length_only, p_next_pdu_length);
+    if ((p_msg) || (*p_next_pdu_length))
+    {
+        if (p_msg)
+            llcp_cb.lcb.low_latency_burst = 0;
+        return p_msg;
+    }
 
-                            p_msg = (BT_HDR*) GKI_dequeue (&p_app_cb->ui_xmit_q);
-                            llcp_cb.total_tx_ui_pdu--;
+    /* nothing else is waiting, so low latency services can go on */
+    if (llcp_cb.lcb.low_latency_burst >= LLCP_LOW_LATENCY_MAX_BURST)
+    {
+        p_msg = llcp_link_get_low_latency_pdu (length_only, p_next_pdu_length);
+    }
 
-                            /* this logical link has been served, so start from next logical link next time */
-                            llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
+    return p_msg;
+}
 
-                            return p_msg;
-                        }
-                    }
-                    else
-                    {
-                        /* check next logical link connection */
-                        llcp_cb.lcb.ll_idx = (llcp_cb.lcb.ll_idx + 1) % LLCP_NUM_SAPS;
-                    }
-                }
+/* queue of PDU found by llcp_link_get_fitting_pdu () */
+#define LLCP_LINK_FIT_NONE      0
+#define LLCP_LINK_FIT_SIG       1
+#define LLCP_LINK_FIT_UI        2
+#define LLCP_LINK_FIT_DLC       3
 
-                /* no data, so check data link connection if not checked yet */
-                llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
-            }
-            else
-            {
-                /* Get one from data link connection */
-                for (count = 0; count < LLCP_MAX_DATA_LINK; count++)
-                {
-                    /* round robin schedule without priority  */
-                    if (llcp_cb.dlcb[llcp_cb.lcb.dl_idx].state != LLCP_DLC_STATE_IDLE)
-                    {
-                        if (length_only)
-                        {
-                            *p_next_pdu_length = llcp_dlc_get_next_pdu_length (&llcp_cb.dlcb[llcp_cb.lcb.dl_idx]);
-
-                            if (*p_next_pdu_length > 0 )
-                            {
-                                /* don't change data link connection to return the same length of PDU */
-                                return NULL;
-                            }
-                            else
-                            {
-                                /* no data, so check next data link connection */
-                                llcp_cb.lcb.dl_idx = (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
-                            }
-                        }
-                        else
-                        {
-                            p_msg = llcp_dlc_get_next_pdu (&llcp_cb.dlcb[llcp_cb.lcb.dl_idx]);
+/*******************************************************************************
+**
+** Function         llcp_link_get_fitting_pdu
+**
+** Description      Find the longest PDU up to max_length at the head of
+**                  signalling queue, UI queues and data link connections
+**                  which can send I PDU within remote RW, and dequeue it if
+**                  length_only is FALSE.
+**
+**                  It fills the room left in AGF PDU when the PDU next in
+**                  scheduling order doesn't fit.
+**
+** Returns          pointer of a PDU to send if length_only is FALSE
+**                  NULL otherwise
+**
+*******************************************************************************/
+static BT_HDR *llcp_link_get_fitting_pdu (BOOLEAN length_only, UINT16 max_length, UINT16 *p_pdu_length)
+{
+    tLLCP_APP_CB *p_app_cb;
+    UINT64        ll_set = llcp_cb.lcb.ll_active;
+    UINT32        dl_set = llcp_cb.lcb.dl_ready;
+    UINT16        length;
+    UINT8         idx, fit_idx = 0, fit = LLCP_LINK_FIT_NONE;
 
-                            /* this data link has been served, so start from next data link next time */
-                            llcp_cb.lcb.dl_idx = (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
+    *p_pdu_length = 0;
 
-                            if (p_msg)
-                            {
-                                /* serve logical data link next time */
-                                llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
-                                return p_msg;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        /* check next data link connection */
-                        llcp_cb.lcb.dl_idx = (llcp_cb.lcb.dl_idx + 1) % LLCP_MAX_DATA_LINK;
-                    }
-                }
+    if (llcp_cb.lcb.sig_xmit_q.p_first)
+    {
+        length = ((BT_HDR *) llcp_cb.lcb.sig_xmit_q.p_first)->len;
+        if (length <= max_length)
+        {
+            *p_pdu_length = length;
+            fit           = LLCP_LINK_FIT_SIG;
+        }
+    }
 
-                /* if all of data link connection doesn't have data to send */
-                if (count >= LLCP_MAX_DATA_LINK)
-                {
-                    llcp_cb.lcb.ll_served = !llcp_cb.lcb.ll_served;
-                }
-            }
+    while (ll_set)
+    {
+        idx     = (UINT8) __builtin_ctzll (ll_set);
+        ll_set &= ll_set - 1;
+
+        length = ((BT_HDR *) llcp_util_get_app_cb (idx)->ui_xmit_q.p_first)->len;
+        if ((length <= max_length) && (length > *p_pdu_length))
+        {
+            *p_pdu_length = length;
+            fit           = LLCP_LINK_FIT_UI;
+            fit_idx       = idx;
         }
     }
 
-    /* nothing to send */
-    *p_next_pdu_length = 0;
-    return NULL;
+    while (dl_set)
+    {
+        idx     = (UINT8) __builtin_ctz (dl_set);
+        dl_set &= dl_set - 1;
+
+        length = llcp_dlc_get_next_pdu_length (&llcp_cb.dlcb[idx]);
+        if ((length <= max_length) && (length > *p_pdu_length))
+        {
+            *p_pdu_length = length;
+            fit           = LLCP_LINK_FIT_DLC;
+            fit_idx       = idx;
+        }
+    }
+
+    if (length_only)
+        return NULL;
+
+    switch (fit)
+    {
+    case LLCP_LINK_FIT_SIG:
+        return ((BT_HDR *) GKI_dequeue (&llcp_cb.lcb.sig_xmit_q));
+
+    case LLCP_LINK_FIT_UI:
+        p_app_cb = llcp_util_get_app_cb (fit_idx);
+        return (llcp_link_dequeue_ui_pdu (fit_idx, p_app_cb));
+
+    case LLCP_LINK_FIT_DLC:
+        return (llcp_dlc_get_next_pdu (&llcp_cb.dlcb[fit_idx]));
+
+    default:
+        return NULL;
+    }
 }
 
 /*******************************************************************************
@@ -1511,7 +1979,8 @@ static BT_HDR *llcp_link_build_next_pdu (BT_HDR *p_pdu)
 {
     BT_HDR *p_agf = NULL, *p_msg = NULL, *p_next_pdu;
     UINT8  *p, ptype;
-    UINT16  next_pdu_length, pdu_hdr;
+    UINT16  next_pdu_length, pdu_hdr, used_length, room;
+    BOOLEAN is_fitting;
 
     LLCP_TRACE_DEBUG0 ("llcp_link_build_next_pdu ()");
 
@@ -1547,66 +2016,95 @@ static BT_HDR *llcp_link_build_next_pdu (BT_HDR *p_pdu)
         }
     }
 
-    /* Get length of next PDU from link manager or data links without dequeue */
-    llcp_link_get_next_pdu (TRUE, &next_pdu_length);
-    while (next_pdu_length > 0)
+    /*
+    ** Fill AGF PDU as much as link MIU allows. Take the next PDU in scheduling
+    ** order if it fits, otherwise the longest one fitting the room from any queue.
+    */
+    while (TRUE)
     {
-        /* if it's first visit */
+        /* information field used so far; each PDU in AGF has 2 bytes of length */
+        if (p_agf)
+            used_length = p_agf->len - LLCP_PDU_HEADER_SIZE;
+        else
+            used_length = 2 + p_msg->len;
+
+        if (used_length + 2 >= llcp_cb.lcb.effective_miu)
+            break;
+
+        room = llcp_cb.lcb.effective_miu - used_length - 2;
+
+        /* Get length of next PDU from link manager or data links without dequeue */
+        llcp_link_get_next_pdu (TRUE, &next_pdu_length);
+
+        if (next_pdu_length == 0)
+            break;
+
+        if (next_pdu_length > room)
+        {
+            llcp_link_get_fitting_pdu (TRUE, room, &next_pdu_length);
+
+            if (next_pdu_length == 0)
+                break;
+
+            is_fitting = TRUE;
+        }
+        else
+        {
+            is_fitting = FALSE;
+        }
+
+        /* if it's first visit, allocate AGF PDU and copy the first PDU */
         if (!p_agf)
         {
-            /* if next PDU fits into MIU, allocate AGF PDU and copy the first PDU */
-            if (2 + p_msg->len + 2 + next_pdu_length <= llcp_cb.lcb.effective_miu)
+            p_agf = (BT_HDR*) GKI_getpoolbuf (LLCP_POOL_ID);
+            if (p_agf)
             {
-                p_agf = (BT_HDR*) GKI_getpoolbuf (LLCP_POOL_ID);
-                if (p_agf)
-                {
-                    p_agf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
+                p_agf->offset = NCI_MSG_OFFSET_SIZE + NCI_DATA_HDR_SIZE;
 
-                    p = (UINT8 *) (p_agf + 1) + p_agf->offset;
+                p = (UINT8 *) (p_agf + 1) + p_agf->offset;
 
-                    UINT16_TO_BE_STREAM (p, LLCP_GET_PDU_HEADER (LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM ));
-                    UINT16_TO_BE_STREAM (p, p_msg->len);
-                    memcpy(p, (UINT8 *) (p_msg + 1) + p_msg->offset, p_msg->len);
+                UINT16_TO_BE_STREAM (p, LLCP_GET_PDU_HEADER (LLCP_SAP_LM, LLCP_PDU_AGF_TYPE, LLCP_SAP_LM ));
+                UINT16_TO_BE_STREAM (p, p_msg->len);
+                memcpy(p, (UINT8 *) (p_msg + 1) + p_msg->offset, p_msg->len);
 
-                    p_agf->len      = LLCP_PDU_HEADER_SIZE + 2 + p_msg->len;
+                p_agf->len      = LLCP_PDU_HEADER_SIZE + 2 + p_msg->len;
 
-                    GKI_freebuf (p_msg);
-                    p_msg = p_agf;
-                }
-                else
-                {
-                    LLCP_TRACE_ERROR0 ("llcp_link_build_next_pdu (): Out of buffer");
-                    return p_msg;
-                }
+                GKI_freebuf (p_msg);
+                p_msg = p_agf;
+
+                llcp_cb.lcb.stats.num_pdu_in_agf++;
             }
             else
             {
-                break;
+                LLCP_TRACE_ERROR0 ("llcp_link_build_next_pdu (): Out of buffer");
+                return p_msg;
             }
         }
 
-        /* if next PDU fits into MIU, copy the next PDU into AGF */
-        if (p_agf->len - LLCP_PDU_HEADER_SIZE + 2 + next_pdu_length <= llcp_cb.lcb.effective_miu)
+        /* Get the next PDU from link manager or data links and copy it into AGF */
+        if (is_fitting)
+        {
+            p_next_pdu = llcp_link_get_fitting_pdu (FALSE, room, &next_pdu_length);
+            llcp_cb.lcb.stats.num_pdu_fitted++;
+        }
+        else
         {
-            /* Get a next PDU from link manager or data links */
             p_next_pdu = llcp_link_get_next_pdu (FALSE, &next_pdu_length);
+        }
 
-            p = (UINT8 *) (p_agf + 1) + p_agf->offset + p_agf->len;
+        if (!p_next_pdu)
+            break;
 
-            UINT16_TO_BE_STREAM (p, p_next_pdu->len);
-            memcpy (p, (UINT8 *) (p_next_pdu + 1) + p_next_pdu->offset, p_next_pdu->len);
+        p = (UINT8 *) (p_agf + 1) + p_agf->offset + p_agf->len;
 
-            p_agf->len += 2 + p_next_pdu->len;
+        UINT16_TO_BE_STREAM (p, p_next_pdu->len);
+        memcpy (p, (UINT8 *) (p_next_pdu + 1) + p_next_pdu->offset, p_next_pdu->len);
 
-            GKI_freebuf (p_next_pdu);
+        p_agf->len += 2 + p_next_pdu->len;
 
-            /* Get next PDU length from link manager or data links without dequeue */
-            llcp_link_get_next_pdu (TRUE, &next_pdu_length);
-        }
-        else
-        {
-            break;
-        }
+        GKI_freebuf (p_next_pdu);
+
+        llcp_cb.lcb.stats.num_pdu_in_agf++;
     }
 
     if (p_agf)
@@ -1615,6 +2113,43 @@ static BT_HDR *llcp_link_build_next_pdu (BT_HDR *p_pdu)
         return p_msg;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_link_update_tx_util
+**
+** Description      Account for information field of PDU sent in local turn
+**                  against link MIU
+**
+** Returns          void
+**
+*******************************************************************************/
+static void llcp_link_update_tx_util (BT_HDR *p_pdu)
+{
+    UINT8  *p = (UINT8 *) (p_pdu + 1) + p_pdu->offset;
+    UINT16  pdu_hdr, info_length;
+    UINT8   ptype;
+
+    BE_STREAM_TO_UINT16 (pdu_hdr, p);
+    ptype = (UINT8) (LLCP_GET_PTYPE (pdu_hdr));
+
+    info_length = p_pdu->len - LLCP_PDU_HEADER_SIZE;
+
+    if (  (ptype == LLCP_PDU_I_TYPE)
+        ||(ptype == LLCP_PDU_RR_TYPE)
+        ||(ptype == LLCP_PDU_RNR_TYPE)  )
+    {
+        info_length -= LLCP_SEQUENCE_SIZE;
+    }
+    else if (ptype == LLCP_PDU_AGF_TYPE)
+    {
+        llcp_cb.lcb.stats.num_agf_tx++;
+    }
+
+    llcp_cb.lcb.stats.tx_info_length += info_length;
+    llcp_cb.lcb.stats.tx_miu_length  += llcp_cb.lcb.effective_miu;
+    llcp_cb.lcb.stats.miu_util_last   = (UINT8) (((UINT32) info_length * 100) / llcp_cb.lcb.effective_miu);
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_link_send_to_lower
@@ -1631,6 +2166,7 @@ static void llcp_link_send_to_lower (BT_HDR *p_pdu)
 #endif
 
     llcp_cb.lcb.symm_state = LLCP_LINK_SYMM_REMOTE_XMIT_NEXT;
+    llcp_cb.lcb.xmit_ticks = GKI_get_tick_count ();
 
     NFC_SendData (NFC_RF_CONN_ID, p_pdu);
 }
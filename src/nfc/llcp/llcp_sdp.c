@@ -296,6 +296,81 @@ static tLLCP_STATUS llcp_sdp_send_sdres (UINT8 tid, UINT8 sap)
     return status;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_sdp_hash_name
+**
+** Description      Get FNV-1a hash of service name
+**
+**
+** Returns          hash value
+**
+*******************************************************************************/
+static UINT32 llcp_sdp_hash_name (const UINT8 *p_name, UINT8 length)
+{
+    UINT32 hash = 2166136261u;
+
+    while (length--)
+    {
+        hash ^= *p_name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_sdp_add_service_name
+**
+** Description      Add service name of registered server into hash bucket,
+**                  so SDREQ and CONNECT by name don't compare every name
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_sdp_add_service_name (UINT8 sap, tLLCP_APP_CB *p_app_cb)
+{
+    UINT8 *p_bucket;
+
+    p_app_cb->sn_len  = (UINT8) strlen ((char *) p_app_cb->p_service_name);
+    p_app_cb->sn_hash = llcp_sdp_hash_name (p_app_cb->p_service_name, p_app_cb->sn_len);
+
+    p_bucket = &llcp_cb.sdp_cb.sn_bucket[p_app_cb->sn_hash & (LLCP_SDP_SN_HASH_SIZE - 1)];
+
+    p_app_cb->sn_next_sap = *p_bucket;
+    *p_bucket             = sap;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_sdp_remove_service_name
+**
+** Description      Remove service name of server from hash bucket
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_sdp_remove_service_name (UINT8 sap, tLLCP_APP_CB *p_app_cb)
+{
+    UINT8 *p_sap;
+
+    p_sap = &llcp_cb.sdp_cb.sn_bucket[p_app_cb->sn_hash & (LLCP_SDP_SN_HASH_SIZE - 1)];
+
+    while (*p_sap)
+    {
+        if (*p_sap == sap)
+        {
+            *p_sap = p_app_cb->sn_next_sap;
+            break;
+        }
+        p_sap = &llcp_util_get_app_cb (*p_sap)->sn_next_sap;
+    }
+
+    p_app_cb->sn_next_sap = 0;
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_sdp_get_sap_by_name
@@ -309,16 +384,18 @@ static tLLCP_STATUS llcp_sdp_send_sdres (UINT8 tid, UINT8 sap)
 UINT8 llcp_sdp_get_sap_by_name (char *p_name, UINT8 length)
 {
     UINT8        sap;
+    UINT32       hash;
     tLLCP_APP_CB *p_app_cb;
 
-    for (sap = LLCP_SAP_SDP; sap <= LLCP_UPPER_BOUND_SDP_SAP; sap++)
+    hash = llcp_sdp_hash_name ((UINT8 *) p_name, length);
+
+    for (sap = llcp_cb.sdp_cb.sn_bucket[hash & (LLCP_SDP_SN_HASH_SIZE - 1)]; sap; sap = p_app_cb->sn_next_sap)
     {
         p_app_cb = llcp_util_get_app_cb (sap);
 
-        if (  (p_app_cb)
-            &&(p_app_cb->p_app_cback)
-            &&(strlen((char*)p_app_cb->p_service_name) == length)
-            &&(!strncmp((char*)p_app_cb->p_service_name, p_name, length))  )
+        if (  (p_app_cb->sn_hash == hash)
+            &&(p_app_cb->sn_len == length)
+            &&(!memcmp (p_app_cb->p_service_name, p_name, length))  )
         {
             /* if device is under LLCP DTA testing */
             if (  (llcp_cb.p_dta_cback)
@@ -332,6 +409,98 @@ UINT8 llcp_sdp_get_sap_by_name (char *p_name, UINT8 length)
     return 0;
 }
 
+/*******************************************************************************
+**
+** Function         llcp_sdp_get_cached_sap
+**
+** Description      Search SAP of peer's service found by SDRES while LLCP link
+**                  has been activated
+**
+**
+** Returns          SAP if found, 0 otherwise
+**
+*******************************************************************************/
+UINT8 llcp_sdp_get_cached_sap (char *p_name)
+{
+#if (LLCP_SDP_CACHE_SIZE > 0)
+    tLLCP_SDP_CACHE *p_cache;
+    UINT32 hash;
+    UINT16 length = (UINT16) strlen (p_name);
+    UINT8  xx;
+
+    if (length > LLCP_SDP_CACHE_MAX_SN_LEN)
+        return 0;
+
+    hash = llcp_sdp_hash_name ((UINT8 *) p_name, (UINT8) length);
+
+    for (xx = 0, p_cache = llcp_cb.sdp_cb.cache; xx < LLCP_SDP_CACHE_SIZE; xx++, p_cache++)
+    {
+        if (  (p_cache->sap)
+            &&(p_cache->sn_hash == hash)
+            &&(p_cache->sn_len == length)
+            &&(!memcmp (p_cache->sn, p_name, length))  )
+        {
+            LLCP_TRACE_DEBUG2 ("llcp_sdp_get_cached_sap (): SN:<%s>, SAP=0x%x", p_name, p_cache->sap);
+            return (p_cache->sap);
+        }
+    }
+#endif
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function         llcp_sdp_reserve_cache
+**
+** Description      Reserve cache entry for service name of SDREQ to keep SAP
+**                  in SDRES
+**
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_sdp_reserve_cache (tLLCP_SDP_TRANSAC *p_transac, char *p_name)
+{
+#if (LLCP_SDP_CACHE_SIZE > 0)
+    tLLCP_SDP_CACHE *p_cache;
+    UINT16 length = (UINT16) strlen (p_name);
+    UINT8  xx;
+
+    p_transac->cache_idx = LLCP_SDP_CACHE_SIZE;
+
+    if ((length == 0) || (length > LLCP_SDP_CACHE_MAX_SN_LEN))
+        return;
+
+    p_transac->sn_hash = llcp_sdp_hash_name ((UINT8 *) p_name, (UINT8) length);
+
+    /* share the entry of the same name being discovered */
+    for (xx = 0, p_cache = llcp_cb.sdp_cb.cache; xx < LLCP_SDP_CACHE_SIZE; xx++, p_cache++)
+    {
+        if (  (p_cache->sn_hash == p_transac->sn_hash)
+            &&(p_cache->sn_len == length)
+            &&(!memcmp (p_cache->sn, p_name, length))  )
+        {
+            p_transac->cache_idx = xx;
+            return;
+        }
+    }
+
+    /* replace entries in turn */
+    xx      = llcp_cb.sdp_cb.cache_next;
+    p_cache = &llcp_cb.sdp_cb.cache[xx];
+    llcp_cb.sdp_cb.cache_next = (xx + 1) % LLCP_SDP_CACHE_SIZE;
+
+    p_cache->sn_hash = p_transac->sn_hash;
+    p_cache->sn_len  = (UINT8) length;
+    p_cache->sap     = 0;
+    memcpy (p_cache->sn, p_name, length);
+
+    p_transac->cache_idx = xx;
+#else
+    p_transac->cache_idx = LLCP_SDP_CACHE_SIZE;
+#endif
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_sdp_return_sap
@@ -353,6 +522,15 @@ static void llcp_sdp_return_sap (UINT8 tid, UINT8 sap)
         if (  (llcp_cb.sdp_cb.transac[i].p_cback)
             &&(llcp_cb.sdp_cb.transac[i].tid == tid)  )
         {
+#if (LLCP_SDP_CACHE_SIZE > 0)
+            /* keep SAP of the service unless the entry has been taken by other name */
+            if (  (sap)
+                &&(llcp_cb.sdp_cb.transac[i].cache_idx < LLCP_SDP_CACHE_SIZE)
+                &&(llcp_cb.sdp_cb.cache[llcp_cb.sdp_cb.transac[i].cache_idx].sn_hash == llcp_cb.sdp_cb.transac[i].sn_hash)  )
+            {
+                llcp_cb.sdp_cb.cache[llcp_cb.sdp_cb.transac[i].cache_idx].sap = sap;
+            }
+#endif
             (*llcp_cb.sdp_cb.transac[i].p_cback) (tid, sap);
 
             llcp_cb.sdp_cb.transac[i].p_cback = NULL;
@@ -395,6 +573,12 @@ void llcp_sdp_proc_deactivation (void)
 
     llcp_cb.sdp_cb.next_tid = 0;
     llcp_cb.dta_snl_resp = FALSE;
+
+#if (LLCP_SDP_CACHE_SIZE > 0)
+    /* SAPs of peer's services are valid only in this link */
+    memset (llcp_cb.sdp_cb.cache, 0x00, sizeof (llcp_cb.sdp_cb.cache));
+    llcp_cb.sdp_cb.cache_next = 0;
+#endif
 }
 
 /*******************************************************************************
@@ -277,8 +277,12 @@ tLLCP_STATUS llcp_util_send_ui (UINT8 ssap, UINT8 dsap, tLLCP_APP_CB *p_app_cb,
     p = (UINT8 *) (p_msg + 1) + p_msg->offset;
     UINT16_TO_BE_STREAM (p, LLCP_GET_PDU_HEADER (dsap, LLCP_PDU_UI_TYPE, ssap));
 
+    /* time stamp for queueing delay */
+    p_msg->layer_specific = (UINT16) GKI_get_tick_count ();
+
     GKI_enqueue (&p_app_cb->ui_xmit_q, p_msg);
     llcp_cb.total_tx_ui_pdu++;
+    llcp_cb.lcb.ll_active |= ((UINT64) 1 << ssap);
 
     llcp_link_check_send_data ();
 
@@ -365,9 +369,17 @@ tLLCP_DLCB *llcp_util_allocate_data_link (UINT8 reg_sap, UINT8 remote_sap)
     {
         p_dlcb->p_app_cb    = llcp_util_get_app_cb (reg_sap);
         p_dlcb->local_sap   = reg_sap;
-        p_dlcb->remote_sap  = remote_sap;
+        p_dlcb->remote_sap  = LLCP_INVALID_SAP;
         p_dlcb->timer.param = (TIMER_PARAM_TYPE) p_dlcb;
 
+        /* index by SAPs for llcp_dlc_find_dlcb_by_sap () */
+        llcp_cb.dlcb_by_local_sap[reg_sap & LLCP_SAP_MASK] |= ((UINT32) 1 << idx);
+        llcp_util_set_remote_sap (p_dlcb, remote_sap);
+
+        /* tx scheduler visits it once it has a PDU ready, see llcp_dlc_update_ready () */
+        if ((p_dlcb->p_app_cb) && (p_dlcb->p_app_cb->tx_low_latency))
+            llcp_cb.lcb.dl_low_latency |= ((UINT32) 1 << idx);
+
         /* this is for inactivity timer and congestion control. */
         llcp_cb.num_data_link_connection++;
 
@@ -399,6 +411,14 @@ void llcp_util_deallocate_data_link (tLLCP_DLCB *p_dlcb)
 
             p_dlcb->state = LLCP_DLC_STATE_IDLE;
 
+            /* remove from index by SAPs */
+            llcp_util_set_remote_sap (p_dlcb, LLCP_INVALID_SAP);
+            llcp_cb.dlcb_by_local_sap[p_dlcb->local_sap & LLCP_SAP_MASK] &= ~((UINT32) 1 << (p_dlcb - llcp_cb.dlcb));
+
+            /* remove from the data link connections of tx scheduler */
+            llcp_cb.lcb.dl_ready       &= ~((UINT32) 1 << (p_dlcb - llcp_cb.dlcb));
+            llcp_cb.lcb.dl_low_latency &= ~((UINT32) 1 << (p_dlcb - llcp_cb.dlcb));
+
             if (llcp_cb.num_data_link_connection > 0)
             {
                 llcp_cb.num_data_link_connection--;
@@ -409,6 +429,57 @@ void llcp_util_deallocate_data_link (tLLCP_DLCB *p_dlcb)
     }
 }
 
+/*******************************************************************************
+**
+** Function         llcp_util_set_remote_sap
+**
+** Description      Set remote SAP of data link connection and move it in index
+**                  by SAPs. LLCP_INVALID_SAP removes it from the index.
+**
+** Returns          void
+**
+******************************************************************************/
+void llcp_util_set_remote_sap (tLLCP_DLCB *p_dlcb, UINT8 remote_sap)
+{
+    UINT8 *p_idx;
+    UINT8  idx = (UINT8) (p_dlcb - llcp_cb.dlcb);
+    UINT32 dl_set;
+
+    if (p_dlcb->remote_sap != LLCP_INVALID_SAP)
+    {
+        p_idx = &llcp_cb.dlcb_by_sap[p_dlcb->local_sap & LLCP_SAP_MASK][p_dlcb->remote_sap & LLCP_SAP_MASK];
+
+        if (*p_idx == idx + 1)
+        {
+            *p_idx = 0;
+
+            /* another data link connection may have been requested on the same SAPs */
+            dl_set = llcp_cb.dlcb_by_local_sap[p_dlcb->local_sap & LLCP_SAP_MASK] & ~((UINT32) 1 << idx);
+            for ( ; dl_set; dl_set &= dl_set - 1)
+            {
+                if (llcp_cb.dlcb[__builtin_ctz (dl_set)].remote_sap == p_dlcb->remote_sap)
+                {
+                    *p_idx = (UINT8) __builtin_ctz (dl_set) + 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    p_dlcb->remote_sap = remote_sap;
+
+    if (remote_sap != LLCP_INVALID_SAP)
+    {
+        p_idx = &llcp_cb.dlcb_by_sap[p_dlcb->local_sap & LLCP_SAP_MASK][remote_sap & LLCP_SAP_MASK];
+
+        if (*p_idx == 0)
+            *p_idx = idx + 1;
+        else
+            LLCP_TRACE_DEBUG2 ("llcp_util_set_remote_sap (): SAP (0x%x,0x%x) is indexed for another data link",
+                               p_dlcb->local_sap, remote_sap);
+    }
+}
+
 /*******************************************************************************
 **
 ** Function         llcp_util_send_connect
@@ -910,3 +981,28 @@ tLLCP_APP_CB *llcp_util_get_app_cb (UINT8 local_sap)
 
     return (p_app_cb);
 }
+
+/*******************************************************************************
+**
+** Function         llcp_util_update_tx_stats
+**
+** Description      Account for a UI or I PDU taken from tx queue of the SAP.
+**                  layer_specific of the PDU has the tick count when queued.
+**
+** Returns          void
+**
+*******************************************************************************/
+void llcp_util_update_tx_stats (tLLCP_APP_CB *p_app_cb, BT_HDR *p_msg)
+{
+    UINT32 delay;
+
+    if (p_app_cb)
+    {
+        delay = GKI_TICKS_TO_MS ((UINT16) ((UINT16) GKI_get_tick_count () - p_msg->layer_specific));
+
+        p_app_cb->tx_stats.num_tx_pdu++;
+        p_app_cb->tx_stats.total_delay += delay;
+        if (delay > p_app_cb->tx_stats.max_delay)
+            p_app_cb->tx_stats.max_delay = delay;
+    }
+}
@@ -127,11 +127,78 @@ UINT8 nci_snd_core_get_config (UINT8 *param_ids, UINT8 num_ids)
     return (NCI_STATUS_OK);
 }
 
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+/*******************************************************************************
+**
+** Function         nci_merge_core_set_config
+**
+** Description      merge parameter TLVs into the CORE SET_CONFIG command which
+**                  is not sent yet. A parameter set again replaces the queued
+**                  one.
+**
+** Returns          TRUE if merged, FALSE if the command would be too long
+**
+*******************************************************************************/
+static BOOLEAN nci_merge_core_set_config (UINT8 *p_param_tlvs, UINT8 tlv_size, UINT8 num)
+{
+    BT_HDR *p = nfc_cb.p_setcfg_pend;
+    UINT8  tlvs[NCI_MAX_CTRL_SIZE];
+    UINT8  *pp, *pt, *pn, *p_end;
+    UINT16 len = 0;
+    BOOLEAN found;
+
+    pp    = (UINT8 *) (p + 1) + p->offset;
+    p_end = pp + p->len;
+    pt    = pp + NCI_MSG_HDR_SIZE + 1;
+
+    /* keep the queued parameters which are not set again */
+    while (pt + 1 < p_end)
+    {
+        for (pn = p_param_tlvs, found = FALSE; pn < p_param_tlvs + tlv_size; pn += pn[1] + 2)
+        {
+            if (*pn == *pt)
+            {
+                found = TRUE;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            if (len + pt[1] + 2 + tlv_size + 1 > nfc_cb.nci_ctrl_size)
+                return (FALSE);
+
+            memcpy (tlvs + len, pt, pt[1] + 2);
+            len += pt[1] + 2;
+            num++;
+        }
+        pt += pt[1] + 2;
+    }
+
+    if (len + tlv_size + 1 > nfc_cb.nci_ctrl_size)
+        return (FALSE);
+
+    memcpy (tlvs + len, p_param_tlvs, tlv_size);
+    len += tlv_size;
+
+    pp += NCI_MSG_HDR_SIZE - 1;
+    UINT8_TO_STREAM (pp, (UINT8) (len + 1));
+    UINT8_TO_STREAM (pp, num);
+    ARRAY_TO_STREAM (pp, tlvs, len);
+    p->len = NCI_MSG_HDR_SIZE + 1 + len;
+
+    return (TRUE);
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         nci_snd_core_set_config
 **
-** Description      compose and send CORE SET_CONFIG command to command queue
+** Description      compose and send CORE SET_CONFIG command to command queue.
+**                  If NFC_SET_CONFIG_COALESCE_INCLUDED, the TLVs are merged
+**                  with the other SET_CONFIG issued while NFC_TASK processes
+**                  its events, up to the max control packet size of NFCC.
 **
 ** Returns          status
 **
@@ -142,17 +209,6 @@ UINT8 nci_snd_core_set_config (UINT8 *p_param_tlvs, UINT8 tlv_size)
     UINT8 *pp;
     UINT8  num = 0, ulen, len, *pt;
 
-    if ((p = NCI_GET_CMD_BUF (tlv_size + 1)) == NULL)
-        return (NCI_STATUS_FAILED);
-
-    p->event    = BT_EVT_TO_NFC_NCI;
-    p->len      = NCI_MSG_HDR_SIZE + tlv_size + 1;
-    p->offset   = NCI_MSG_OFFSET_SIZE;
-    pp          = (UINT8 *) (p + 1) + p->offset;
-
-    NCI_MSG_BLD_HDR0 (pp, NCI_MT_CMD, NCI_GID_CORE);
-    NCI_MSG_BLD_HDR1 (pp, NCI_MSG_CORE_SET_CONFIG);
-    UINT8_TO_STREAM (pp, (UINT8) (tlv_size + 1));
     len         = tlv_size;
     pt          = p_param_tlvs;
     while (len > 1)
@@ -168,13 +224,48 @@ UINT8 nci_snd_core_set_config (UINT8 *p_param_tlvs, UINT8 tlv_size)
         }
         else
         {
-            GKI_freebuf (p);
             return NCI_STATUS_FAILED;
         }
     }
 
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    if (nfc_cb.p_setcfg_pend)
+    {
+        if (nci_merge_core_set_config (p_param_tlvs, tlv_size, num))
+        {
+            nfc_cb.setcfg_pend_reqs++;
+            return (NCI_STATUS_OK);
+        }
+        nfc_ncif_flush_set_config ();
+    }
+
+    if ((p = NCI_GET_CMD_BUF (NCI_MAX_CTRL_SIZE)) == NULL)
+        return (NCI_STATUS_FAILED);
+#else
+    if ((p = NCI_GET_CMD_BUF (tlv_size + 1)) == NULL)
+        return (NCI_STATUS_FAILED);
+#endif
+
+    p->event    = BT_EVT_TO_NFC_NCI;
+    p->len      = NCI_MSG_HDR_SIZE + tlv_size + 1;
+    p->offset   = NCI_MSG_OFFSET_SIZE;
+    pp          = (UINT8 *) (p + 1) + p->offset;
+
+    NCI_MSG_BLD_HDR0 (pp, NCI_MT_CMD, NCI_GID_CORE);
+    NCI_MSG_BLD_HDR1 (pp, NCI_MSG_CORE_SET_CONFIG);
+    UINT8_TO_STREAM (pp, (UINT8) (tlv_size + 1));
     UINT8_TO_STREAM (pp, num);
     ARRAY_TO_STREAM (pp, p_param_tlvs, tlv_size);
+
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    /* hold it until NFC_TASK is done with its events, unless it is already full */
+    if (tlv_size + 1 < nfc_cb.nci_ctrl_size)
+    {
+        nfc_cb.p_setcfg_pend    = p;
+        nfc_cb.setcfg_pend_reqs = 1;
+        return (NCI_STATUS_OK);
+    }
+#endif
     nfc_ncif_send_cmd (p);
 
     return (NCI_STATUS_OK);
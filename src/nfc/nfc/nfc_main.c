@@ -251,6 +251,7 @@ void nfc_enabled (tNFC_STATUS nfc_status, BT_HDR *p_init_rsp_msg)
         nfc_cb.max_conn              = evt_data.enable.max_conn;
 #endif
         nfc_cb.nci_ctrl_size         = *p++; /* Max Control Packet Payload Length */
+        evt_data.enable.max_ctrl_size = nfc_cb.nci_ctrl_size;
         p_cb->init_credits           = p_cb->num_buff = 0;
         STREAM_TO_UINT16 (evt_data.enable.max_param_size, p);
         nfc_set_conn_id (p_cb, NFC_RF_CONN_ID);
@@ -515,6 +516,16 @@ void nfc_main_flush_cmd_queue (void)
     {
         GKI_freebuf (p_msg);
     }
+
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    if (nfc_cb.p_setcfg_pend)
+    {
+        GKI_freebuf (nfc_cb.p_setcfg_pend);
+        nfc_cb.p_setcfg_pend = NULL;
+    }
+    nfc_cb.setcfg_pend_reqs = 0;
+    nfc_cb.setcfg_rsp_reqs  = 0;
+#endif
 }
 
 /*******************************************************************************
@@ -632,6 +643,9 @@ static void nfc_main_hal_data_cback(UINT16 data_len, UINT8   *p_data)
 
             /* no need to check length, it always less than pool size */
             memcpy ((UINT8 *)(p_msg + 1) + p_msg->offset, p_data, p_msg->len);
+#if (NFC_LATENCY_INCLUDED == TRUE)
+            GKI_set_buf_time (p_msg, nfc_lat_now ());
+#endif
 
             GKI_send_msg (NFC_TASK, NFC_MBOX_ID, p_msg);
         }
@@ -642,6 +656,62 @@ static void nfc_main_hal_data_cback(UINT16 data_len, UINT8   *p_data)
     }
 }
 
+/*******************************************************************************
+**
+** Function         nfc_main_hal_data_buf_cback
+**
+** Description      HAL data event handler taking the ownership of the buffer;
+**                  the NCI message is forwarded to NFC_TASK without a copy
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_main_hal_data_buf_cback (NFC_HDR *p_hal_msg)
+{
+    BT_HDR *p_msg = (BT_HDR *) p_hal_msg;
+
+    /* ignore all data while shutting down NFCC */
+    if (nfc_cb.nfc_state == NFC_STATE_W4_HAL_CLOSE)
+    {
+        GKI_freebuf (p_msg);
+        return;
+    }
+
+    if (p_msg->offset < NFC_RECEIVE_MSGS_OFFSET)
+    {
+        /* not enough room in front of the message for NFC_TASK; copy it */
+        nfc_main_hal_data_cback (p_msg->len, (UINT8 *) (p_msg + 1) + p_msg->offset);
+        GKI_freebuf (p_msg);
+        return;
+    }
+
+    p_msg->event          = BT_EVT_TO_NFC_NCI;
+    p_msg->layer_specific = 0;
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    GKI_set_buf_time (p_msg, nfc_lat_now ());
+#endif
+
+    GKI_send_msg (NFC_TASK, NFC_MBOX_ID, p_msg);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_main_open_hal
+**
+** Description      Open HAL transport, receiving NCI messages without a copy
+**                  if the HAL supports it
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_main_open_hal (void)
+{
+    if (nfc_cb.p_hal->set_data_buf_cback)
+        nfc_cb.p_hal->set_data_buf_cback (nfc_main_hal_data_buf_cback);
+
+    nfc_cb.p_hal->open (nfc_main_hal_cback, nfc_main_hal_data_cback);
+}
+
 /*******************************************************************************
 **
 ** Function         NFC_Enable
@@ -675,7 +745,7 @@ tNFC_STATUS NFC_Enable (tNFC_RESPONSE_CBACK *p_cback)
 
     /* Open HAL transport. */
     nfc_set_state (NFC_STATE_W4_HAL_OPEN);
-    nfc_cb.p_hal->open (nfc_main_hal_cback, nfc_main_hal_data_cback);
+    nfc_main_open_hal ();
 
     return (NFC_STATUS_OK);
 }
@@ -1247,7 +1317,7 @@ tNFC_STATUS NFC_SetPowerOffSleep (BOOLEAN enable)
 
         /* open transport */
         nfc_set_state (NFC_STATE_W4_HAL_OPEN);
-        nfc_cb.p_hal->open (nfc_main_hal_cback, nfc_main_hal_data_cback);
+        nfc_main_open_hal ();
 
         return NFC_STATUS_OK;
     }
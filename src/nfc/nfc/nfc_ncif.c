@@ -200,6 +200,28 @@ UINT8 nfc_ncif_send_data (tNFC_CONN_CB *p_cb, BT_HDR *p_data)
             p         = p_data;
             p_data    = (BT_HDR *)GKI_dequeue (&p_cb->tx_q);
         }
+#if (NFC_NCI_TX_FRAG_IN_PLACE == TRUE)
+        else
+        {
+            /* send the fragment from the original buffer. Its NCI data header
+             * overwrites the end of the previous fragment, already consumed by
+             * the HAL (or the reserved offset for the first fragment) */
+            pp = (UINT8 *)(p_data + 1) + p_data->offset - NCI_DATA_HDR_SIZE;
+            ps = pp;
+            NCI_DATA_PBLD_HDR(pp, pbf, hdr0, ulen);
+
+            if (p_cb->num_buff != NFC_CONN_NO_FC)
+                p_cb->num_buff--;
+
+            /* send to HAL */
+            nfc_cb.p_hal->write((UINT16)(ulen + NCI_DATA_HDR_SIZE), ps);
+
+            /* adjust the BT_HDR on the old fragment */
+            p_data->len     -= ulen;
+            p_data->offset  += ulen;
+            continue;
+        }
+#else
         else
         {
             /* the data packet is too big and need to be fragmented
@@ -216,6 +238,7 @@ UINT8 nfc_ncif_send_data (tNFC_CONN_CB *p_cb, BT_HDR *p_data)
             p_data->len     -= ulen;
             p_data->offset  += ulen;
         }
+#endif
 
         p->event             = BT_EVT_TO_NFC_NCI;
         p->layer_specific    = pbf;
@@ -254,6 +277,13 @@ UINT8 nfc_ncif_send_data (tNFC_CONN_CB *p_cb, BT_HDR *p_data)
 void nfc_ncif_check_cmd_queue (BT_HDR *p_buf)
 {
     UINT8   *ps;
+
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    /* the coalesced CORE_SET_CONFIG was issued before this command */
+    if ((p_buf) && (nfc_cb.p_setcfg_pend))
+        nfc_ncif_flush_set_config ();
+#endif
+
     /* If there are commands waiting in the xmit queue, or if the controller cannot accept any more commands, */
     /* then enqueue this command */
     if (p_buf)
@@ -283,10 +313,20 @@ void nfc_ncif_check_cmd_queue (BT_HDR *p_buf)
                 /* save the callback for NCI VSCs)  */
                 nfc_cb.p_vsc_cback = (void *)((tNFC_NCI_VS_MSG *)p_buf)->p_cback;
             }
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+            /* save the number of NFC_SET_CONFIG_REVT to report for the response */
+            if (p_buf->layer_specific & NFC_WAIT_RSP_SET_CONFIG)
+                nfc_cb.setcfg_rsp_reqs = (UINT8) (p_buf->layer_specific >> 8);
+            else
+                nfc_cb.setcfg_rsp_reqs = 0;
+#endif
 
             /* send to HAL */
             nfc_cb.p_hal->write(p_buf->len, (UINT8 *)(p_buf+1) + p_buf->offset);
             GKI_freebuf(p_buf);
+#if (NFC_LATENCY_INCLUDED == TRUE)
+            nfc_cb.nci_cmd_time = nfc_lat_now ();
+#endif
 
             /* Indicate command is pending */
             nfc_cb.nci_cmd_window--;
@@ -351,6 +391,36 @@ void nfc_ncif_send_cmd (BT_HDR *p_buf)
     nfc_ncif_check_cmd_queue (p_buf);
 }
 
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+/*******************************************************************************
+**
+** Function         nfc_ncif_flush_set_config
+**
+** Description      Send the CORE_SET_CONFIG command merged from the
+**                  NFC_SetConfig () calls since the last flush, if any.
+**                  It is called before any other command is sent and when
+**                  NFC_TASK has processed its pending events.
+**
+** Returns          void
+**
+*******************************************************************************/
+void nfc_ncif_flush_set_config (void)
+{
+    BT_HDR *p_buf = nfc_cb.p_setcfg_pend;
+
+    if (p_buf == NULL)
+        return;
+
+    NFC_TRACE_DEBUG1 ("nfc_ncif_flush_set_config () merged:%d", nfc_cb.setcfg_pend_reqs);
+
+    nfc_cb.p_setcfg_pend    = NULL;
+    p_buf->event            = BT_EVT_TO_NFC_NCI;
+    p_buf->layer_specific   = (UINT16) ((nfc_cb.setcfg_pend_reqs << 8) | NFC_WAIT_RSP_SET_CONFIG);
+    nfc_cb.setcfg_pend_reqs = 0;
+
+    nfc_ncif_check_cmd_queue (p_buf);
+}
+#endif
 
 /*******************************************************************************
 **
@@ -369,6 +439,10 @@ BOOLEAN nfc_ncif_process_event (BT_HDR *p_msg)
     UINT8   oid;
     UINT8   *p_old, old_gid, old_oid, old_mt;
 
+#if (NFC_LATENCY_INCLUDED == TRUE)
+    nfc_lat_since (NFC_LAT_NCIF, GKI_get_buf_time (p_msg));
+#endif
+
     p = (UINT8 *) (p_msg + 1) + p_msg->offset;
 
     pp = p;
@@ -394,6 +468,10 @@ BOOLEAN nfc_ncif_process_event (BT_HDR *p_msg)
             NFC_TRACE_ERROR2 ("nfc_ncif_process_event unexpected rsp: gid:0x%x, oid:0x%x", gid, oid);
             return TRUE;
         }
+#if (NFC_LATENCY_INCLUDED == TRUE)
+        nfc_lat_since (NFC_LAT_CMD_RTT, nfc_cb.nci_cmd_time);
+        nfc_cb.nci_cmd_time = 0;
+#endif
 
         switch (gid)
         {
@@ -485,6 +563,15 @@ void nfc_ncif_rf_management_status (tNFC_DISCOVER_EVT event, UINT8 status)
 void nfc_ncif_set_config_status (UINT8 *p, UINT8 len)
 {
     tNFC_RESPONSE   evt_data;
+    UINT8           reqs = 1;
+
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+    /* the response is reported to every NFC_SetConfig () merged in the command */
+    if (nfc_cb.setcfg_rsp_reqs)
+        reqs = nfc_cb.setcfg_rsp_reqs;
+    nfc_cb.setcfg_rsp_reqs = 0;
+#endif
+
     if (nfc_cb.p_resp_cback)
     {
         evt_data.set_config.status          = (tNFC_STATUS) *p++;
@@ -495,7 +582,8 @@ void nfc_ncif_set_config_status (UINT8 *p, UINT8 len)
             STREAM_TO_ARRAY (evt_data.set_config.param_ids, p, evt_data.set_config.num_param_id);
         }
 
-        (*nfc_cb.p_resp_cback) (NFC_SET_CONFIG_REVT, &evt_data);
+        while (reqs--)
+            (*nfc_cb.p_resp_cback) (NFC_SET_CONFIG_REVT, &evt_data);
     }
 }
 
@@ -966,6 +1054,14 @@ void nfc_ncif_proc_deactivate (UINT8 status, UINT8 deact_type, BOOLEAN is_ntf)
         GKI_freebuf (p_data);
     }
 
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == TRUE)
+    while ((p_data = GKI_dequeue (&p_cb->rx_frag_q)) != NULL)
+    {
+        GKI_freebuf (p_data);
+    }
+    p_cb->rx_frag_len = 0;
+#endif
+
     while ((p_data = GKI_dequeue (&p_cb->tx_q)) != NULL)
     {
         GKI_freebuf (p_data);
@@ -1411,6 +1507,202 @@ void nfc_data_event (tNFC_CONN_CB * p_cb)
     }
 }
 
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == TRUE)
+/*******************************************************************************
+**
+** Function         nfc_ncif_linearize_frags
+**
+** Description      Copy the payloads of the fragments in the fragment list of
+**                  the connection into one buffer of at least size bytes (the
+**                  first fragment itself if it has room). The buffer is left
+**                  alone in the fragment list.
+**
+** Returns          TRUE if success
+**
+*******************************************************************************/
+static BOOLEAN nfc_ncif_linearize_frags (tNFC_CONN_CB *p_cb, UINT32 size)
+{
+    BT_HDR  *p_first, *p_frag, *p_buf;
+    UINT8   *ps, *pd;
+    UINT16  len;
+
+    p_first = (BT_HDR *) GKI_getfirst (&p_cb->rx_frag_q);
+
+    if (GKI_get_buf_size (p_first) >= size)
+    {
+        /* the first fragment has room for all the others */
+        p_buf = (BT_HDR *) GKI_dequeue (&p_cb->rx_frag_q);
+    }
+    else if (  (size <= GKI_MAX_BUF_SIZE)
+             &&((p_buf = (BT_HDR *) GKI_getbuf ((UINT16) size)) != NULL)  )
+    {
+        memcpy (p_buf, p_first, BT_HDR_SIZE);
+        pd  = (UINT8 *) (p_buf + 1) + p_buf->offset;
+        ps  = (UINT8 *) (p_first + 1) + p_first->offset;
+        memcpy (pd, ps, p_first->len);
+
+        GKI_freebuf (GKI_dequeue (&p_cb->rx_frag_q));
+    }
+    else
+    {
+        return (FALSE);
+    }
+
+    /* append the payload of the other fragments */
+    while ((p_frag = (BT_HDR *) GKI_dequeue (&p_cb->rx_frag_q)) != NULL)
+    {
+        ps  = (UINT8 *) (p_frag + 1) + p_frag->offset + NCI_DATA_HDR_SIZE;
+        pd  = (UINT8 *) (p_buf + 1) + p_buf->offset + p_buf->len;
+        len = p_frag->len - NCI_DATA_HDR_SIZE;
+        memcpy (pd, ps, len);
+        p_buf->len += len;
+        GKI_freebuf (p_frag);
+    }
+
+    GKI_enqueue (&p_cb->rx_frag_q, p_buf);
+    return (TRUE);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_ncif_drop_frags
+**
+** Description      The data packet being reassembled does not fit in any
+**                  buffer. Keep the first fragment to report with
+**                  NFC_RAS_TOO_BIG and free the others. The rest of the packet
+**                  is dropped as it comes.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void nfc_ncif_drop_frags (tNFC_CONN_CB *p_cb)
+{
+    BT_HDR  *p_first, *p_frag;
+
+    NFC_TRACE_ERROR1 ("nci_reassemble_msg buffer overrun(%d)!!", p_cb->rx_frag_len);
+
+    p_first = (BT_HDR *) GKI_dequeue (&p_cb->rx_frag_q);
+    while ((p_frag = (BT_HDR *) GKI_dequeue (&p_cb->rx_frag_q)) != NULL)
+    {
+        GKI_freebuf (p_frag);
+    }
+
+    p_first->layer_specific |= NFC_RAS_TOO_BIG;
+    GKI_enqueue (&p_cb->rx_frag_q, p_first);
+}
+
+/*******************************************************************************
+**
+** Function         nfc_ncif_reassemble_data
+**
+** Description      Add a fragment of a segmented data packet to the fragment
+**                  list of the connection. When the last fragment is received,
+**                  copy the payloads once into a buffer big enough for the
+**                  whole packet (the first fragment itself if it has room).
+**
+**                  Fragments are held in buffers of the NCI pool, which also
+**                  carries responses and notifications. Once the list holds
+**                  NFC_NCI_RX_CHAIN_MAX_FRAGS fragments, they are copied into
+**                  one buffer of twice the size held so far, and the next
+**                  fragments are appended to it as they come. The buffer is
+**                  grown the same way whenever the list fills up again.
+**
+** Returns          the reassembled data packet, or NULL if more fragments are
+**                  expected
+**
+*******************************************************************************/
+static BT_HDR *nfc_ncif_reassemble_data (tNFC_CONN_CB *p_cb, BT_HDR *p_msg, UINT8 pbf)
+{
+    BT_HDR  *p_first, *p_buf;
+    UINT8   *ps, *pd;
+    UINT16  len;
+    UINT32  size, grow_size;
+
+    len     = p_msg->len - NCI_DATA_HDR_SIZE;
+    p_first = (BT_HDR *) GKI_getfirst (&p_cb->rx_frag_q);
+
+    if ((p_first) && ((p_first->layer_specific & NFC_RAS_TOO_BIG) == 0))
+    {
+        /* buffer size needed for the packet so far, including this fragment */
+        size = BT_HDR_SIZE + p_first->offset + NCI_DATA_HDR_SIZE + p_cb->rx_frag_len + len;
+
+        if (size > GKI_MAX_BUF_SIZE)
+        {
+            /* can not be reassembled in any buffer */
+            p_cb->rx_frag_len += len;
+            nfc_ncif_drop_frags (p_cb);
+        }
+        else if (p_cb->rx_frag_q.count >= NFC_NCI_RX_CHAIN_MAX_FRAGS)
+        {
+            /* leave room for as much again, or take just what is needed
+             * if no buffer that big is free */
+            grow_size = 2 * size;
+            if (grow_size > GKI_MAX_BUF_SIZE)
+                grow_size = GKI_MAX_BUF_SIZE;
+
+            if (  (!nfc_ncif_linearize_frags (p_cb, grow_size))
+                &&(!nfc_ncif_linearize_frags (p_cb, size))  )
+            {
+                nfc_ncif_drop_frags (p_cb);
+            }
+        }
+        p_first = (BT_HDR *) GKI_getfirst (&p_cb->rx_frag_q);
+    }
+
+    if ((p_first) && (p_first->layer_specific & NFC_RAS_TOO_BIG))
+    {
+        /* overrun has been reported; drop the rest of the packet */
+        GKI_freebuf (p_msg);
+    }
+    else if (  (p_first)
+             &&(p_cb->rx_frag_q.count == 1)
+             &&(GKI_get_buf_size (p_first) >= BT_HDR_SIZE + p_first->offset + p_first->len + len)  )
+    {
+        /* the packet so far is in one buffer with room for this fragment */
+        ps  = (UINT8 *) (p_msg + 1) + p_msg->offset + NCI_DATA_HDR_SIZE;
+        pd  = (UINT8 *) (p_first + 1) + p_first->offset + p_first->len;
+        memcpy (pd, ps, len);
+        p_first->len      += len;
+        p_cb->rx_frag_len += len;
+        GKI_freebuf (p_msg);
+    }
+    else
+    {
+        GKI_enqueue (&p_cb->rx_frag_q, p_msg);
+        p_cb->rx_frag_len += len;
+    }
+
+    if (pbf)
+    {
+        /* not the last fragment */
+        return (NULL);
+    }
+
+    p_first = (BT_HDR *) GKI_getfirst (&p_cb->rx_frag_q);
+
+    if (  (p_cb->rx_frag_q.count > 1)
+        &&(!nfc_ncif_linearize_frags (p_cb, BT_HDR_SIZE + p_first->offset + NCI_DATA_HDR_SIZE + p_cb->rx_frag_len))  )
+    {
+        /* report what fits in the first fragment */
+        nfc_ncif_drop_frags (p_cb);
+    }
+
+    p_buf = (BT_HDR *) GKI_dequeue (&p_cb->rx_frag_q);
+    p_cb->rx_frag_len = 0;
+
+    /* do not need to update pbf and len in NCI header.
+     * They are stripped off at NFC_DATA_CEVT and len may exceed 255 */
+    p_buf->layer_specific &= NFC_RAS_TOO_BIG;
+    NFC_TRACE_DEBUG1 ("nfc_ncif_proc_data len:%d", p_buf->len);
+#ifdef DISP_NCI
+    /* this packet was reassembled. display the complete packet */
+    DISP_NCI ((UINT8 *)(p_buf + 1) + p_buf->offset, p_buf->len, TRUE);
+#endif
+
+    return (p_buf);
+}
+#endif
+
 /*******************************************************************************
 **
 ** Function         nfc_ncif_proc_data
@@ -1427,12 +1719,14 @@ void nfc_ncif_proc_data (BT_HDR *p_msg)
     UINT8   *pp, cid;
     tNFC_CONN_CB * p_cb;
     UINT8   pbf;
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == FALSE)
     BT_HDR  *p_last;
     UINT8   *ps, *pd;
     UINT16  size;
     BT_HDR  *p_max = NULL;
-    UINT16  len;
     UINT16  error_mask = 0;
+#endif
+    UINT16  len;
 
     pp   = (UINT8 *) (p_msg+1) + p_msg->offset;
     NFC_TRACE_DEBUG3 ("nfc_ncif_proc_data 0x%02x%02x%02x", pp[0], pp[1], pp[2]);
@@ -1441,6 +1735,23 @@ void nfc_ncif_proc_data (BT_HDR *p_msg)
     if (p_cb && (p_msg->len >= NCI_DATA_HDR_SIZE))
     {
         NFC_TRACE_DEBUG1 ("nfc_ncif_proc_data len:%d", len);
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == TRUE)
+        if (len > 0)
+        {
+            p_msg->layer_specific = 0;
+            if ((pbf) || (GKI_getfirst (&p_cb->rx_frag_q) != NULL))
+            {
+                p_msg = nfc_ncif_reassemble_data (p_cb, p_msg, pbf);
+            }
+
+            if (p_msg)
+            {
+                GKI_enqueue (&p_cb->rx_q, p_msg);
+                nfc_data_event (p_cb);
+            }
+            return;
+        }
+#else
         if (len > 0)
         {
             p_msg->layer_specific       = 0;
@@ -1511,6 +1822,7 @@ void nfc_ncif_proc_data (BT_HDR *p_msg)
             nfc_data_event (p_cb);
             return;
         }
+#endif
         /* else an empty data packet*/
     }
     GKI_freebuf (p_msg);
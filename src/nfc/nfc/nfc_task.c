@@ -389,7 +389,14 @@ UINT32 nfc_task (UINT32 param)
                 switch (p_msg->event & BT_EVT_MASK)
                 {
                     case BT_EVT_TO_NFC_NCI:
+#if (NFC_LATENCY_INCLUDED == TRUE)
+                        /* events caused by this message are timed from its arrival */
+                        nfc_lat_origin = GKI_get_buf_time (p_msg);
                         free_buf = nfc_ncif_process_event (p_msg);
+                        nfc_lat_origin = 0;
+#else
+                        free_buf = nfc_ncif_process_event (p_msg);
+#endif
                         break;
 
                     case BT_EVT_TO_START_TIMER :
@@ -445,6 +452,11 @@ UINT32 nfc_task (UINT32 param)
         }
 #endif
 
+#if (NFC_SET_CONFIG_COALESCE_INCLUDED == TRUE)
+        /* send the CORE_SET_CONFIG merged while processing these events */
+        nfc_ncif_flush_set_config ();
+#endif
+
     }
 
 
@@ -171,6 +171,12 @@ void nfc_free_conn_cb (tNFC_CONN_CB *p_cb)
     while ((p_buf = GKI_dequeue (&p_cb->rx_q)) != NULL)
         GKI_freebuf (p_buf);
 
+#if (NFC_NCI_RX_CHAIN_REASSEMBLY == TRUE)
+    while ((p_buf = GKI_dequeue (&p_cb->rx_frag_q)) != NULL)
+        GKI_freebuf (p_buf);
+    p_cb->rx_frag_len = 0;
+#endif
+
     while ((p_buf = GKI_dequeue (&p_cb->tx_q)) != NULL)
         GKI_freebuf (p_buf);
 
@@ -1588,6 +1588,26 @@ static void rw_t2t_handle_ndef_read_rsp (UINT8 *p_data)
     UINT16          offset;
     BOOLEAN         failed = FALSE;
     BOOLEAN         done   = FALSE;
+    BT_HDR          *p_seg = NULL;
+    UINT8           *p_dest;
+
+    /* Without NDEF buffer, the data of each read is passed up as it arrives */
+    if (p_t2t->p_ndef_buffer == NULL)
+    {
+        if ((p_seg = (BT_HDR *) GKI_getpoolbuf (NFC_RW_POOL_ID)) == NULL)
+        {
+            evt_data.status = NFC_STATUS_FAILED;
+            evt_data.p_data = NULL;
+            rw_t2t_handle_op_complete ();
+            (*rw_cb.p_cback) (RW_T2T_NDEF_READ_EVT, (tRW_DATA *) &evt_data);
+            return;
+        }
+        p_seg->offset = 0;
+        p_seg->len    = 0;
+        p_dest        = (UINT8 *) (p_seg + 1);
+    }
+    else
+        p_dest = &p_t2t->p_ndef_buffer[p_t2t->work_offset];
 
     /* On the first read, adjust for any partial block offset */
     offset = 0;
@@ -1607,12 +1627,25 @@ static void rw_t2t_handle_ndef_read_rsp (UINT8 *p_data)
         if (rw_t2t_is_lock_res_byte ((UINT16) (offset + p_t2t->block_read * T2T_BLOCK_LEN)) == FALSE)
         {
             /* Collect the NDEF Message */
-            p_t2t->p_ndef_buffer[p_t2t->work_offset] = p_data[offset];
+            *p_dest++ = p_data[offset];
             p_t2t->work_offset++;
         }
         offset++;
     }
 
+    if (p_seg)
+    {
+        p_seg->len = (UINT16) (p_dest - (UINT8 *) (p_seg + 1));
+        if (p_seg->len)
+        {
+            evt_data.status = NFC_STATUS_OK;
+            evt_data.p_data = p_seg;
+            (*rw_cb.p_cback) (RW_T2T_NDEF_READ_SEG_EVT, (tRW_DATA *) &evt_data);
+        }
+        else
+            GKI_freebuf (p_seg);
+    }
+
     if (p_t2t->work_offset >= p_t2t->ndef_msg_len)
     {
         done = TRUE;
@@ -2978,6 +3011,10 @@ tNFC_STATUS RW_T2tDetectNDef (void)
 **                  Internally, this command will be separated into multiple Tag2
 **                  Read commands (if necessary) - depending on the NDEF Msg size
 **
+**                  If p_buffer is NULL, the NDEF message is not collected:
+**                  the data of each read is sent with a
+**                  RW_T2T_NDEF_READ_SEG_EVT as it arrives.
+**
 ** Parameters:      p_buffer:   The buffer into which to read the NDEF message
 **                  buf_len:    The length of the buffer
 **
@@ -3002,7 +3039,7 @@ tNFC_STATUS RW_T2tReadNDef (UINT8 *p_buffer, UINT16 buf_len)
         return (NFC_STATUS_FAILED);
     }
 
-    if (buf_len < p_t2t->ndef_msg_len)
+    if ((p_buffer) && (buf_len < p_t2t->ndef_msg_len))
     {
         RW_TRACE_WARNING2 ("RW_T2tReadNDef - buffer size: %u  less than NDEF msg sise: %u", buf_len, p_t2t->ndef_msg_len);
         return (NFC_STATUS_FAILED);
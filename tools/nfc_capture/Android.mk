@@ -0,0 +1,13 @@
+LOCAL_PATH:= $(call my-dir)
+
+######################################
+# nfc_capture_decode: turns binary packet captures into readable traces
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := nfc_capture_decode
+LOCAL_MODULE_TAGS := optional
+LOCAL_SRC_FILES := nfc_capture_decode.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/../../src/include \
+	$(LOCAL_PATH)/../../src/gki/ulinux
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,470 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2012 Broadcom Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Decoder of binary packet captures (see nfc_capture.h).
+ *
+ *  usage: nfc_capture_decode [-x] capture...
+ *
+ *  The records of all given captures (e.g. the ".hal" and ".nfa" capture of
+ *  one session) are merged in time order and printed as NCI, LLCP, SNEP and
+ *  HCP traces. -x adds a hex dump of each packet.
+ *
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "nfc_capture.h"
+
+typedef struct
+{
+    const tNFC_CAP_REC_HDR  *p_rec;
+    const UINT8             *p_data;
+    const char              *p_src;     /* name of the capture */
+    UINT32                  seq;        /* order within the capture */
+} tREC;
+
+static int hex_dump = 0;
+
+static const char *nci_mt_str[] = {"DATA", "CMD", "RSP", "NTF", "MT4", "MT5", "MT6", "MT7"};
+
+static const char *nci_core_str[] = {"CORE_RESET", "CORE_INIT", "CORE_SET_CONFIG", "CORE_GET_CONFIG",
+                                     "CORE_CONN_CREATE", "CORE_CONN_CLOSE", "CORE_CONN_CREDITS",
+                                     "CORE_GENERIC_ERROR", "CORE_INTERFACE_ERROR"};
+static const char *nci_rf_str[]   = {"RF_DISCOVER_MAP", "RF_SET_ROUTING", "RF_GET_ROUTING", "RF_DISCOVER",
+                                     "RF_DISCOVER_SELECT", "RF_INTF_ACTIVATED", "RF_DEACTIVATE",
+                                     "RF_FIELD_INFO", "RF_T3T_POLLING", "RF_NFCEE_ACTION",
+                                     "RF_NFCEE_DISCOVERY_REQ", "RF_PARAMETER_UPDATE"};
+static const char *nci_ee_str[]   = {"NFCEE_DISCOVER", "NFCEE_MODE_SET"};
+
+static const char *llcp_ptype_str[] = {"SYMM", "PAX", "AGF", "UI", "CONNECT", "DISC", "CC", "DM",
+                                       "FRMR", "SNL", "PT10", "PT11", "I", "RR", "RNR", "PT15"};
+
+/*******************************************************************************
+**
+** Function         name_of
+**
+** Description      Look up a name in a table.
+**
+** Returns          name, or NULL
+**
+*******************************************************************************/
+static const char *name_of (const char **p_table, unsigned size, unsigned idx)
+{
+    return ((idx < size) ? p_table[idx] : NULL);
+}
+
+/*******************************************************************************
+**
+** Function         print_hex
+**
+** Description      Print a packet as hex bytes.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void print_hex (const UINT8 *p, unsigned len)
+{
+    unsigned xx;
+
+    for (xx = 0; xx < len; xx++)
+    {
+        if ((xx % 32) == 0)
+            printf ("\n        ");
+        printf ("%02x ", p[xx]);
+    }
+}
+
+/*******************************************************************************
+**
+** Function         decode_snep
+**
+** Description      Decode the header of a SNEP message carried by an LLCP
+**                  I or UI PDU, if the information field looks like one.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void decode_snep (const UINT8 *p, unsigned len)
+{
+    const char *p_str;
+    unsigned long msg_len;
+
+    /* version 1.x, code and 4 byte length */
+    if ((len < 6) || ((p[0] >> 4) != 1))
+        return;
+
+    switch (p[1])
+    {
+    case 0x00: p_str = "Continue";              break;
+    case 0x01: p_str = "Get";                   break;
+    case 0x02: p_str = "Put";                   break;
+    case 0x7F: p_str = "Reject";                break;
+    case 0x80: p_str = "Continue(rsp)";         break;
+    case 0x81: p_str = "Success";               break;
+    case 0xC0: p_str = "Not Found";             break;
+    case 0xC1: p_str = "Excess Data";           break;
+    case 0xC2: p_str = "Bad Request";           break;
+    case 0xE0: p_str = "Not Implemented";       break;
+    case 0xE1: p_str = "Unsupported Version";   break;
+    case 0xFF: p_str = "Reject(rsp)";           break;
+    default:   return;
+    }
+
+    msg_len = ((unsigned long) p[2] << 24) | (p[3] << 16) | (p[4] << 8) | p[5];
+    printf (" | SNEP %u.%u %s len=%lu", p[0] >> 4, p[0] & 0x0F, p_str, msg_len);
+}
+
+/*******************************************************************************
+**
+** Function         decode_llcp
+**
+** Description      Decode an LLCP PDU. Aggregated frames are decoded PDU by PDU.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void decode_llcp (const UINT8 *p, unsigned len)
+{
+    unsigned dsap, ptype, ssap, hdr_len = 2, pdu_len;
+
+    if (len < 2)
+    {
+        printf ("LLCP (short)");
+        return;
+    }
+
+    dsap  = p[0] >> 2;
+    ptype = ((p[0] & 0x03) << 2) | (p[1] >> 6);
+    ssap  = p[1] & 0x3F;
+
+    printf ("LLCP %s", llcp_ptype_str[ptype]);
+    if (ptype != 0)
+        printf (" DSAP=0x%02x SSAP=0x%02x", dsap, ssap);
+
+    /* I, RR, RNR carry sequence numbers */
+    if ((ptype >= 0x0C) && (ptype <= 0x0E) && (len > 2))
+    {
+        hdr_len = 3;
+        if (ptype == 0x0C)
+            printf (" N(S)=%u N(R)=%u", p[2] >> 4, p[2] & 0x0F);
+        else
+            printf (" N(R)=%u", p[2] & 0x0F);
+    }
+    printf (" len=%u", len);
+
+    if ((ptype == 0x0C) || (ptype == 0x03))
+    {
+        decode_snep (p + hdr_len, len - hdr_len);
+    }
+    else if (ptype == 0x02)
+    {
+        /* AGF: sequence of 2 byte length and PDU */
+        p   += 2;
+        len -= 2;
+        while (len >= 2)
+        {
+            pdu_len = (p[0] << 8) | p[1];
+            if (pdu_len + 2 > len)
+                break;
+            printf ("\n          + ");
+            decode_llcp (p + 2, pdu_len);
+            p   += pdu_len + 2;
+            len -= pdu_len + 2;
+        }
+    }
+}
+
+/*******************************************************************************
+**
+** Function         decode_hcp
+**
+** Description      Decode an HCP packet.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void decode_hcp (const UINT8 *p, unsigned len)
+{
+    static const char *cmd_str[] = {NULL, "ANY_SET_PARAMETER", "ANY_GET_PARAMETER", "ANY_OPEN_PIPE",
+                                    "ANY_CLOSE_PIPE"};
+    static const char *adm_str[] = {"ADM_CREATE_PIPE", "ADM_DELETE_PIPE", "ADM_NOTIFY_PIPE_CREATED",
+                                    "ADM_NOTIFY_PIPE_DELETED", "ADM_CLEAR_ALL_PIPE",
+                                    "ADM_NOTIFY_ALL_PIPE_CLEARED"};
+    static const char *rsp_str[] = {"ANY_OK", "ANY_E_NOT_CONNECTED", "ANY_E_CMD_PAR_UNKNOWN", "ANY_E_NOK",
+                                    "ADM_E_NO_PIPES_AVAILABLE", "ANY_E_REG_PAR_UNKNOWN",
+                                    "ANY_E_PIPE_NOT_OPENED", "ANY_E_CMD_NOT_SUPPORTED", "ANY_E_INHIBITED",
+                                    "ANY_E_TIMEOUT", "ANY_E_REG_ACCESS_DENIED", "ANY_E_PIPE_ACCESS_DENIED"};
+    static const char *evt_str[] = {NULL, "EVT_HCI_END_OF_OPERATION", "EVT_POST_DATA", "EVT_HOT_PLUG"};
+    static const char *type_str[] = {"CMD", "EVT", "RSP", "TYPE3"};
+    const char *p_str = NULL;
+    unsigned type, ins;
+
+    if (len < 1)
+        return;
+
+    printf ("HCP pipe=0x%02x%s", p[0] & 0x7F, (p[0] & 0x80) ? "" : " (chained)");
+    if (len < 2)
+        return;
+
+    /* message header; only meaningful in the first fragment of a message */
+    type = p[1] >> 6;
+    ins  = p[1] & 0x3F;
+    if (type == 0)
+        p_str = (ins >= 0x10) ? name_of (adm_str, 6, ins - 0x10) : name_of (cmd_str, 5, ins);
+    else if (type == 1)
+        p_str = (ins == 0x10) ? "EVT_CONNECTIVITY" : (ins == 0x12) ? "EVT_TRANSACTION" : name_of (evt_str, 4, ins);
+    else if (type == 2)
+        p_str = name_of (rsp_str, 12, ins);
+
+    if (p_str)
+        printf (" %s %s", type_str[type], p_str);
+    else
+        printf (" %s 0x%02x", type_str[type], ins);
+    printf (" len=%u", len - 2);
+}
+
+/*******************************************************************************
+**
+** Function         decode_nci
+**
+** Description      Decode an NCI packet.
+**
+** Returns          void
+**
+*******************************************************************************/
+static void decode_nci (const UINT8 *p, unsigned len, UINT8 flags)
+{
+    const char *p_str = NULL;
+    unsigned mt, pbf, gid, oid;
+
+    if (len < 3)
+    {
+        printf ("NCI (short)");
+        return;
+    }
+
+    mt  = (p[0] >> 5) & 0x07;
+    pbf = (p[0] >> 4) & 0x01;
+    gid = p[0] & 0x0F;
+    oid = p[1] & 0x3F;
+
+    if (mt == 0)
+    {
+        /* reassembled data may be longer than the 8 bit length in the header */
+        printf ("NCI DATA conn=%u%s len=%u", gid, pbf ? " (segment)" : "", len - 3);
+        if (flags & NFC_CAP_FLAG_REASSEMBLED)
+            printf (" (reassembled)");
+        return;
+    }
+
+    if (gid == 0)
+        p_str = name_of (nci_core_str, 9, oid);
+    else if (gid == 1)
+        p_str = name_of (nci_rf_str, 12, oid);
+    else if (gid == 2)
+        p_str = name_of (nci_ee_str, 2, oid);
+
+    if (p_str)
+        printf ("NCI %s %s", nci_mt_str[mt], p_str);
+    else
+        printf ("NCI %s GID=0x%x OID=0x%02x", nci_mt_str[mt], gid, oid);
+    printf ("%s len=%u", pbf ? " (segment)" : "", p[2]);
+
+    /* status of responses */
+    if ((mt == 2) && (len > 3))
+        printf (" status=0x%02x", p[3]);
+}
+
+/*******************************************************************************
+**
+** Function         load_capture
+**
+** Description      Read a capture and append its records to *pp_recs.
+**
+** Returns          0 if ok
+**
+*******************************************************************************/
+static int load_capture (const char *p_name, tREC **pp_recs, unsigned *p_count)
+{
+    const tNFC_CAP_FILE_HDR *p_hdr;
+    const tNFC_CAP_REC_HDR  *p_rec;
+    UINT8   *p_file;
+    FILE    *p_fp;
+    long    size;
+    UINT32  offset, xx;
+    tREC    *p_recs;
+
+    if ((p_fp = fopen (p_name, "rb")) == NULL)
+    {
+        perror (p_name);
+        return (-1);
+    }
+    fseek (p_fp, 0, SEEK_END);
+    size = ftell (p_fp);
+    fseek (p_fp, 0, SEEK_SET);
+
+    p_file = (UINT8 *) malloc (size > 0 ? size : 1);
+    if ((p_file == NULL) || (fread (p_file, 1, size, p_fp) != (size_t) size))
+    {
+        fprintf (stderr, "%s: read error\n", p_name);
+        fclose (p_fp);
+        return (-1);
+    }
+    fclose (p_fp);
+
+    p_hdr = (const tNFC_CAP_FILE_HDR *) p_file;
+    if (  ((size_t) size < sizeof (tNFC_CAP_FILE_HDR))
+        ||(p_hdr->magic != NFC_CAP_MAGIC)
+        ||(p_hdr->version != NFC_CAP_VERSION)
+        ||(p_hdr->file_len > (UINT32) size)
+        ||(p_hdr->tail < p_hdr->hdr_len)
+        ||(p_hdr->tail >= p_hdr->file_len)  )
+    {
+        fprintf (stderr, "%s: not a capture\n", p_name);
+        return (-1);
+    }
+
+    printf ("# %s: %u records, wrapped %u times\n", p_name, (unsigned) p_hdr->count, (unsigned) p_hdr->wraps);
+
+    p_recs = (tREC *) realloc (*pp_recs, (*p_count + p_hdr->count) * sizeof (tREC));
+    if (p_recs == NULL)
+        return (-1);
+    *pp_recs = p_recs;
+
+    offset = p_hdr->tail;
+    for (xx = 0; xx < p_hdr->count; xx++)
+    {
+        p_rec = (const tNFC_CAP_REC_HDR *) (p_file + offset);
+        if (  (p_hdr->file_len - offset < sizeof (tNFC_CAP_REC_HDR))
+            ||(p_rec->proto == NFC_CAP_PROTO_WRAP)  )
+        {
+            offset = p_hdr->hdr_len;
+            p_rec  = (const tNFC_CAP_REC_HDR *) (p_file + offset);
+        }
+
+        if (offset + NFC_CAP_REC_LEN (p_rec->len) > p_hdr->file_len)
+        {
+            fprintf (stderr, "%s: corrupted at offset %u\n", p_name, (unsigned) offset);
+            break;
+        }
+
+        p_recs[*p_count].p_rec  = p_rec;
+        p_recs[*p_count].p_data = (const UINT8 *) (p_rec + 1);
+        p_recs[*p_count].p_src  = p_name;
+        p_recs[*p_count].seq    = *p_count;
+        (*p_count)++;
+
+        offset += NFC_CAP_REC_LEN (p_rec->len);
+    }
+    return (0);
+}
+
+/*******************************************************************************
+**
+** Function         rec_compare
+**
+** Description      qsort() comparator: time order, then capture order.
+**
+** Returns          <0, 0, >0
+**
+*******************************************************************************/
+static int rec_compare (const void *p_a, const void *p_b)
+{
+    const tREC *p_ra = (const tREC *) p_a, *p_rb = (const tREC *) p_b;
+
+    if (p_ra->p_rec->time_sec != p_rb->p_rec->time_sec)
+        return ((p_ra->p_rec->time_sec < p_rb->p_rec->time_sec) ? -1 : 1);
+    if (p_ra->p_rec->time_nsec != p_rb->p_rec->time_nsec)
+        return ((p_ra->p_rec->time_nsec < p_rb->p_rec->time_nsec) ? -1 : 1);
+    return ((p_ra->seq < p_rb->seq) ? -1 : 1);
+}
+
+int main (int argc, char **argv)
+{
+    tREC        *p_recs = NULL;
+    unsigned    count = 0, xx;
+    int         arg;
+    const tNFC_CAP_REC_HDR *p_rec;
+    time_t      t;
+    struct tm   *p_tm;
+    double      delta;
+
+    for (arg = 1; (arg < argc) && (argv[arg][0] == '-'); arg++)
+    {
+        if (strcmp (argv[arg], "-x") == 0)
+            hex_dump = 1;
+    }
+
+    if (arg == argc)
+    {
+        fprintf (stderr, "usage: %s [-x] capture...\n", argv[0]);
+        return (1);
+    }
+
+    for (; arg < argc; arg++)
+    {
+        if (load_capture (argv[arg], &p_recs, &count) != 0)
+            return (1);
+    }
+
+    qsort (p_recs, count, sizeof (tREC), rec_compare);
+
+    for (xx = 0; xx < count; xx++)
+    {
+        p_rec = p_recs[xx].p_rec;
+        t     = (time_t) p_rec->time_sec;
+        p_tm  = localtime (&t);
+
+        /* time since the previous packet, to spot latency spikes */
+        delta = 0;
+        if (xx > 0)
+            delta = (double) p_rec->time_sec - p_recs[xx - 1].p_rec->time_sec
+                  + ((double) p_rec->time_nsec - p_recs[xx - 1].p_rec->time_nsec) / 1e9;
+
+        printf ("%02d:%02d:%02d.%06u (+%9.6f) %-12s %s ",
+                p_tm->tm_hour, p_tm->tm_min, p_tm->tm_sec, p_rec->time_nsec / 1000, delta,
+                p_recs[xx].p_src, (p_rec->flags & NFC_CAP_FLAG_RX) ? "RX" : "TX");
+
+        switch (p_rec->proto)
+        {
+        case NFC_CAP_PROTO_NCI:
+            decode_nci (p_recs[xx].p_data, p_rec->len, p_rec->flags);
+            break;
+        case NFC_CAP_PROTO_LLCP:
+            decode_llcp (p_recs[xx].p_data, p_rec->len);
+            break;
+        case NFC_CAP_PROTO_HCP:
+            decode_hcp (p_recs[xx].p_data, p_rec->len);
+            break;
+        default:
+            printf ("proto %u len=%u", p_rec->proto, p_rec->len);
+            break;
+        }
+
+        if (p_rec->flags & NFC_CAP_FLAG_TRUNCATED)
+            printf (" (truncated from %u)", p_rec->orig_len);
+        if (hex_dump)
+            print_hex (p_recs[xx].p_data, p_rec->len);
+        printf ("\n");
+    }
+
+    return (0);
+}